@@ -26,11 +26,15 @@ SOFTWARE.
 
 
 #include <boost/unordered_map.hpp>
+#include <atomic>
 #include <vector>
 #include <limits>
 #include <queue>
 #include <set>
 
+#include "graph_reader.hpp"
+#include "layer_stats.hpp"
+
 using namespace std;
 
 
@@ -55,7 +59,7 @@ struct MaxCutInst {
 
     int sum_neg_weights;                      // pre-processed data: sum of negative weights
 
-    // Constructor
+    // Constructor: reads an edge list, DIMACS or METIS file (see graph_reader.hpp)
     MaxCutInst(const char* filename);
 
     // Constructor
@@ -113,14 +117,15 @@ struct BDDNode {
     int longest_path;
     bool exact;
     int rank;
+    std::atomic<int> n_refs;    // solvers holding the node (see MaxCutBDD::fork)
 
     // Constructors
-    BDDNode(int &lp) : longest_path(lp) { }
+    BDDNode(int &lp) : longest_path(lp), n_refs(1) { }
 
     // Constructors
-    BDDNode(State& _state, int &lp) : state(_state), longest_path(lp), exact(true) { }
+    BDDNode(State& _state, int &lp) : state(_state), longest_path(lp), exact(true), n_refs(1) { }
     BDDNode(State& _state, int &lp, bool _exact)
-            : state(_state), longest_path(lp), exact(_exact) { }
+            : state(_state), longest_path(lp), exact(_exact), n_refs(1) { }
 };
 
 
@@ -223,6 +228,38 @@ private:
         localBranchNodes.push_back( new BranchNode(node) );
     }
 
+    // Delete nodes left by the step by step construction
+    void release_nodes();
+
+    // Drop a node, deleting it unless a fork still holds it
+    void release_node(BDDNode* node) {
+        if (node->n_refs.fetch_sub(1) == 1) {
+            delete node;
+        }
+    }
+
+    // Copy the nodes of a layer held by forks, before the layer is modified
+    void own_nodes(vector<BDDNode*> &nodes);
+
+    // Nodes of the current layer were taken from another solver and are not in the map
+    bool layer_forked = false;
+
+    // Relaxation steps (see generate_relaxation)
+    int  start_relaxation(State &initial_state, int initial_cost, bool save_nodes);
+    int  choose_vertex(int l);
+    void collect_layer(int l);
+    void process_layer(int l, int cur_vertex, bool save_nodes);
+    int  relax_layers(int first_layer, bool save_nodes);
+    void fork_frontier(MaxCutBDD &from);
+
+    // Construction counters of a layer: collecting it from the map, and creating its children
+    void record_extract(int l, long start);
+    void record_branch(int l, long start);
+
+    // Static ordering read from the ordering file
+    vector<int> static_order;
+    int idx_order;
+
 
 public:
     // Constructor
@@ -253,6 +290,9 @@ public:
         return generate_relaxation(bnode->state, bnode->longest_path, true);
     }
 
+    // Relaxations of several widths (-1: exact) built in one pass, bounds in the order of widths
+    vector<int> generate_relaxations(State &initial_state, int initial_cost, const vector<int> &widths);
+
 
     // Relax layer size to maximum width
     void relax_layer(int layer, vector<BDDNode*> &nodes, bool save_nodes);
@@ -299,8 +339,22 @@ public:
 
     int generate_next_step_restriction(int next_vertex, int l);
 
+    // Step of a relaxation and of a restriction built together (see restriction)
+    int generate_next_step_bounds(int next_vertex, int l);
+
     int get_final_bound();
 
+    int get_restriction_final_bound();
+
+    // Bind solver to another instance, keeping node maps and buffers
+    void reset(MaxCutInst* _inst);
+
+    // New solver continuing the step by step diagram of this one (layer nodes are shared)
+    MaxCutBDD* fork();
+
+    // Destructor
+    ~MaxCutBDD() { release_nodes(); delete restriction; }
+
     bool save_nodes;
     bool last_exact_layer;
     int initial_layer;
@@ -308,8 +362,10 @@ public:
     int width = 0;
     NodeMap::iterator node;
     BDDNode* bddnode = NULL;
-    BDDNode* root_node;
+    BDDNode* root_node = NULL;
     int bound = 0;
+    int restriction_bound = 0;         // value of the last step of the restriction (see generate_next_step_bounds)
+    MaxCutBDD* restriction = NULL;     // forked at the first layer exceeding the width
     int initial_cost;
     set<int> available_vertex;
     int ordering;
@@ -317,10 +373,40 @@ public:
     vector <int> tmp;
     const char* orderingFile;
 
+    // Construction counters of each layer of the last diagram (see layer_stats.hpp)
+    LayerStatsLog layer_stats;
+
 
 };
 
 
 
+// =======================================================================
+// Inline implementations
+// =======================================================================
+
+//
+// Nodes of the layer just collected (the map is the pool of the layer)
+//
+inline void MaxCutBDD::record_extract(int l, long start) {
+    LayerStats &stats = layer_stats.at(l);
+    stats.pool_size += nodes_layer.size();
+    stats.layer_size += nodes_layer.size();
+    stats.ns_extract += stats_clock_ns() - start;
+}
+
+//
+// Children of the layer just branched: each layer node has two, and those
+// with the state of another child are merged into it in the next map
+//
+inline void MaxCutBDD::record_branch(int l, long start) {
+    LayerStats &stats = layer_stats.at(l);
+    long n_children = node_map[next_map_idx].size();
+    stats.nodes_created += n_children;
+    stats.dedup_hits += 2*nodes_layer.size() - n_children;
+    stats.bytes_allocated += n_children * (sizeof(BDDNode) + inst->n_vertices*sizeof(int));
+    stats.ns_branch += stats_clock_ns() - start;
+}
+
 
 #endif
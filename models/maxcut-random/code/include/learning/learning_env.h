@@ -28,9 +28,34 @@ SOFTWARE.
 #include "i_env.h"
 #include "maxcut_bdd.hpp"
 
+#include <map>
+#include <memory>
+
 
 extern int sign;
 
+/**
+ * Preprocessed instances of the graphs seen by the environments, so that a graph
+ * played in many episodes is only converted once. Entries of graphs that are no
+ * longer referenced anywhere are dropped when a new graph is added.
+ */
+class InstanceCache
+{
+public:
+
+    std::shared_ptr<MaxCutInst> Get(std::shared_ptr<Graph> g);
+
+private:
+
+    struct Entry {
+        std::weak_ptr<Graph> graph;
+        std::shared_ptr<MaxCutInst> inst;
+    };
+    std::map<const Graph*, Entry> entries;
+};
+
+extern InstanceCache InstCache;
+
 class LearningEnv : public IEnv
 {
 public:
@@ -51,14 +76,17 @@ public:
 
     double getRewardLowerBound(int old_bound);
 
+    double getRewardGap(int old_bound, int old_lower_bound);
+
 
     int width;
     int bound;
+    int lower_bound;                        // restriction bound when both diagrams are built
     int l;
-    std::set<int> covered_set;
-    std::vector<int> avail_list;
-    MaxCutBDD* solver;
-    const MaxCutInst* inst;
+    std::vector<int> avail_list;            // vertices not chosen yet
+    std::vector<int> avail_pos;             // position of each vertex in avail_list (-1 if chosen)
+    MaxCutBDD* solver;                      // reused by all episodes of this environment
+    std::shared_ptr<MaxCutInst> inst;
 };
 
 #endif
\ No newline at end of file
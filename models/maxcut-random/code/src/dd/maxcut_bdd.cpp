@@ -106,27 +106,33 @@ MaxCutInst::MaxCutInst(std::vector< std::vector< std::pair<int, double> > > adj,
 // MaxCut Instance Constructor
 //
 MaxCutInst::MaxCutInst(const char* filename) {
-    // open file
+    // read edges from the mapped file (edge list "n m" / "u v w", DIMACS or METIS)
     //name = filename;
-    ifstream input(filename);
-    if (!input.is_open()) {
-        cout << "\nCould not open " << filename << endl;
-        exit(1);
-    }
+    GraphFileEdges graph_file;
+    read_graph_file(filename, graph_file);
 
     // allocate matrices
-    input >> n_vertices;
-    input >> n_edges;
+    n_vertices = graph_file.n_vertices;
+    n_edges = graph_file.edges.size();
     adj_matrix.resize( n_vertices, vector<int>(n_vertices, 0) );
     adj_list.resize( n_vertices );
 
-    // read edges
+    // neighbor lists are sized before filling them
+    vector<int> degree(n_vertices, 0);
+    for (int i = 0; i < n_edges; ++i) {
+        degree[graph_file.edges[i].first]++;
+        degree[graph_file.edges[i].second]++;
+    }
+    for (int u = 0; u < n_vertices; ++u) {
+        adj_list[u].reserve(degree[u]);
+    }
+
     sum_neg_weights = 0;
-    int u, v, w;
+    bool weighted = !graph_file.weights.empty();
     for (int i = 0; i < n_edges; ++i) {
-        input >> u; u--;
-        input >> v; v--;
-        input >> w;
+        int u = graph_file.edges[i].first;
+        int v = graph_file.edges[i].second;
+        int w = weighted ? graph_file.weights[i] : 1;
 
         adj_matrix[u][v] = w;
         adj_matrix[v][u] = w;
@@ -138,7 +144,6 @@ MaxCutInst::MaxCutInst(const char* filename) {
             sum_neg_weights += w;
         }
     }
-    input.close();
 
     cout << endl;
     cout << "MaxCut instance" << endl;
@@ -224,8 +229,10 @@ struct BDDNodeRankSort {
 void MaxCutBDD::initialize(State &initial_state, int i_cost, bool s_nodes) {
 
     // initialize structures
-    node_map[0].clear();
-    node_map[1].clear();
+    release_nodes();
+    delete restriction;
+    restriction = NULL;
+    layer_stats.clear();
     available_vertex.clear();
     tmp.resize( inst->n_vertices);
 
@@ -252,6 +259,119 @@ void MaxCutBDD::initialize(State &initial_state, int i_cost, bool s_nodes) {
 
 }
 
+//
+// Delete nodes left by the step by step construction: the root if no step
+// was taken, or else the nodes of the last layer
+//
+void MaxCutBDD::release_nodes() {
+    if (root_node != NULL) {
+        NodeMap& map = node_map[current_map_idx];
+        if (layer_forked) {
+            for (int i = 0; i < (int)nodes_layer.size(); ++i) {
+                release_node(nodes_layer[i]);
+            }
+        } else {
+            if (map.empty()) {
+                release_node(root_node);
+            }
+            for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
+                release_node(it->second);
+            }
+        }
+        root_node = NULL;
+    }
+    layer_forked = false;
+    node_map[0].clear();
+    node_map[1].clear();
+}
+
+
+//
+// Solver continuing the step by step diagram of this one. The nodes of the current
+// layer are shared instead of copied (they are reference counted): a solver copies a
+// shared node only before its layer is relaxed or restricted, since other steps only
+// read the nodes of a layer. Forking takes O(layer size), independently of the size
+// of the states. Branch nodes are left to this solver.
+//
+MaxCutBDD* MaxCutBDD::fork() {
+
+    MaxCutBDD* child = new MaxCutBDD(0, max_width, inst, ordering, orderingFile);
+    child->available_vertex = available_vertex;
+    child->tmp.resize( inst->n_vertices);
+    child->current_map_idx = current_map_idx;
+    child->next_map_idx = next_map_idx;
+    child->last_exact_layer = last_exact_layer;
+    child->save_nodes = false;
+    child->initial_cost = initial_cost;
+    child->initial_layer = initial_layer;
+    child->width = width;
+    child->bestLB = bestLB;
+
+    if (root_node == NULL) {
+        return child;
+    }
+
+    // the root is modified by the first step
+    if (initial_layer == 0) {
+        child->root_node = new BDDNode(root_node->state, root_node->longest_path, root_node->exact);
+        return child;
+    }
+
+    // from now on, root_node only tells that a diagram was started
+    child->root_node = root_node;
+    child->layer_forked = true;
+    if (layer_forked) {
+        child->nodes_layer = nodes_layer;
+    } else {
+        NodeMap& map = node_map[current_map_idx];
+        for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
+            child->nodes_layer.push_back( it->second );
+        }
+    }
+    for (int i = 0; i < (int)child->nodes_layer.size(); ++i) {
+        child->nodes_layer[i]->n_refs++;
+    }
+    return child;
+}
+
+
+//
+// Replace the nodes of a layer shared with other solvers by own copies
+//
+void MaxCutBDD::own_nodes(vector<BDDNode*> &nodes) {
+    for (int i = 0; i < (int)nodes.size(); ++i) {
+        BDDNode* node = nodes[i];
+        if (node->n_refs > 1) {
+            nodes[i] = new BDDNode(node->state, node->longest_path, node->exact);
+            release_node(node);
+        }
+    }
+}
+
+
+//
+// Bind solver to another instance
+//
+void MaxCutBDD::reset(MaxCutInst* _inst) {
+    release_nodes();
+    delete restriction;
+    restriction = NULL;
+    layer_stats.clear();
+    for (int i = 0; i < (int)localBranchNodes.size(); ++i) {
+        delete localBranchNodes[i];
+    }
+    localBranchNodes.clear();
+
+    inst = _inst;
+    bestLB = -INF;
+    isLBUpdated = false;
+    isExact = false;
+    width = 0;
+    bound = 0;
+    longest_path = 0;
+}
+
+
 int MaxCutBDD::generate_next_step_relaxation(int cur_vertex, int l) {
 
     available_vertex.erase(cur_vertex);
@@ -288,11 +408,16 @@ int MaxCutBDD::generate_next_step_relaxation(int cur_vertex, int l) {
     NodeMap& next_map = node_map[next_map_idx];
     next_map.clear();
 
-    // collects nodes in the layer according to map
-    nodes_layer.clear();
-    for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
-        nodes_layer.push_back( it->second );
+    // collects nodes in the layer according to map (unless a fork left them in the layer)
+    DD_STAT( long extract_start = stats_clock_ns() );
+    if (!layer_forked) {
+        nodes_layer.clear();
+        for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
+            nodes_layer.push_back( it->second );
+        }
     }
+    layer_forked = false;
+    DD_STAT( record_extract(l, extract_start) );
 
     //cout << "Layer " << l << " - size = " << map.size() << endl;
 
@@ -309,6 +434,7 @@ int MaxCutBDD::generate_next_step_relaxation(int cur_vertex, int l) {
     }
 
     // process nodes in current map
+    DD_STAT( long branch_start = stats_clock_ns() );
 
     int longest = 0;
     int state_vec_idx = 0;
@@ -415,10 +541,12 @@ int MaxCutBDD::generate_next_step_relaxation(int cur_vertex, int l) {
         }
         state_vec_idx++;
         // delete current BDD node
-        delete bddnode;
+        release_node(bddnode);
         longest = std::max(path_0,path_1);
     }
 
+    DD_STAT( record_branch(l, branch_start) );
+
     // switch maps
     current_map_idx = !current_map_idx;
     next_map_idx = !next_map_idx;
@@ -463,11 +591,16 @@ int MaxCutBDD::generate_next_step_restriction(int cur_vertex, int l) {
     NodeMap& next_map = node_map[next_map_idx];
     next_map.clear();
 
-    // collects nodes in the layer according to map
-    nodes_layer.clear();
-    for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
-        nodes_layer.push_back( it->second );
+    // collects nodes in the layer according to map (unless a fork left them in the layer)
+    DD_STAT( long extract_start = stats_clock_ns() );
+    if (!layer_forked) {
+        nodes_layer.clear();
+        for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
+            nodes_layer.push_back( it->second );
+        }
     }
+    layer_forked = false;
+    DD_STAT( record_extract(l, extract_start) );
 
     //cout << "Layer " << l << " - size = " << map.size() << endl;
 
@@ -477,6 +610,7 @@ int MaxCutBDD::generate_next_step_restriction(int cur_vertex, int l) {
     }
 
     // process nodes in current map
+    DD_STAT( long branch_start = stats_clock_ns() );
 
     int longest = 0;
     int state_vec_idx = 0;
@@ -582,10 +716,12 @@ int MaxCutBDD::generate_next_step_restriction(int cur_vertex, int l) {
         }
         state_vec_idx++;
         // delete current BDD node
-        delete bddnode;
+        release_node(bddnode);
         longest = std::max(path_0,path_1);
     }
 
+    DD_STAT( record_branch(l, branch_start) );
+
     // switch maps
     current_map_idx = !current_map_idx;
     next_map_idx = !next_map_idx;
@@ -594,9 +730,36 @@ int MaxCutBDD::generate_next_step_restriction(int cur_vertex, int l) {
 
 }
 
+//
+// Step of a relaxation and of a restriction built together. Both are the same
+// diagram while it is exact: the restriction is forked from this solver at the
+// first layer exceeding the width, and is built side by side from then on.
+// Returns the value of the relaxation step; restriction_bound gets the value of
+// the restriction step.
+//
+int MaxCutBDD::generate_next_step_bounds(int cur_vertex, int l) {
+
+    if (restriction == NULL && max_width != -1 && initial_layer != 0) {
+        int layer_size = layer_forked ? nodes_layer.size() : node_map[current_map_idx].size();
+        if (layer_size > max_width) {
+            restriction = fork();
+        }
+    }
+
+    int longest = generate_next_step_relaxation(cur_vertex, l);
+    restriction_bound = (restriction != NULL) ? restriction->generate_next_step_restriction(cur_vertex, l) : longest;
+    return longest;
+}
+
+
+int MaxCutBDD::get_restriction_final_bound() {
+    return (restriction != NULL) ? restriction->get_final_bound() : get_final_bound();
+}
+
+
 int MaxCutBDD::get_final_bound() {
 
-    BDDNode* terminal = node_map[current_map_idx].begin()->second;
+    BDDNode* terminal = layer_forked ? nodes_layer[0] : node_map[current_map_idx].begin()->second;
     int ret = terminal->longest_path;
     //delete terminal;
     return ret;
@@ -607,69 +770,82 @@ int MaxCutBDD::generate_relaxation(State &initial_state,
                                    int initial_cost,
                                    bool save_nodes) {
 
+    int first_layer = start_relaxation(initial_state, initial_cost, save_nodes);
+    return relax_layers(first_layer, save_nodes);
+}
 
 
+//
+// Choose the vertex of a layer according to the ordering and remove it from the available vertices
+//
+int MaxCutBDD::choose_vertex(int l) {
 
-    int static_order[inst->n_vertices];
-    int idx_order = 0;
+    int cur_vertex;
+    if(ordering == 1) {
+        set<int>::iterator it = available_vertex.begin();
+
+        for (int r = rand() % available_vertex.size(); r != 0; r--) {
+            it++;
+        }
+        cur_vertex = *it;
+    }
+
+    else if(ordering == 3) {
+        cur_vertex = static_order[idx_order];
+        idx_order++;
+    }
+
+    else {
+        cur_vertex = l;
+    }
+
+    available_vertex.erase(cur_vertex);
+    return cur_vertex;
+}
+
+
+//
+// Create the root node of a relaxation, returning the first layer to branch on
+//
+int MaxCutBDD::start_relaxation(State &initial_state, int initial_cost, bool save_nodes) {
 
     // initialize structures
-    node_map[0].clear();
-    node_map[1].clear();
+    release_nodes();
+    layer_stats.clear();
     available_vertex.clear();
     tmp.resize( inst->n_vertices);
 
-    int cur_vertex = -1;
     for (int i = 0; i < inst->n_vertices; ++i) {
         available_vertex.insert(i);
     }
 
+    idx_order = 0;
     if(ordering == 1) {
         srand(time(NULL));
-        set<int>::iterator it = available_vertex.begin();
-
-        for (int r = rand() % available_vertex.size(); r != 0; r--) {
-            it++;
-        }
-        cur_vertex = *it;
-        available_vertex.erase(cur_vertex);
-
     }
 
     else if(ordering == 3) {
-        //int randVertex = rand() % available_vertex.size();
-        //available_vertex.erase(randVertex);
-
-
         ifstream input(orderingFile);
         if (!input.is_open()) {
             cout << "\nCould not open ordering file " << orderingFile << endl;
             exit(1);
         }
 
-
+        static_order.resize(inst->n_vertices);
         for (int i = 0; i < inst->n_vertices; ++i) {
             input >> static_order[i];
         }
         input.close();
-
-        available_vertex.erase(static_order[idx_order]);
-        cur_vertex = static_order[idx_order];
-        idx_order++;
-
-
     }
 
-    else {
-        available_vertex.erase(0);
-        cur_vertex = 0;
-    }
+    // first vertex (vertex 0 for the lexicographic ordering)
+    int cur_vertex = choose_vertex(0);
 
     current_map_idx = 0;
     next_map_idx = 1;
 
     aux_state.resize(initial_state.size());
-    bool last_exact_layer = true;
+    last_exact_layer = true;
 
     if (save_nodes) {
         localBranchNodes.clear();
@@ -683,17 +859,10 @@ int MaxCutBDD::generate_relaxation(State &initial_state,
 
     if (initial_layer == 0) {
         // First BDD: set first vertex to S
-        //root_node->state.resize( root_node->state.size()-1 );
-
         for (auto v : available_vertex) {
             root_node->state[v] = inst->adj_matrix[cur_vertex][v];
         }
 
-        /*
-        for (int i = 1; i < inst->n_vertices; ++i) {
-          root_node->state[i] = inst->adj_matrix[0][i];
-        }*/
-
         root_node->longest_path = inst->sum_neg_weights + initial_cost;
         initial_layer = 1;
     } else {
@@ -701,250 +870,267 @@ int MaxCutBDD::generate_relaxation(State &initial_state,
     }
     node_map[current_map_idx][&root_node->state] = root_node;
 
-    // auxiliaries
-    int longest_path = 0;
-    NodeMap::iterator node;
-    BDDNode* bddnode = NULL;
+    return initial_layer;
+}
 
-    // process each layer
-    for (int l = initial_layer; l < inst->n_vertices; ++l) {
 
-        // remove a vertex
-        //aux_state.resize( inst->n_vertices);
-        //std::fill(aux_state.begin(), aux_state.end(), 0);
+//
+// Move the nodes of the current map to the layer vector
+//
+void MaxCutBDD::collect_layer(int l) {
 
+    DD_STAT( long start = stats_clock_ns() );
 
+    NodeMap& map = node_map[current_map_idx];
+    node_map[next_map_idx].clear();
 
+    nodes_layer.clear();
+    for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
+        nodes_layer.push_back( it->second );
+    }
 
-        /*cout <<  "Available Vertices = { ";
-        for (set<int>::const_iterator i = available_vertex.begin(); i != available_vertex.end(); ++i)
-        {
-          cout << *i << " ";
-        }
-        cout << "}" << endl;*/
+    DD_STAT( record_extract(l, start) );
+}
 
-        // remove a vertex
 
-        if(ordering == 1) {
-            set<int>::iterator it = available_vertex.begin();
+//
+// Relax the layer to the maximum width and create its children in the next map
+//
+void MaxCutBDD::process_layer(int l, int cur_vertex, bool save_nodes) {
 
-            for (int r = rand() % available_vertex.size(); r != 0; r--) {
-                it++;
-            }
-            cur_vertex = *it;
-            available_vertex.erase(cur_vertex);
+    NodeMap& next_map = node_map[next_map_idx];
 
+    // if exceeds width, generate relaxation
+    if (max_width != -1 && (int)nodes_layer.size() > max_width) {
+        if (last_exact_layer && save_nodes) {
+            for (int i = 0; i < (int)nodes_layer.size(); ++i) {
+                add_branch_node(nodes_layer[i]);
+            }
+            last_exact_layer = false;
         }
+        relax_layer(l, nodes_layer, false);
+        assert(nodes_layer.size() == max_width);
+    }
 
-        else if(ordering == 3) {
-            //int randVertex = rand() % available_vertex.size();
-            //available_vertex.erase(randVertex);
-            available_vertex.erase(static_order[idx_order]);
-            cur_vertex = static_order[idx_order];
-            idx_order++;
-        }
+    DD_STAT( long start = stats_clock_ns() );
 
+    // children states are keys of the next map: no reallocation allowed
+    state_vec.clear();
+    state_vec.reserve(2*nodes_layer.size());
 
-        else {
-            available_vertex.erase(l);
-            cur_vertex = l;
-        }
+    int longest_path;
+    NodeMap::iterator node;
+    BDDNode* bddnode;
 
+    // process nodes in current map
+    int state_vec_idx = 0;
+    for (vector<BDDNode*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it) {
 
-        // get node maps
-        NodeMap& map = node_map[current_map_idx];
-        NodeMap& next_map = node_map[next_map_idx];
-        next_map.clear();
-        // collects nodes in the layer according to map
-        nodes_layer.clear();
+        // get BDD node
+        bddnode = *it;
+        State& state = bddnode->state;
 
-        for (NodeMap::iterator it = map.begin(); it != map.end(); ++it) {
-            nodes_layer.push_back( it->second );
-        }
+        // --------------------------
+        // Zero arc
+        // --------------------------
 
-        if(max_width == -1) {
-            state_vec.resize(map.size());
-        }
-        else {
-            state_vec.resize(max_width);
+        // compute transition cost
+        longest_path = bddnode->longest_path + std::max(-state[cur_vertex], 0);
+        for (auto v : available_vertex) {
+            if (state[v] * inst->adj_matrix[cur_vertex][v] <= 0) {
+                longest_path += std::min( std::abs(state[v]), std::abs(inst->adj_matrix[cur_vertex][v]));
+            }
         }
-        state_vec.clear();
-
 
+        tmp.clear();
+        tmp.resize( inst->n_vertices);
+        for (auto v : available_vertex) {
+            tmp[v] = state[v] + inst->adj_matrix[cur_vertex][v];
+        }
 
-        //cout << "Layer " << l << " - size = " << map.size() << endl;
+        state_vec.push_back(tmp);
 
-        // if exceeds width, generate restriction
-        if (max_width != -1 && (int)nodes_layer.size() > max_width) {
-            if (last_exact_layer && save_nodes) {
-                for (int i = 0; i < (int)nodes_layer.size(); ++i) {
+        node = next_map.find(&state_vec.at(state_vec_idx));
 
-                    add_branch_node(nodes_layer[i]);
-                }
-                last_exact_layer = false;
-            }
-            relax_layer(l, nodes_layer, false);
-            assert(nodes_layer.size() == max_width);
+        if (node == next_map.end()) {
+            next_map[&state_vec.at(state_vec_idx)] = new BDDNode(state_vec.at(state_vec_idx), longest_path, bddnode->exact);
         }
-        // process nodes in current map
-
-        int state_vec_idx = 0;
-        for (vector<BDDNode*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it) {
 
-            // get BDD node
-            bddnode = *it;
-            State& state = bddnode->state;
-
-            /*cout << l << "\tState = ({ ";
-            for (int i = 0; i < (int)state.size(); ++i) {
-              cout << state[i] << " ";
+        else {
+            if (!bddnode->exact && node->second->exact && save_nodes) {
+                add_branch_node(node->second);
+                node->second->exact = false;
             }
-            cout << "}, " << bddnode->longest_path << ")" << endl;*/
+            node->second->longest_path = std::max(node->second->longest_path, longest_path);
+        }
 
-            // --------------------------
-            // Zero arc
-            // --------------------------
+        state_vec_idx++;
 
-            // compute transition cost
-            longest_path = bddnode->longest_path + std::max(-state[cur_vertex], 0);
-            //cout << "\t\t inc: " << -state[l] << endl;
-            for (auto v : available_vertex) {
-                // cout << "\t\t state vertex: " << state[v] << endl;
-                //cout << "\t\t weight: " << inst->adj_matrix[l][v] << endl;
-                if (state[v] * inst->adj_matrix[cur_vertex][v] <= 0) {
-                    //  cout << "\t\t ENTERED" << endl;
-                    //  cout << "\t\t inc: " << std::min( std::abs(state[v]), std::abs(inst->adj_matrix[l][v])) << endl;
-                    longest_path += std::min( std::abs(state[v]), std::abs(inst->adj_matrix[cur_vertex][v]));
-                }
-            }
-            //cout << "Intermediate longest path: " << longest_path << endl;
+        // --------------------------
+        // One arc
+        // --------------------------
 
-            tmp.clear();
-            tmp.resize( inst->n_vertices);
-            for (auto v : available_vertex) {
-                //aux_state[i-1] = state[i] + inst->adj_matrix[l][l+i];
-                //aux_state[v] = state[v] + inst->adj_matrix[cur_vertex][v];
-                tmp[v] = state[v] + inst->adj_matrix[cur_vertex][v];
-                //state_vec[state_vec_idx][v] = state[v] + inst->adj_matrix[cur_vertex][v];
+        // compute transition cost
+        longest_path = bddnode->longest_path + std::max(state[cur_vertex], 0);
+        for (auto v : available_vertex) {
+            if (state[v] * inst->adj_matrix[cur_vertex][v] >= 0) {
+                longest_path += std::min( std::abs(state[v]), std::abs(inst->adj_matrix[cur_vertex][v]) );
             }
+        }
 
+        // set state
+        tmp.clear();
+        tmp.resize( inst->n_vertices);
+        for (auto v : available_vertex) {
+            tmp[v] = state[v] - inst->adj_matrix[cur_vertex][v];
+        }
 
-            state_vec.push_back(tmp);
-
+        state_vec.push_back(tmp);
 
-            node = next_map.find(&state_vec.at(state_vec_idx));
+        node = next_map.find(&state_vec.at(state_vec_idx));
 
-            //cout << "after find" << endl;
-            if (node == next_map.end()) {
-                //cout << "\tNew state created" << endl;
-                next_map[&state_vec.at(state_vec_idx)] = new BDDNode(state_vec.at(state_vec_idx), longest_path, bddnode->exact);
+        if (node == next_map.end()) { // If node does noy exist yet in layer.
+            next_map[&state_vec.at(state_vec_idx)] = new BDDNode(state_vec.at(state_vec_idx), longest_path, bddnode->exact);
+        } else {
+            if (!bddnode->exact && node->second->exact && save_nodes) {
+                add_branch_node(node->second);
+                node->second->exact = false;
             }
+            node->second->longest_path = std::max(node->second->longest_path, longest_path);
+        }
+        state_vec_idx++;
 
-            else {
-                if (!bddnode->exact && node->second->exact && save_nodes) {
+        // delete current BDD node
+        delete bddnode;
+    }
 
-                    add_branch_node(node->second);
-                    node->second->exact = false;
-                }
-                node->second->longest_path = std::max(node->second->longest_path, longest_path);
-            }
+    DD_STAT( record_branch(l, start) );
 
+    // switch maps
+    current_map_idx = !current_map_idx;
+    next_map_idx = !next_map_idx;
+}
 
-            state_vec_idx++;
-            // --------------------------
-            // One arc
-            // --------------------------
 
-            // compute transition cost
-            longest_path = bddnode->longest_path + std::max(state[cur_vertex], 0);
-            /*for (int i = 1; i < (int)state.size(); ++i) {
-              if (state[i] * inst->adj_matrix[l][l+i] >= 0) {
-                longest_path += std::min( std::abs(state[i]),
-                                          std::abs(inst->adj_matrix[l][l+i]) );
-              }
-            }*/
+//
+// Build the layers of a relaxation from a given layer on, returning its bound
+//
+int MaxCutBDD::relax_layers(int first_layer, bool save_nodes) {
 
+    // process each layer
+    for (int l = first_layer; l < inst->n_vertices; ++l) {
+        int cur_vertex = choose_vertex(l);
+        collect_layer(l);
+        process_layer(l, cur_vertex, save_nodes);
+    }
 
-            for (auto v : available_vertex) {
-                if (state[v] * inst->adj_matrix[cur_vertex][v] >= 0) {
-                    longest_path += std::min( std::abs(state[v]), std::abs(inst->adj_matrix[cur_vertex][v]) );
-                }
-            }
-            // cout << "\tintermediate lp one arc: " << longest_path << endl;
-            // set state
-            /*for (int i = 1; i < (int)state.size(); ++i) {
-              aux_state[i] = state[i] - inst->adj_matrix[l][l+i];
-            }*/
+    // get longest path from terminal BDD node
+    BDDNode* terminal = node_map[current_map_idx].begin()->second;
 
-            tmp.clear();
-            tmp.resize( inst->n_vertices);
-            for (auto v : available_vertex) {
-                //aux_state[v] = state[v] - inst->adj_matrix[cur_vertex][v];
-                tmp[v] = state[v] - inst->adj_matrix[cur_vertex][v];
-            }
+    int longest_path = terminal->longest_path;
+    isExact = terminal->exact;
 
-            state_vec.push_back(tmp);
-            /*cout << l << "\tTmp State = ({ ";
-            for (int i = 0; i < (int)state.size(); ++i) {
-              cout << aux_state[i] << " ";
-            }
-            cout << "}, " << bddnode->longest_path << ")" << endl;*/
-            // add to set
+    delete terminal;
 
+    // set relaxation ub of branching nodes
+    if (save_nodes) {
+        for (int i = 0; i < (int)localBranchNodes.size(); ++i) {
+            localBranchNodes[i]->relax_ub = longest_path;
+        }
+    }
 
-            //cout << "before find" << endl;
-            //node = next_map.find(&tmp);
-            node = next_map.find(&state_vec.at(state_vec_idx));
-            //cout << "after find" << endl;
+    return longest_path;
+}
 
-            if (node == next_map.end()) { // If node does noy exist yet in layer.
-                //cout << "\tNew state created" << endl;
-                next_map[&state_vec.at(state_vec_idx)] = new BDDNode(state_vec.at(state_vec_idx), longest_path, bddnode->exact);
-            } else {
-                if (!bddnode->exact && node->second->exact && save_nodes) {
-                    add_branch_node(node->second);
-                    node->second->exact = false;
-                }
-                node->second->longest_path = std::max(node->second->longest_path, longest_path);
-            }
-            state_vec_idx++;
-            /*cout << "cur Store{" ;
 
-            for(auto a : next_map) {
-              cout << "[";
-              for(auto s : *a.first) {
-                cout << s << " ";
-              }
-              cout << "]";
-            }
-            cout << "}" << endl;*/
+//
+// Relaxations of several widths sharing the exact layers they have in common. The
+// diagram is built exactly, and when a layer first exceeds a width, its nodes are
+// copied to a solver of that width which completes the relaxation.
+//
+vector<int> MaxCutBDD::generate_relaxations(State &initial_state, int initial_cost, const vector<int> &widths) {
 
-            // delete current BDD node
-            delete bddnode;
+    // widths in increasing order, exact (-1) last
+    vector<int> order(widths.size());
+    for (int i = 0; i < (int)widths.size(); ++i) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&widths](int a, int b) {
+        return (widths[a] == -1 ? INF : widths[a]) < (widths[b] == -1 ? INF : widths[b]);
+    });
+
+    vector<int> bounds(widths.size());
+    int saved_width = max_width;
+    max_width = -1;
+
+    int next = 0;
+    int first_layer = start_relaxation(initial_state, initial_cost, false);
+    for (int l = first_layer; l < inst->n_vertices && next < (int)order.size(); ++l) {
+        int cur_vertex = choose_vertex(l);
+        collect_layer(l);
+
+        // relaxations of the widths this layer exceeds diverge here
+        while (next < (int)order.size() && widths[order[next]] != -1
+                && (int)nodes_layer.size() > widths[order[next]]) {
+            MaxCutBDD fork(0, widths[order[next]], inst, ordering, orderingFile);
+            fork.fork_frontier(*this);
+            fork.process_layer(l, cur_vertex, false);
+            bounds[order[next]] = fork.relax_layers(l+1, false);
+            next++;
         }
 
-        // switch maps
-        current_map_idx = !current_map_idx;
-        next_map_idx = !next_map_idx;
+        if (next == (int)order.size()) {
+            // no width left: drop the exact layer
+            for (int i = 0; i < (int)nodes_layer.size(); ++i) {
+                delete nodes_layer[i];
+            }
+            nodes_layer.clear();
+            node_map[0].clear();
+            node_map[1].clear();
+        } else {
+            process_layer(l, cur_vertex, false);
+        }
+    }
 
+    // widths never exceeded (and the exact diagram) have the exact bound
+    if (next < (int)order.size()) {
+        BDDNode* terminal = node_map[current_map_idx].begin()->second;
+        for (; next < (int)order.size(); ++next) {
+            bounds[order[next]] = terminal->longest_path;
+        }
+        isExact = true;
+        delete terminal;
     }
 
-    // get longest path from terminal BDD node
-    BDDNode* terminal = node_map[current_map_idx].begin()->second;
+    max_width = saved_width;
+    return bounds;
+}
 
-    longest_path = terminal->longest_path;
-    isExact = terminal->exact;
 
-    delete terminal;
+//
+// Take a copy of the layer nodes of another solver and of its vertex selection
+//
+void MaxCutBDD::fork_frontier(MaxCutBDD &from) {
 
-    // set relaxation ub of branching nodes
-    if (save_nodes) {
-        for (int i = 0; i < (int)localBranchNodes.size(); ++i) {
-            localBranchNodes[i]->relax_ub = longest_path;
-        }
+    available_vertex = from.available_vertex;
+    static_order = from.static_order;
+    idx_order = from.idx_order;
+    tmp.resize( inst->n_vertices);
+    last_exact_layer = true;
+
+    // same number of buckets, so that maps are traversed in the same order as in a single relaxation
+    current_map_idx = from.current_map_idx;
+    next_map_idx = from.next_map_idx;
+    for (int k = 0; k < 2; ++k) {
+        node_map[k].clear();
+        node_map[k].rehash(from.node_map[k].bucket_count());
     }
 
-    return longest_path;
+    nodes_layer.clear();
+    for (int i = 0; i < (int)from.nodes_layer.size(); ++i) {
+        BDDNode* node = from.nodes_layer[i];
+        nodes_layer.push_back( new BDDNode(node->state, node->longest_path, node->exact) );
+    }
 }
 
 
@@ -953,6 +1139,9 @@ int MaxCutBDD::generate_relaxation(State &initial_state,
 //
 void MaxCutBDD::relax_layer(int layer, vector<BDDNode*> &nodes, bool save_nodes) {
     assert(nodes.size() > max_width);
+    DD_STAT( long start = stats_clock_ns() );
+    DD_STAT( layer_stats.at(layer).nodes_merged += nodes.size() - max_width );
+    own_nodes(nodes);
 
     // compute node ranking
     for (int i = 0; i < (int)nodes.size(); ++i) {
@@ -1009,11 +1198,13 @@ void MaxCutBDD::relax_layer(int layer, vector<BDDNode*> &nodes, bool save_nodes)
         nodes[i]->exact = false;
         nodes[i+1]->exact = false;
 
-        delete nodes[i+1];
+        release_node(nodes[i+1]);
     }
 
     // truncate layer
     nodes.resize(max_width);
+
+    DD_STAT( layer_stats.at(layer).ns_merge += stats_clock_ns() - start );
 }
 
 //
@@ -1351,6 +1542,9 @@ int MaxCutBDD::generate_restriction(State& initial_state, int initial_cost,
 void MaxCutBDD::restrict_layer(int layer, vector<BDDNode*> &nodes, bool save_nodes) {
     assert(nodes.size() > max_width);
     assert(max_width > 0);
+    DD_STAT( long start = stats_clock_ns() );
+    DD_STAT( layer_stats.at(layer).nodes_merged += nodes.size() - max_width );
+    own_nodes(nodes);
 
     // compute node ranking
     for (int i = 0; i < (int)nodes.size(); ++i) {
@@ -1362,17 +1556,16 @@ void MaxCutBDD::restrict_layer(int layer, vector<BDDNode*> &nodes, bool save_nod
     // sort nodes by ranking
     sort(nodes.begin(), nodes.end(), BDDNodeRankSort());
 
-    // truncate layer to satisfy width
-    if (!save_nodes) {
-        for (int i = max_width; i < (int)nodes.size(); ++i) {
-            delete nodes[i];
-        }
-    } else {
-        for (int i = max_width; i < (int)nodes.size(); ++i) {
+    // truncate layer to satisfy width (branch nodes keep a copy of the state)
+    for (int i = max_width; i < (int)nodes.size(); ++i) {
+        if (save_nodes) {
             add_branch_node(nodes[i]);
         }
+        release_node(nodes[i]);
     }
     nodes.resize(max_width);
+
+    DD_STAT( layer_stats.at(layer).ns_merge += stats_clock_ns() - start );
 }
 
 
@@ -36,27 +36,59 @@ char bdd_type = 'U';
 double r_scaling = 1;
 double w_scaling = 0.01;
 
-LearningEnv::LearningEnv() : IEnv() {
+InstanceCache InstCache;
+
+std::shared_ptr<MaxCutInst> InstanceCache::Get(std::shared_ptr<Graph> g)
+{
+    auto it = entries.find(g.get());
+    if (it != entries.end() && it->second.graph.lock() == g)
+        return it->second.inst;
+
+    // a graph at the same address was released: its entry is stale like all expired ones
+    for (auto e = entries.begin(); e != entries.end(); ) {
+        if (e->second.graph.expired())
+            e = entries.erase(e);
+        else
+            ++e;
+    }
+
+    Entry& entry = entries[g.get()];
+    entry.graph = g;
+    entry.inst = std::make_shared<MaxCutInst>(g->adj_list, w_scaling);
+    return entry.inst;
+}
+
+LearningEnv::LearningEnv() : IEnv(), solver(nullptr) {
 
 }
 
 void LearningEnv::s0(std::shared_ptr<Graph> _g, bool isTrain) {
     graph = _g;
-    covered_set.clear();
     action_list.clear();
     state_seq.clear();
     act_seq.clear();
     reward_seq.clear();
     sum_rewards.clear();
 
+    avail_list.resize(graph->num_nodes);
+    avail_pos.resize(graph->num_nodes);
+    for (int i = 0; i < graph->num_nodes; ++i) {
+        avail_list[i] = i;
+        avail_pos[i] = i;
+    }
+
+    inst = InstCache.Get(graph);
+    if (solver == nullptr)
+        solver = new MaxCutBDD(0, bdd_max_width, inst.get(), 0, NULL);
+    else
+        solver->reset(inst.get());
 
-    solver = new MaxCutBDD(0, bdd_max_width, graph->adj_list,0,w_scaling);
-    inst = solver->get_instance();
     State initial_state(inst->n_vertices, 0);
     solver->initialize(initial_state, 0, true);
 
     l = 0;
     bound = 0;
+    lower_bound = 0;
     width = 0;
 
 }
@@ -64,15 +96,21 @@ void LearningEnv::s0(std::shared_ptr<Graph> _g, bool isTrain) {
 double LearningEnv::step(int a) {
 
     assert(graph);
-    assert(covered_set.count(a) == 0);
+    assert(avail_pos[a] != -1);
     state_seq.push_back(action_list);
     act_seq.push_back(a);
 
-    covered_set.insert(a);
+    // remove a from avail_list by moving the last vertex to its position
+    int last = avail_list.back();
+    avail_list[avail_pos[a]] = last;
+    avail_pos[last] = avail_pos[a];
+    avail_list.pop_back();
+    avail_pos[a] = -1;
     action_list.push_back(a);
 
     double old_width = width;
     double old_bound = bound;
+    double old_lower_bound = lower_bound;
     double r_t = 0;
 
     if(bdd_type == 'U')
@@ -81,6 +119,12 @@ double LearningEnv::step(int a) {
     else if(bdd_type == 'L')
         bound = solver->generate_next_step_restriction(a,l);
 
+    else if(bdd_type == 'B') {
+        // width and bound of the relaxation
+        bound = solver->generate_next_step_bounds(a,l);
+        lower_bound = solver->restriction_bound;
+    }
+
     else {
         std::cerr << "unknown bdd_type type"  <<  bdd_type << std::endl;
         exit(0);
@@ -96,6 +140,8 @@ double LearningEnv::step(int a) {
         r_t = getRewardBound(old_bound);
     else if (reward_type == 'B' && bdd_type == 'L')
         r_t = getRewardLowerBound(old_bound);
+    else if (reward_type == 'B' && bdd_type == 'B')
+        r_t = getRewardGap(old_bound, old_lower_bound);
     else {
         std::cerr << "unknown reward type"  <<  cfg::reward_type << std::endl;
         exit(0);
@@ -109,14 +155,6 @@ double LearningEnv::step(int a) {
 
 int LearningEnv::randomAction() {
     assert(graph);
-    avail_list.clear();
-
-    for (int i = 0; i < graph->num_nodes; ++i) {
-        if (covered_set.count(i) == 0) {
-            avail_list.push_back(i);
-        }
-    }
-
     assert(avail_list.size());
 
     int idx = rand() % avail_list.size();
@@ -142,3 +180,7 @@ double LearningEnv::getRewardBound(int old_bound) {
 double LearningEnv::getRewardLowerBound(int old_bound) {
     return r_scaling * (bound - old_bound); // increase in width is penalized, decrease are rewarded
 }
+
+double LearningEnv::getRewardGap(int old_bound, int old_lower_bound) {
+    return - r_scaling * ((bound - lower_bound) - (old_bound - old_lower_bound)); // increase in gap is penalized, decrease are rewarded
+}
@@ -79,6 +79,9 @@ int Init(const int argc, const char** argv) {
 
     else if (!strcmp(cfg::bdd_type, "restricted"))
         bdd_type = 'L';
+
+    else if (!strcmp(cfg::bdd_type, "both"))
+        bdd_type = 'B';
     else {
         std::cerr << "unknown bdd type"  <<  cfg::bdd_type << std::endl;
         exit(0);
@@ -170,7 +173,9 @@ double GetResult(const int gid, int* sol) {
     int new_action;
     while (!test_env->isTerminal())
     {
+        DD_STAT( long start = stats_clock_ns() );
         Predict(g_list, states, list_pred);
+        DD_STAT( test_env->solver->layer_stats.at(test_env->action_list.size()).ns_inference += stats_clock_ns() - start );
         auto& scores = *(list_pred[0]);
         new_action = arg_max(test_env->graph->num_nodes, scores.data());
         v += test_env->step(new_action) / r_scaling;
@@ -178,6 +183,7 @@ double GetResult(const int gid, int* sol) {
 
     sol[0] = test_env->width;
     sol[1] = test_env->bound;
+    sol[2] = test_env->lower_bound;
     return v;
 }
 
@@ -193,7 +199,9 @@ double GetSol(const int gid, int* sol) {
     int new_action;
     while (!test_env->isTerminal())
     {
+        DD_STAT( long start = stats_clock_ns() );
         Predict(g_list, states, list_pred);
+        DD_STAT( test_env->solver->layer_stats.at(test_env->action_list.size()).ns_inference += stats_clock_ns() - start );
         auto& scores = *(list_pred[0]);
         new_action = arg_max(test_env->graph->num_nodes, scores.data());
         v += test_env->step(new_action) / r_scaling;
@@ -210,6 +218,15 @@ double GetSol(const int gid, int* sol) {
     return -v;
 }
 
+int GetDDStats(long* stats, const int max_layers) {
+    // the restriction of combined bounds records the layers built after it forked
+    LayerStatsLog log = test_env->solver->layer_stats;
+    if (test_env->solver->restriction != NULL)
+        log.add(test_env->solver->restriction->layer_stats);
+
+    return log.copy_to(stats, max_layers);
+}
+
 int ClearMem() {
     NStepReplayMem::Clear();
     return 0;
@@ -14,7 +14,7 @@ max_n=20 # maximum number of nodes
 
 # Characterics of the DDs built
 reward_type=bound # bound, width
-bdd_type=relaxed # exact, relaxed, restricted
+bdd_type=relaxed # exact, relaxed, restricted, both
 bdd_max_width=2 # Maximum width allowed for the DD
 
 # Parameters for the training, see the related papers for more information
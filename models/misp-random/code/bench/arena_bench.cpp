@@ -0,0 +1,69 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: node allocations of the MISP solver
+ *
+ * Builds relaxed and restricted diagrams for a random graph
+ * and reports the allocation counters of the node arena.
+ * Without the arena, every node created is one heap
+ * allocation (two if its state does not fit inline).
+ *
+ * Usage: arena_bench [n_vertices] [density] [width] [n_runs]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+
+using namespace std;
+
+
+int main(int argc, char* argv[]) {
+
+	int n_vertices = (argc > 1) ? atoi(argv[1]) : 300;
+	double density = (argc > 2) ? atof(argv[2]) : 0.1;
+	int width = (argc > 3) ? atoi(argv[3]) : 100;
+	int n_runs = (argc > 4) ? atoi(argv[4]) : 10;
+
+	srand(0);
+	vector< vector< pair<int,double> > > adj(n_vertices);
+	for( int i = 0; i < n_vertices; i++ ) {
+		for( int j = i+1; j < n_vertices; j++ ) {
+			if( rand() < density * RAND_MAX ) {
+				adj[i].push_back(pair<int,double>(j, 1.0));
+			}
+		}
+	}
+	IndepSetInst* inst = new IndepSetInst;
+	inst->build_complete_instance(adj);
+
+	IndepSetSolver solver(inst, width);
+	solver.ordering = new MinInState(inst);
+	solver.merger = new MinLongestPath(inst, width);
+
+	IntSet root_state(0, n_vertices-1, true);
+
+	clock_t start = clock();
+	int ub = 0, lb = 0;
+	for( int r = 0; r < n_runs; r++ ) {
+		ub = solver.generate_relaxation(root_state, 0);
+		lb = solver.generate_restriction_with_ordering(root_state, 0);
+	}
+	double time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	long heap_allocs_without_arena = solver.arena.stats.n_created;
+	if( root_state.n_words > INTSET_INLINE_WORDS ) {
+		heap_allocs_without_arena *= 2;
+	}
+
+	cout << "vertices=" << n_vertices << " width=" << width << " runs=" << n_runs;
+	cout << " ub=" << ub << " lb=" << lb << " time=" << time << "s" << endl;
+	solver.arena.print_stats(cout);
+	cout << "\theap allocations without arena: " << heap_allocs_without_arena << endl;
+
+	return 0;
+}
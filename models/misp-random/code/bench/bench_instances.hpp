@@ -0,0 +1,58 @@
+/*
+ * --------------------------------------------------------
+ * Random instances shared by the benchmarks
+ *
+ * Graphs are generated from a fixed seed, so that runs of
+ * a benchmark (and benchmarks given the same parameters)
+ * work on the same graph.
+ * --------------------------------------------------------
+ */
+
+#ifndef BENCH_INSTANCES_HPP_
+#define BENCH_INSTANCES_HPP_
+
+#include <cstdlib>
+#include <vector>
+
+#include "instance.hpp"
+
+using namespace std;
+
+
+/**
+ * Random graph where each edge exists with a given probability
+ */
+inline IndepSetInst* random_instance(int n_vertices, double density, int seed = 0) {
+	srand(seed);
+	vector< vector< pair<int,double> > > adj(n_vertices);
+	for( int i = 0; i < n_vertices; i++ ) {
+		for( int j = i+1; j < n_vertices; j++ ) {
+			if( rand() < density * RAND_MAX ) {
+				adj[i].push_back(pair<int,double>(j, 1.0));
+			}
+		}
+	}
+	IndepSetInst* inst = new IndepSetInst;
+	inst->build_complete_instance(adj);
+	return inst;
+}
+
+
+/**
+ * Random graph with a given average degree, drawing its edges directly (for large
+ * sparse graphs; loops and repeated edges are dropped by build_from_edges)
+ */
+inline IndepSetInst* random_sparse_instance(int n_vertices, double avg_degree, int seed = 0) {
+	srand(seed);
+	vector< pair<int,int> > edges;
+	long n_edges = (long)(avg_degree * n_vertices / 2);
+	for( long e = 0; e < n_edges; e++ ) {
+		edges.push_back(pair<int,int>(rand() % n_vertices, rand() % n_vertices));
+	}
+	IndepSetInst* inst = new IndepSetInst;
+	inst->build_from_edges(n_vertices, edges);
+	return inst;
+}
+
+
+#endif /* BENCH_INSTANCES_HPP_ */
@@ -0,0 +1,99 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: relaxation and restriction in one pass
+ *
+ * Builds a relaxation and a restriction of a random graph
+ * step by step (vertices in index order, or chosen by min
+ * state), either separately or with the combined step,
+ * which shares the layers until the first one exceeding
+ * the width. Relaxation bounds must be the same, and so
+ * must restriction bounds with the index order.
+ *
+ * Usage: both_bounds <n_vertices> <density> <width> [min|degree] [n_runs]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 4 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> <width> [min|degree] [n_runs]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	int n_vertices = inst->graph->n_vertices;
+	int width = atoi(argv[3]);
+	bool min_in_state = ( argc > 4 && strcmp(argv[4], "min") == 0 );
+	int n_runs = ( argc > 5 ) ? atoi(argv[5]) : 1;
+
+	IndepSetSolver solver(inst, width);
+	if( min_in_state ) {
+		solver.ordering = new MinInState(inst);
+	} else {
+		solver.ordering = new MinDegreeOrdering(inst);
+	}
+	solver.merger = new MinLongestPath(inst, width);
+	IntSet root_state(0, n_vertices-1, true);
+
+	// separate diagrams
+	int relaxed = 0, restricted = 0;
+	clock_t start = clock();
+	for( int run = 0; run < n_runs; run++ ) {
+		solver.initialize(root_state, 0);
+		for( int v = 0; v < n_vertices; v++ ) {
+			solver.generate_next_step_relaxation(v);
+		}
+		relaxed = solver.get_bound();
+
+		solver.initialize(root_state, 0);
+		for( int v = 0; v < n_vertices; v++ ) {
+			solver.generate_next_step_restriction(v);
+		}
+		restricted = solver.get_bound();
+	}
+	double separate_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	// combined diagrams
+	int both_relaxed = 0, both_restricted = 0, split_layer = -1;
+	start = clock();
+	for( int run = 0; run < n_runs; run++ ) {
+		solver.initialize(root_state, 0);
+		for( int v = 0; v < n_vertices; v++ ) {
+			solver.generate_next_step_bounds(v);
+			if( solver.split && split_layer == -1 ) {
+				split_layer = v;
+			}
+		}
+		both_relaxed = solver.get_bound();
+		both_restricted = solver.get_restriction_bound();
+	}
+	double both_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	cout << "relaxation:  " << relaxed << " - " << both_relaxed << endl;
+	cout << "restriction: " << restricted << " - " << both_restricted << endl;
+	cout << "first layer over width: " << split_layer << endl;
+	printf("separate diagrams: %10.4fs\n", separate_seconds);
+	printf("combined step:     %10.4fs\n", both_seconds);
+
+	int n_different = ( relaxed != both_relaxed ) ? 1 : 0;
+	if( !min_in_state && restricted != both_restricted ) {
+		n_different++;
+	}
+	cout << "different bounds: " << n_different << endl;
+
+	delete solver.ordering;
+	delete solver.merger;
+	return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: re-evaluating a materialized decision diagram
+ *
+ * Builds the exact DD of a random graph once with the
+ * diagram materialized, then evaluates a number of random
+ * weight vectors in two ways: rebuilding the diagram for
+ * each of them, and a single multi-objective longest path
+ * pass over the compact diagram. Both must give the same
+ * optimal values.
+ *
+ * Usage: compact_dd_bench [n_vertices] [density] [n_objectives]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+int main(int argc, char* argv[]) {
+
+	int n_vertices = (argc > 1) ? atoi(argv[1]) : 80;
+	double density = (argc > 2) ? atof(argv[2]) : 0.3;
+	int n_objectives = (argc > 3) ? atoi(argv[3]) : 64;
+
+	IndepSetInst* inst = random_instance(n_vertices, density);
+	IntSet root_state(0, n_vertices-1, true);
+
+	// weights[v*n_objectives + k] is the weight of vertex v in objective k
+	vector<int> weights(n_vertices * n_objectives);
+	for( int i = 0; i < (int)weights.size(); i++ ) {
+		weights[i] = 1 + rand() % 100;
+	}
+
+	IndepSetSolver solver(inst, EXACT_BDD);
+	solver.ordering = new MinInState(inst);
+	solver.merger = new MinLongestPath(inst, EXACT_BDD);
+
+	// rebuild for each objective
+	int* original_weights = inst->weights;
+	vector<int> objective_weights(n_vertices);
+	vector<int> rebuilt(n_objectives);
+	clock_t start = clock();
+	for( int k = 0; k < n_objectives; k++ ) {
+		for( int v = 0; v < n_vertices; v++ ) {
+			objective_weights[v] = weights[v*n_objectives + k];
+		}
+		inst->weights = objective_weights.data();
+		rebuilt[k] = solver.generate_relaxation(root_state, 0);
+	}
+	double rebuild_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	inst->weights = original_weights;
+
+	// build once and re-evaluate
+	start = clock();
+	solver.materialize = true;
+	solver.generate_relaxation(root_state, 0);
+	double build_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	vector<int> lengths(n_objectives);
+	start = clock();
+	solver.compact_dd.longest_paths(weights.data(), n_objectives, lengths.data());
+	double eval_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	int n_different = 0;
+	for( int k = 0; k < n_objectives; k++ ) {
+		if( lengths[k] != rebuilt[k] ) {
+			n_different++;
+		}
+	}
+
+	cout << "vertices: " << n_vertices << " - density: " << density << " - objectives: " << n_objectives << endl;
+	cout << "diagram: " << solver.compact_dd.get_n_nodes() << " nodes - " << solver.compact_dd.get_n_layers() << " layers" << endl;
+	printf("rebuild per objective: %10.4fs\n", rebuild_seconds);
+	printf("materialize once:      %10.4fs\n", build_seconds);
+	printf("re-evaluate all:       %10.4fs\n", eval_seconds);
+	cout << "objectives with different values: " << n_different << endl;
+
+	delete solver.ordering;
+	delete solver.merger;
+	return 0;
+}
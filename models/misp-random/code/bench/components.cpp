@@ -0,0 +1,89 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: relaxations decomposed into components
+ *
+ * Builds relaxations of a sparse random graph (vertices
+ * in min degree order) with and without component
+ * decomposition, for a list of widths (-1: exact). Exact
+ * diagrams must give the same bound both ways.
+ *
+ * Usage: components <n_vertices> <avg_degree> [n_threads] [widths...]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+static double seconds_since(chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <avg_degree> [n_threads] [widths...]" << endl;
+		return 1;
+	}
+
+	int n_vertices = atoi(argv[1]);
+	IndepSetInst* inst = random_instance(n_vertices, atof(argv[2]) / (n_vertices - 1));
+	int n_threads = ( argc > 3 ) ? atoi(argv[3]) : 1;
+
+	vector<int> widths;
+	for( int i = 4; i < argc; i++ ) {
+		widths.push_back(atoi(argv[i]));
+	}
+	if( widths.empty() ) {
+		widths.push_back(10);
+		widths.push_back(100);
+		widths.push_back(1000);
+	}
+
+	IndepSetSolver solver(inst, EXACT_BDD);
+	solver.ordering = new MinDegreeOrdering(inst);
+	solver.merger = new MinLongestPath(inst, EXACT_BDD);
+	solver.n_threads = n_threads;
+	solver.bb_params.make_ordering = [](IndepSetInst* inst) { return (IS_Ordering*) new MinDegreeOrdering(inst); };
+	solver.bb_params.make_merger = [](IndepSetInst* inst, int width) { return (IS_Merging*) new MinLongestPath(inst, width); };
+	IntSet root_state(0, inst->graph->n_vertices-1, true);
+
+	int n_different = 0;
+	for( int i = 0; i < (int)widths.size(); i++ ) {
+		solver.width = widths[i];
+		solver.merger->width = widths[i];
+
+		solver.decompose = false;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		int whole = solver.generate_relaxation(root_state, 0);
+		double whole_seconds = seconds_since(start);
+		int whole_width = solver.final_width;
+
+		solver.decompose = true;
+		start = chrono::steady_clock::now();
+		int decomposed = solver.generate_relaxation(root_state, 0);
+		double decomposed_seconds = seconds_since(start);
+
+		printf("width %6d: %6d (max width %7d, %8.4fs) - %6d (max width %7d, %8.4fs, decomposed at layer %d)\n",
+				widths[i], whole, whole_width, whole_seconds,
+				decomposed, solver.final_width, decomposed_seconds, solver.decomposed_layer);
+		if( widths[i] == EXACT_BDD && whole != decomposed ) {
+			n_different++;
+		}
+	}
+	cout << "exact diagrams with different bounds: " << n_different << endl;
+
+	delete solver.ordering;
+	delete solver.merger;
+	return 0;
+}
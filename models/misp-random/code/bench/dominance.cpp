@@ -0,0 +1,108 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: dominance filter of layers
+ *
+ * Builds relaxations and restrictions of a random graph
+ * step by step (vertices in min degree order) with and
+ * without discarding dominated layer nodes, for a list of
+ * widths, and reports the nodes discarded per layer.
+ * Relaxations must stay above the optimum and restrictions
+ * below it (the exact diagram is built for the check).
+ *
+ * Usage: dominance <n_vertices> <density> [widths...]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+/**
+ * Bound of a diagram built step by step, and its time in seconds
+ */
+static int build_steps(IndepSetSolver &solver, IntSet &root_state, bool relaxed, double &seconds) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	solver.initialize(root_state, 0);
+	for( int layer = 0; layer < solver.inst->graph->n_vertices; layer++ ) {
+		int v = solver.ordering->vertex_in_layer(NULL, layer);
+		if( relaxed ) {
+			solver.generate_next_step_relaxation(v);
+		} else {
+			solver.generate_next_step_restriction(v);
+		}
+	}
+	int bound = solver.get_bound();
+	seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return bound;
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> [widths...]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	vector<int> widths;
+	for( int i = 3; i < argc; i++ ) {
+		widths.push_back(atoi(argv[i]));
+	}
+	if( widths.empty() ) {
+		widths.push_back(10);
+		widths.push_back(100);
+		widths.push_back(1000);
+	}
+
+	IndepSetSolver solver(inst, EXACT_BDD);
+	solver.ordering = new MinDegreeOrdering(inst);
+	solver.merger = new MinLongestPath(inst, EXACT_BDD);
+	IntSet root_state(0, inst->graph->n_vertices-1, true);
+
+	int optimum = solver.generate_relaxation(root_state, 0);
+	cout << "optimum: " << optimum << endl;
+
+	int n_invalid = 0;
+	for( int i = 0; i < (int)widths.size(); i++ ) {
+		solver.width = widths[i];
+		solver.merger->width = widths[i];
+
+		for( int relaxed = 1; relaxed >= 0; relaxed-- ) {
+			double plain_seconds, filtered_seconds;
+			solver.dominance = false;
+			int plain = build_steps(solver, root_state, relaxed, plain_seconds);
+
+			solver.dominance = true;
+			int filtered = build_steps(solver, root_state, relaxed, filtered_seconds);
+
+			int n_layers = 0;
+			int most = 0;
+			for( int l = 0; l < (int)solver.dominated_in_layer.size(); l++ ) {
+				n_layers += ( solver.dominated_in_layer[l] > 0 ) ? 1 : 0;
+				most = MAX(most, solver.dominated_in_layer[l]);
+			}
+
+			printf("width %6d %s: %6d (%8.4fs) - %6d (%8.4fs), %ld nodes dominated in %d layers (at most %d)\n",
+					widths[i], relaxed ? "relaxation " : "restriction",
+					plain, plain_seconds, filtered, filtered_seconds,
+					solver.n_dominated, n_layers, most);
+			if( (relaxed && filtered < optimum) || (!relaxed && filtered > optimum) ) {
+				n_invalid++;
+			}
+		}
+	}
+	cout << "invalid bounds: " << n_invalid << endl;
+
+	delete solver.ordering;
+	delete solver.merger;
+	return 0;
+}
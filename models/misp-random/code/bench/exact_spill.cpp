@@ -0,0 +1,79 @@
+/*
+ * --------------------------------------------------------
+ * Exact MISP diagram within a memory budget
+ *
+ * Usage: exact_spill <n_vertices> <density> <budget in MB> [ordering] [compare]
+ *
+ * Builds the exact DD of a random graph with the min-in-state
+ * ordering ("min", default) or the minimum degree ordering
+ * ("degree"), spilling pool nodes to disk above the budget
+ * (-1: no budget). With "compare", the diagram is first built
+ * without budget to check the optimal value.
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+/**
+ * Build the exact diagram with a memory budget, returning the optimal value
+ */
+static int solve_exact(IndepSetInst* inst, long budget, bool min_in_state, bool verbose) {
+	IndepSetSolver solver(inst, EXACT_BDD);
+	if( min_in_state ) {
+		solver.ordering = new MinInState(inst);
+	} else {
+		solver.ordering = new MinDegreeOrdering(inst);
+	}
+	solver.merger = new MinLongestPath(inst, EXACT_BDD);
+	solver.memory_budget = budget;
+
+	IntSet root_state(0, inst->graph->n_vertices-1, true);
+	clock_t start = clock();
+	int value = solver.generate_relaxation(root_state, 0);
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	if( verbose ) {
+		cout << "budget: " << budget << " bytes - optimal value: " << value << " - time: " << seconds << "s" << endl;
+		cout << "max. width: " << solver.final_width << endl;
+		solver.print_memory_stats(cout);
+	}
+
+	delete solver.ordering;
+	delete solver.merger;
+	return value;
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 4 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> <budget in MB> [min|degree] [compare]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	double budget_mb = atof(argv[3]);
+	long budget = ( budget_mb < 0 ) ? -1 : (long)(budget_mb * 1024 * 1024);
+	bool min_in_state = ( argc <= 4 || strcmp(argv[4], "degree") != 0 );
+
+	if( argc > 5 && strcmp(argv[5], "compare") == 0 ) {
+		int reference = solve_exact(inst, -1, min_in_state, false);
+		int value = solve_exact(inst, budget, min_in_state, true);
+		cout << "same value as without budget: " << (value == reference ? "yes" : "NO") << endl;
+	} else {
+		solve_exact(inst, budget, min_in_state, true);
+	}
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: lookahead over the next vertex
+ *
+ * Builds the first layers of a relaxation step by step
+ * (vertices in index order), then evaluates a number of
+ * candidate next vertices: each candidate is branched
+ * first and the diagram is completed in index order. The
+ * partial diagram is either forked for each candidate or
+ * rebuilt from scratch. Both must give the same bounds,
+ * and the forked solver must still complete its diagram.
+ *
+ * Usage: fork_lookahead <n_vertices> <density> <width> [prefix] [n_candidates]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+/**
+ * Branch on candidate, then on the remaining vertices in index order
+ */
+static int complete(IndepSetSolver &solver, int first, int candidate) {
+	solver.generate_next_step_relaxation(candidate);
+	for( int v = first; v < solver.inst->graph->n_vertices; v++ ) {
+		if( v != candidate ) {
+			solver.generate_next_step_relaxation(v);
+		}
+	}
+	return solver.get_bound();
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 4 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> <width> [prefix] [n_candidates]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	int n_vertices = inst->graph->n_vertices;
+	int width = atoi(argv[3]);
+	int prefix = ( argc > 4 ) ? atoi(argv[4]) : n_vertices/2;
+	int n_candidates = ( argc > 5 ) ? atoi(argv[5]) : 8;
+	n_candidates = MIN(n_candidates, n_vertices - prefix);
+
+	IndepSetSolver solver(inst, width);
+	solver.ordering = new MinDegreeOrdering(inst);
+	solver.merger = new MinLongestPath(inst, width);
+	IntSet root_state(0, n_vertices-1, true);
+
+	solver.initialize(root_state, 0);
+	for( int v = 0; v < prefix; v++ ) {
+		solver.generate_next_step_relaxation(v);
+	}
+
+	// one fork per candidate
+	vector<int> forked(n_candidates);
+	double fork_seconds = 0;
+	clock_t start = clock();
+	for( int i = 0; i < n_candidates; i++ ) {
+		clock_t fork_start = clock();
+		IndepSetSolver* child = solver.fork();
+		fork_seconds += (double)(clock() - fork_start) / CLOCKS_PER_SEC;
+
+		forked[i] = complete(*child, prefix, prefix+i);
+		delete child;
+	}
+	double forked_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	// forked solver completes its own diagram
+	int parent_bound = complete(solver, prefix, prefix);
+
+	// one rebuild per candidate
+	IndepSetSolver rebuild(inst, width);
+	rebuild.ordering = solver.ordering;
+	rebuild.merger = solver.merger;
+	vector<int> rebuilt(n_candidates);
+	start = clock();
+	for( int i = 0; i < n_candidates; i++ ) {
+		rebuild.initialize(root_state, 0);
+		for( int v = 0; v < prefix; v++ ) {
+			rebuild.generate_next_step_relaxation(v);
+		}
+		rebuilt[i] = complete(rebuild, prefix, prefix+i);
+	}
+	double rebuilt_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	int n_different = ( n_candidates > 0 && parent_bound != rebuilt[0] ) ? 1 : 0;
+	for( int i = 0; i < n_candidates; i++ ) {
+		cout << "vertex " << prefix+i << ": " << forked[i] << " - " << rebuilt[i] << endl;
+		if( forked[i] != rebuilt[i] ) {
+			n_different++;
+		}
+	}
+	cout << "forked solver: " << parent_bound << endl;
+	printf("fork per candidate:    %10.4fs (forks: %.6fs)\n", forked_seconds, fork_seconds);
+	printf("rebuild per candidate: %10.4fs\n", rebuilt_seconds);
+	cout << "different bounds: " << n_different << endl;
+
+	delete solver.ordering;
+	delete solver.merger;
+	return 0;
+}
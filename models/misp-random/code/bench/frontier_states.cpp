@@ -0,0 +1,92 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: states of exact and wide diagrams
+ *
+ * Builds the exact diagram and wide relaxations of a random
+ * graph (vertices in min degree order) and reports, from
+ * the layer counters, how many children were branched, how
+ * many had the state of a node already in the pool, the
+ * node slots taken from the arena, and the time spent
+ * branching and matching children.
+ *
+ * The pool never holds two nodes with the same state, so
+ * the peak frontier is also its number of distinct states.
+ * Its bytes are compared with those of nodes referencing
+ * interned state blocks by handle (handle per node, plus
+ * words, reference count and two table slots per state, as
+ * tables are kept at most half full).
+ *
+ * Usage: frontier_states <n_vertices> <density> [widths...]
+ *        (width -1 is the exact diagram)
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> [widths...]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	vector<int> widths;
+	for( int i = 3; i < argc; i++ ) {
+		widths.push_back(atoi(argv[i]));
+	}
+	if( widths.empty() ) {
+		widths.push_back(EXACT_BDD);
+		widths.push_back(1000);
+		widths.push_back(10000);
+	}
+
+	IndepSetSolver solver(inst, EXACT_BDD);
+	solver.ordering = new MinDegreeOrdering(inst);
+	solver.merger = new MinLongestPath(inst, EXACT_BDD);
+	IntSet root_state(0, inst->graph->n_vertices-1, true);
+
+	long state_bytes = sizeof(uint64_t) * ( (root_state.n_words > INTSET_INLINE_WORDS) ? root_state.n_words : 0 );
+	long node_bytes = solver.arena.slot_bytes;
+	long handle_node_bytes = sizeof(Node) - sizeof(IntSet) + sizeof(int);
+	long block_bytes = sizeof(uint64_t) * root_state.n_words + sizeof(int) + 2*sizeof(NodeTable::Slot);
+
+	for( int i = 0; i < (int)widths.size(); i++ ) {
+		solver.width = widths[i];
+		solver.merger->width = widths[i];
+
+		long slots_before = solver.arena.stats.n_created;
+		int bound = solver.generate_relaxation(root_state, 0);
+		long slots = solver.arena.stats.n_created - slots_before;
+
+		long children = 0, hits = 0, peak_nodes = 0, ns_branch = 0, ns_extract = 0;
+		for( int l = 0; l < (int)solver.layer_stats.layers.size(); l++ ) {
+			LayerStats &stats = solver.layer_stats.layers[l];
+			children += stats.nodes_created + stats.dedup_hits;
+			hits += stats.dedup_hits;
+			peak_nodes = MAX(peak_nodes, stats.pool_size);
+			ns_branch += stats.ns_branch;
+			ns_extract += stats.ns_extract;
+		}
+
+		printf("width %6d: bound %5d - %9ld children, %9ld matched (%5.1f%%), %9ld node slots - branch %8.4fs, extract %8.4fs\n",
+				widths[i], bound, children, hits, children > 0 ? 100.0 * hits / children : 0.0, slots,
+				ns_branch * 1e-9, ns_extract * 1e-9);
+		printf("              peak frontier %9ld states: %10ld bytes in nodes (%ld per node, %ld of state words), %10ld with interned states\n",
+				peak_nodes, peak_nodes * node_bytes, node_bytes, state_bytes,
+				peak_nodes * (handle_node_bytes + block_bytes));
+	}
+
+	delete solver.ordering;
+	delete solver.merger;
+	return 0;
+}
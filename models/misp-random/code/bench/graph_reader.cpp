@@ -0,0 +1,108 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: reading graph files
+ *
+ * Reads a DIMACS, edge list or METIS file with the mapped
+ * reader, then reads the same edges token by token with
+ * an input stream, and builds the graph from both lists.
+ * Edge lists must be the same.
+ *
+ * Usage: graph_reader <file> [n_threads]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "graph.hpp"
+
+using namespace std;
+
+
+/**
+ * Wall clock time in seconds
+ */
+static double wall_time() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+
+/**
+ * Edges of a DIMACS or edge list file read with an input stream
+ */
+static void read_with_stream(const char* filename, bool dimacs, vector< pair<int,int> > &edges) {
+	ifstream input(filename);
+	string token;
+	int n, m, u, v, w;
+	if( dimacs ) {
+		while( input >> token ) {
+			if( token == "p" ) {
+				input >> token >> n >> m;
+			} else if( token == "e" ) {
+				input >> u >> v;
+				edges.push_back(pair<int,int>(u-1, v-1));
+			} else {
+				getline(input, token);
+			}
+		}
+	} else {
+		input >> n >> m;
+		string line;
+		getline(input, line);
+		while( getline(input, line) ) {
+			if( sscanf(line.c_str(), "%d %d %d", &u, &v, &w) >= 2 ) {
+				edges.push_back(pair<int,int>(u-1, v-1));
+			}
+		}
+	}
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 2 ) {
+		cout << "Usage: " << argv[0] << " <file> [n_threads]" << endl;
+		return 1;
+	}
+	int n_threads = ( argc > 2 ) ? atoi(argv[2]) : 0;
+
+	double start = wall_time();
+	GraphFileEdges graph_file;
+	read_graph_file(argv[1], graph_file, GRAPH_FORMAT_AUTO, n_threads);
+	double mapped_seconds = wall_time() - start;
+
+	start = wall_time();
+	Graph_BDD graph;
+	graph.build(graph_file.n_vertices, graph_file.edges);
+	double build_seconds = wall_time() - start;
+
+	cout << "vertices: " << graph.n_vertices << " - edges: " << graph.n_edges << endl;
+	printf("mapped reader: %10.4fs\n", mapped_seconds);
+	printf("build graph:   %10.4fs\n", build_seconds);
+
+	// METIS files have no stream counterpart
+	string name(argv[1]);
+	if( name.find(".graph") != string::npos || name.find(".metis") != string::npos ) {
+		return 0;
+	}
+
+	ifstream input(argv[1]);
+	char first = ' ';
+	input >> first;
+	input.close();
+
+	start = wall_time();
+	vector< pair<int,int> > edges;
+	read_with_stream(argv[1], first == 'c' || first == 'p', edges);
+	double stream_seconds = wall_time() - start;
+
+	printf("input stream:  %10.4fs\n", stream_seconds);
+	cout << "different edge lists: " << ( edges != graph_file.edges ? 1 : 0 ) << endl;
+	return 0;
+}
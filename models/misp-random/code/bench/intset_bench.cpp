@@ -0,0 +1,99 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: IntSet word kernels per instruction set
+ *
+ * Runs the state transition (intersection with an
+ * adjacency mask), merger unions, popcounts and equality
+ * tests with every kernel table supported by the machine,
+ * and checks they all give the same results.
+ *
+ * Usage: intset_bench [n_vertices] [n_sets] [n_rounds]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "intset.hpp"
+
+using namespace std;
+
+
+/**
+ * Run set operations with the kernels currently in word_ops
+ */
+static long run_ops(vector<IntSet> &sets, vector<IntSet> &masks, int n_rounds) {
+	long check = 0;
+	IntSet state = sets[0];
+	for( int r = 0; r < n_rounds; r++ ) {
+		for( int i = 0; i < (int)sets.size(); i++ ) {
+			state = sets[i];
+			state.intersect_with(masks[i % masks.size()]);
+			check += state.get_size();
+			state.union_with(sets[(i+1) % sets.size()]);
+			check += state.get_symmetric_difference_size(sets[i]);
+			check += state.equals_to(sets[(i+1) % sets.size()]);
+			check += state.is_subset(sets[i]);
+		}
+	}
+	return check;
+}
+
+
+int main(int argc, char* argv[]) {
+
+	int n_vertices = (argc > 1) ? atoi(argv[1]) : 1000;
+	int n_sets = (argc > 2) ? atoi(argv[2]) : 1000;
+	int n_rounds = (argc > 3) ? atoi(argv[3]) : 200;
+
+	srand(0);
+	vector<IntSet> sets(n_sets, IntSet(0, n_vertices-1, false));
+	vector<IntSet> masks(64, IntSet(0, n_vertices-1, true));
+	for( int i = 0; i < n_sets; i++ ) {
+		for( int v = 0; v < n_vertices; v++ ) {
+			if( rand() % 2 == 0 ) {
+				sets[i].add(v);
+			}
+		}
+	}
+	for( int i = 0; i < (int)masks.size(); i++ ) {
+		for( int v = 0; v < n_vertices; v++ ) {
+			if( rand() % 10 == 0 ) {
+				masks[i].remove(v);
+			}
+		}
+	}
+
+	printf("vertices=%d words=%d sets=%d rounds=%d (selected: %s)\n",
+			n_vertices, sets[0].n_words, n_sets, n_rounds, word_ops.name);
+
+	WordOps selected = word_ops;
+	const char* names[] = {"scalar", "avx2", "avx512"};
+	long reference = 0;
+	int status = 0;
+	for( int k = 0; k < 3; k++ ) {
+		const WordOps* ops = get_word_ops(names[k]);
+		if( ops == NULL ) {
+			printf("%-7s not supported\n", names[k]);
+			continue;
+		}
+		word_ops = *ops;
+
+		clock_t start = clock();
+		long check = run_ops(sets, masks, n_rounds);
+		double time = (double)(clock() - start) / CLOCKS_PER_SEC;
+		printf("%-7s %.3fs\n", names[k], time);
+
+		if( k == 0 ) {
+			reference = check;
+		} else if( check != reference ) {
+			printf("error: %s results differ (%ld vs %ld)\n", names[k], check, reference);
+			status = 1;
+		}
+	}
+	word_ops = selected;
+
+	return status;
+}
@@ -0,0 +1,109 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: kernelization before diagram construction
+ *
+ * Reduces a random graph with a given average degree and
+ * reports the reductions applied and the size of the
+ * kernel. Diagrams of the graph and of its kernel are
+ * then built (min-in-state ordering), and the bound of the
+ * kernel plus the weight of the reductions must equal the
+ * bound of the graph when both are exact. In that case the
+ * longest path of the kernel diagram is lifted back and
+ * checked to be an independent set of the optimal weight.
+ *
+ * Usage: kernelization <n_vertices> <avg_degree> [width]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "kernelization.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+/**
+ * Bound of a diagram of an instance and its time in seconds (an instance without
+ * vertices has bound 0)
+ */
+static int solve(IndepSetInst* inst, int width, bool materialize, double &seconds, vector<int> &solution) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	int bound = 0;
+	solution.clear();
+	if( inst->graph->n_vertices > 0 ) {
+		IndepSetSolver solver(inst, width);
+		solver.ordering = new MinInState(inst);
+		solver.merger = new MinLongestPath(inst, width);
+		solver.materialize = materialize;
+		IntSet root_state(0, inst->graph->n_vertices-1, true);
+		bound = solver.generate_relaxation(root_state, 0);
+		if( materialize ) {
+			solver.compact_dd.longest_path(solution);
+		}
+		delete solver.ordering;
+		delete solver.merger;
+	}
+	seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return bound;
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <avg_degree> [width]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_sparse_instance(atoi(argv[1]), atof(argv[2]));
+	int width = (argc > 3) ? atoi(argv[3]) : EXACT_BDD;
+
+	Kernelization kernelization;
+	kernelization.reduce(inst);
+	IndepSetInst* kernel = kernelization.kernel;
+
+	printf("graph:  %8d vertices, %9d edges\n", inst->graph->n_vertices, inst->graph->n_edges);
+	printf("kernel: %8d vertices, %9d edges (%.1f%% of the vertices) - offset %d - %.4fs\n",
+			kernel->graph->n_vertices, kernel->graph->n_edges,
+			100.0 * kernel->graph->n_vertices / MAX(1, inst->graph->n_vertices),
+			kernelization.offset, kernelization.seconds);
+	printf("taken %ld, pendant %ld, folded %ld, dominated %ld, twins %ld, nonpositive %ld\n",
+			kernelization.n_taken, kernelization.n_pendant, kernelization.n_folded,
+			kernelization.n_dominated, kernelization.n_twins, kernelization.n_nonpositive);
+
+	double seconds, kernel_seconds;
+	vector<int> solution, kernel_solution;
+	bool exact = ( width == EXACT_BDD );
+	int bound = solve(inst, width, false, seconds, solution);
+	int kernel_bound = solve(kernel, width, exact, kernel_seconds, kernel_solution);
+	printf("bound: %6d (%8.4fs) - kernel %6d + %d = %6d (%8.4fs)\n",
+			bound, seconds, kernel_bound, kernelization.offset, kernelization.lift_bound(kernel_bound), kernel_seconds);
+
+	int n_invalid = 0;
+	if( exact ) {
+		n_invalid += ( kernelization.lift_bound(kernel_bound) != bound ) ? 1 : 0;
+
+		kernelization.lift_solution(kernel_solution, solution);
+		int weight = 0;
+		for( int i = 0; i < (int)solution.size(); i++ ) {
+			weight += inst->weights[solution[i]];
+			for( int j = i+1; j < (int)solution.size(); j++ ) {
+				if( inst->graph->is_adj(solution[i], solution[j]) ) {
+					n_invalid++;
+				}
+			}
+		}
+		n_invalid += ( weight != bound ) ? 1 : 0;
+		printf("lifted solution: %d vertices, weight %d\n", (int)solution.size(), weight);
+	}
+	cout << "invalid: " << n_invalid << endl;
+
+	delete inst;
+	return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * --------------------------------------------------------
+ * Exact MISP solve with the parallel branch and bound
+ *
+ * Usage: misp_bnb <n_vertices> <density> [width] [threads] [node limit] [time limit] [prune] [kernelize]
+ *
+ * Solves a random graph with the min-in-state ordering and the minimum longest
+ * path merger. Progress is printed every second. Diagrams prune nodes with the
+ * clique cover bound unless prune is 0. If kernelize is 1, the kernel of the
+ * graph is solved instead and its bounds lifted back.
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "kernelization.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> [width] [threads] [node limit] [time limit] [prune] [kernelize]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	int width = (argc > 3) ? atoi(argv[3]) : 100;
+
+	Kernelization kernelization;
+	if( argc > 8 && atoi(argv[8]) != 0 ) {
+		kernelization.reduce(inst);
+		cout << "kernel: " << kernelization.kernel->graph->n_vertices << " vertices - " << kernelization.kernel->graph->n_edges
+				<< " edges - offset " << kernelization.offset << endl;
+		inst = kernelization.kernel;
+	}
+	if( inst->graph->n_vertices == 0 ) {
+		cout << "lower bound: " << kernelization.offset << endl;
+		cout << "upper bound: " << kernelization.offset << endl;
+		cout << "optimal: yes" << endl;
+		return 0;
+	}
+
+	IndepSetSolver solver(inst, width);
+	solver.ordering = new MinInState(inst);
+	solver.merger = new MinLongestPath(inst, width);
+
+	solver.bb_params.n_threads = (argc > 4) ? atoi(argv[4]) : 1;
+	solver.bb_params.node_limit = (argc > 5) ? atol(argv[5]) : -1;
+	solver.bb_params.time_limit = (argc > 6) ? atof(argv[6]) : -1;
+	solver.bb_params.prune_nodes = (argc > 7) ? (atoi(argv[7]) != 0) : true;
+	solver.bb_params.report_interval = 1;
+	solver.bb_params.make_ordering = [](IndepSetInst* _inst) -> IS_Ordering* { return new MinInState(_inst); };
+	solver.bb_params.make_merger = [](IndepSetInst* _inst, int _width) -> IS_Merging* { return new MinLongestPath(_inst, _width); };
+
+	Bounds bounds = solver.branch_and_bound();
+	bounds.lb = kernelization.lift_bound(bounds.lb);
+	bounds.ub = kernelization.lift_bound(bounds.ub);
+
+	cout << "lower bound: " << bounds.lb << endl;
+	cout << "upper bound: " << bounds.ub << endl;
+	cout << "subproblems: " << solver.bb_explored << endl;
+	cout << "optimal: " << (bounds.lb == bounds.ub ? "yes" : "no") << endl;
+
+	return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: relaxations of several widths
+ *
+ * Builds the relaxations of a random graph for a list of
+ * widths (-1: exact) in two ways: one generate_relaxation
+ * per width, and a single generate_relaxations pass that
+ * shares the exact layers. Both must give the same bounds.
+ *
+ * Usage: multi_width <n_vertices> <density> [min|degree] [widths...]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> [min|degree] [widths...]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	bool min_in_state = ( argc <= 3 || strcmp(argv[3], "degree") != 0 );
+
+	vector<int> widths;
+	for( int i = 4; i < argc; i++ ) {
+		widths.push_back(atoi(argv[i]));
+	}
+	if( widths.empty() ) {
+		widths.push_back(10);
+		widths.push_back(100);
+		widths.push_back(1000);
+		widths.push_back(10000);
+	}
+
+	IndepSetSolver solver(inst, EXACT_BDD);
+	if( min_in_state ) {
+		solver.ordering = new MinInState(inst);
+	} else {
+		solver.ordering = new MinDegreeOrdering(inst);
+	}
+	solver.merger = new MinLongestPath(inst, EXACT_BDD);
+	IntSet root_state(0, inst->graph->n_vertices-1, true);
+
+	// one relaxation per width
+	vector<int> separate(widths.size());
+	clock_t start = clock();
+	for( int i = 0; i < (int)widths.size(); i++ ) {
+		solver.width = widths[i];
+		solver.merger->width = widths[i];
+		separate[i] = solver.generate_relaxation(root_state, 0);
+	}
+	double separate_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	// single pass
+	start = clock();
+	vector<int> shared = solver.generate_relaxations(root_state, 0, widths);
+	double shared_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	int n_different = 0;
+	for( int i = 0; i < (int)widths.size(); i++ ) {
+		cout << "width " << widths[i] << ": " << separate[i] << " - " << shared[i] << endl;
+		if( separate[i] != shared[i] ) {
+			n_different++;
+		}
+	}
+	printf("one relaxation per width: %10.4fs\n", separate_seconds);
+	printf("single pass:              %10.4fs\n", shared_seconds);
+	cout << "widths with different bounds: " << n_different << endl;
+
+	delete solver.ordering;
+	delete solver.merger;
+	return 0;
+}
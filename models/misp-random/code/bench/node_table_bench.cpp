@@ -0,0 +1,120 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: ordered node map vs. hash node table
+ *
+ * Simulates the node pool traffic of the solver: states
+ * are inserted, looked up (duplicate detection) and erased
+ * (layer extraction) repeatedly.
+ *
+ * Usage: node_table_bench [n_vertices] [n_nodes] [n_rounds]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "bdd.hpp"
+#include "node_table.hpp"
+
+using namespace std;
+
+
+/**
+ * Create random nodes with states over n_vertices
+ */
+static void create_nodes(int n_vertices, int n_nodes, vector<Node*> &nodes) {
+	IntSet state(0, n_vertices-1, false);
+	for( int i = 0; i < n_nodes; i++ ) {
+		state.clear();
+		for( int v = 0; v < n_vertices; v++ ) {
+			if( rand() % 2 == 0 ) {
+				state.add(v);
+			}
+		}
+		nodes.push_back(new Node(state, i));
+	}
+}
+
+
+/**
+ * Run pool operations on the ordered map
+ */
+static long run_map(vector<Node*> &nodes, int n_rounds) {
+	long found = 0;
+	NodeMap pool;
+	for( int r = 0; r < n_rounds; r++ ) {
+		for( int i = 0; i < (int)nodes.size(); i++ ) {
+			if( pool.find(&(nodes[i]->state)) == pool.end() ) {
+				pool[&(nodes[i]->state)] = nodes[i];
+			}
+		}
+		for( int i = 0; i < (int)nodes.size(); i++ ) {
+			found += (pool.find(&(nodes[i]->state)) != pool.end());
+		}
+		found += pool.begin()->second->longest_path;
+		for( int i = 0; i < (int)nodes.size(); i++ ) {
+			pool.erase(&(nodes[i]->state));
+		}
+	}
+	return found;
+}
+
+
+/**
+ * Run pool operations on the hash table
+ */
+static long run_table(vector<Node*> &nodes, int n_rounds) {
+	long found = 0;
+	NodeTable pool;
+	for( int r = 0; r < n_rounds; r++ ) {
+		for( int i = 0; i < (int)nodes.size(); i++ ) {
+			if( pool.find(nodes[i]->state) == NULL ) {
+				pool.insert(nodes[i]);
+			}
+		}
+		for( int i = 0; i < (int)nodes.size(); i++ ) {
+			found += (pool.find(nodes[i]->state) != NULL);
+		}
+		found += pool.first_lex()->longest_path;
+		for( int i = 0; i < (int)nodes.size(); i++ ) {
+			pool.erase(nodes[i]);
+		}
+	}
+	return found;
+}
+
+
+int main(int argc, char* argv[]) {
+
+	int n_vertices = (argc > 1) ? atoi(argv[1]) : 500;
+	int n_nodes = (argc > 2) ? atoi(argv[2]) : 10000;
+	int n_rounds = (argc > 3) ? atoi(argv[3]) : 20;
+
+	srand(0);
+	vector<Node*> nodes;
+	create_nodes(n_vertices, n_nodes, nodes);
+
+	clock_t start = clock();
+	long check_map = run_map(nodes, n_rounds);
+	double time_map = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	long check_table = run_table(nodes, n_rounds);
+	double time_table = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("vertices=%d nodes=%d rounds=%d\n", n_vertices, n_nodes, n_rounds);
+	printf("map:   %.3fs\n", time_map);
+	printf("table: %.3fs (speedup %.2fx)\n", time_table, time_map / time_table);
+
+	if( check_map != check_table ) {
+		printf("error: results differ (%ld vs %ld)\n", check_map, check_table);
+		return 1;
+	}
+
+	for( int i = 0; i < (int)nodes.size(); i++ ) {
+		delete nodes[i];
+	}
+	return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: static orderings
+ *
+ * Builds the static orderings (min degree, maximal path,
+ * cut vertex on a spanning tree, and cut vertex on the
+ * graph itself) of a random graph with a given average
+ * degree, and checks that each one is a permutation of
+ * the vertices.
+ *
+ * Usage: orderings <n_vertices> <avg_degree>
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "orderings.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+/**
+ * Time to build an ordering, checking that it is a permutation
+ */
+template<class Ordering>
+static void run(const char* name, IndepSetInst* inst, int &n_invalid) {
+	clock_t start = clock();
+	Ordering ordering(inst);
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	int n_vertices = inst->graph->n_vertices;
+	vector<bool> seen(n_vertices, false);
+	bool valid = true;
+	for( int layer = 0; layer < n_vertices && valid; layer++ ) {
+		int v = ordering.vertex_in_layer(NULL, layer);
+		valid = ( v >= 0 && v < n_vertices && !seen[v] );
+		if( valid ) {
+			seen[v] = true;
+		}
+	}
+	n_invalid += valid ? 0 : 1;
+	printf("%-16s %10.4fs%s\n", name, seconds, valid ? "" : "  (not a permutation)");
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <avg_degree>" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_sparse_instance(atoi(argv[1]), atof(argv[2]));
+	cout << "vertices: " << inst->graph->n_vertices << " - edges: " << inst->graph->n_edges << endl;
+
+	int n_invalid = 0;
+	run<MinDegreeOrdering>("min degree", inst, n_invalid);
+	run<MaximalPathDecomp>("maximal path", inst, n_invalid);
+	run<CutVertexDecompositionGeneralGraph>("cut vertex gen", inst, n_invalid);
+	run<CutVertexDecomposition>("cut vertex", inst, n_invalid);
+	cout << "invalid orderings: " << n_invalid << endl;
+
+	delete inst;
+	return 0;
+}
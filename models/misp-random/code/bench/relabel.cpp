@@ -0,0 +1,116 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: vertices relabeled in processing order
+ *
+ * Builds relaxations and restrictions of a random graph
+ * step by step (vertices in min degree order), once with
+ * the vertices as given and once with the vertices
+ * relabeled in that order, for a list of widths. Reports
+ * the bounds, the time of the steps and the words of the
+ * pool states left to operate on (averaged over nodes of
+ * all layers), which shrink with relabeling as the words
+ * of vertices branched on are skipped.
+ *
+ * Usage: relabel <n_vertices> <density> [widths...]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+/**
+ * Bound of a diagram built step by step, the time of the steps in seconds and
+ * the average words of the pool states left to operate on
+ */
+static int build_steps(IndepSetSolver &solver, bool relaxed, double &seconds, double &avg_words) {
+	int n_vertices = solver.inst->graph->n_vertices;
+	IntSet root_state(0, n_vertices-1, true);
+	vector<Node*> pool_nodes;
+	long n_nodes = 0, n_words = 0;
+
+	seconds = 0;
+	solver.initialize(root_state, 0);
+	for( int layer = 0; layer < n_vertices; layer++ ) {
+		int v = solver.ordering->vertex_in_layer(NULL, layer);
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if( relaxed ) {
+			solver.generate_next_step_relaxation(v);
+		} else {
+			solver.generate_next_step_restriction(v);
+		}
+		seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		pool_nodes.clear();
+		solver.node_list.get_nodes(pool_nodes);
+		for( int i = 0; i < (int)pool_nodes.size(); i++ ) {
+			n_words += pool_nodes[i]->state.n_words - pool_nodes[i]->state.first_word;
+		}
+		n_nodes += pool_nodes.size();
+	}
+	avg_words = ( n_nodes > 0 ) ? (double)n_words / n_nodes : 0;
+	return solver.get_bound();
+}
+
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0] << " <n_vertices> <density> [widths...]" << endl;
+		return 1;
+	}
+
+	IndepSetInst* inst = random_instance(atoi(argv[1]), atof(argv[2]));
+	vector<int> widths;
+	for( int i = 3; i < argc; i++ ) {
+		widths.push_back(atoi(argv[i]));
+	}
+	if( widths.empty() ) {
+		widths.push_back(100);
+		widths.push_back(1000);
+	}
+
+	MinDegreeOrdering* ordering = new MinDegreeOrdering(inst);
+	IndepSetInst* relabeled = relabel_in_order(inst, ordering);
+
+	IndepSetSolver solver(inst, EXACT_BDD);
+	solver.ordering = ordering;
+	solver.merger = new MinLongestPath(inst, EXACT_BDD);
+
+	IndepSetSolver relabeled_solver(relabeled, EXACT_BDD);
+	relabeled_solver.ordering = new RelabeledOrdering(relabeled);
+	relabeled_solver.merger = new MinLongestPath(relabeled, EXACT_BDD);
+
+	cout << "words per state: " << intset_words_for_bits(inst->graph->n_vertices) << endl;
+	for( int i = 0; i < (int)widths.size(); i++ ) {
+		solver.width = widths[i];
+		solver.merger->width = widths[i];
+		relabeled_solver.width = widths[i];
+		relabeled_solver.merger->width = widths[i];
+
+		for( int relaxed = 1; relaxed >= 0; relaxed-- ) {
+			double seconds, relabeled_seconds, words, relabeled_words;
+			int bound = build_steps(solver, relaxed, seconds, words);
+			int relabeled_bound = build_steps(relabeled_solver, relaxed, relabeled_seconds, relabeled_words);
+
+			printf("width %6d %s: %6d (%8.4fs, %6.2f words) - relabeled %6d (%8.4fs, %6.2f words)\n",
+					widths[i], relaxed ? "relaxation " : "restriction",
+					bound, seconds, words, relabeled_bound, relabeled_seconds, relabeled_words);
+		}
+	}
+
+	delete solver.ordering;
+	delete solver.merger;
+	delete relabeled_solver.ordering;
+	delete relabeled_solver.merger;
+	delete relabeled;
+	return 0;
+}
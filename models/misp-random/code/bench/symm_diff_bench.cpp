@@ -0,0 +1,158 @@
+/*
+ * --------------------------------------------------------
+ * Benchmark: modes of the symmetric difference merger
+ *
+ * Merges a layer of random states down to the maximum width
+ * with each mode of SymmetricDifferenceMerger, reporting the
+ * time taken and the total size of the resulting states
+ * (smaller is a tighter relaxation). The all-pairs mode is
+ * skipped for layers above 1000 nodes, and the incremental
+ * one above 10000 nodes (it keeps all pairs in memory).
+ *
+ * The all-pairs mode merges as the original merger did. The
+ * other modes break ties differently, so relaxations of
+ * small random graphs (min-in-state ordering) are then built
+ * with each mode, and their bounds compared with those of
+ * the all-pairs mode.
+ *
+ * Usage: symm_diff_bench [n_nodes] [n_vertices] [width] [density]
+ * --------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "indepset_solver.hpp"
+#include "bench_instances.hpp"
+
+using namespace std;
+
+
+/**
+ * Bound of a relaxation built with a mode of the merger
+ */
+static int relaxation_bound(IndepSetInst* inst, int width, SymmDiffMode mode) {
+	IndepSetSolver solver(inst, width);
+	solver.ordering = new MinInState(inst);
+	solver.merger = new SymmetricDifferenceMerger(inst, width, mode);
+	IntSet root_state(0, inst->graph->n_vertices-1, true);
+	int bound = solver.generate_relaxation(root_state, 0);
+	delete solver.ordering;
+	delete solver.merger;
+	return bound;
+}
+
+
+int main(int argc, char* argv[]) {
+
+	int n_nodes = (argc > 1) ? atoi(argv[1]) : 500;
+	int n_vertices = (argc > 2) ? atoi(argv[2]) : 300;
+	int width = (argc > 3) ? atoi(argv[3]) : 50;
+	double density = (argc > 4) ? atof(argv[4]) : 0.3;
+
+	// random layer (states are distinct with high probability)
+	srand(0);
+	vector<Node*> layer;
+	IntSet state(0, n_vertices-1, false);
+	NodeTable states;
+	while( (int)layer.size() < n_nodes ) {
+		state.clear();
+		for( int v = 0; v < n_vertices; v++ ) {
+			if( rand() < density * RAND_MAX ) {
+				state.add(v);
+			}
+		}
+		Node* node = new Node(state, rand() % 100);
+		if( states.find(node->state) == NULL ) {
+			states.insert(node);
+			layer.push_back(node);
+		} else {
+			delete node;
+		}
+	}
+
+	const char* mode_names[] = { "all pairs", "incremental", "sketch" };
+	int mode_limits[] = { 1000, 10000, -1 };
+	vector<Node*> reference;
+
+	cout << "layer: " << n_nodes << " nodes - vertices: " << n_vertices << " - width: " << width << endl;
+	for( int mode = SymmDiffAllPairs; mode <= SymmDiffSketch; mode++ ) {
+
+		if( mode_limits[mode] != -1 && n_nodes > mode_limits[mode] ) {
+			printf("%-12s skipped\n", mode_names[mode]);
+			continue;
+		}
+
+		vector<Node*> nodes_layer;
+		for( int i = 0; i < n_nodes; i++ ) {
+			nodes_layer.push_back(new Node(layer[i]->state, layer[i]->longest_path));
+		}
+
+		SymmetricDifferenceMerger merger(NULL, width, (SymmDiffMode)mode);
+		clock_t start = clock();
+		merger.merge_layer(0, nodes_layer);
+		double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+		int n_result = nodes_layer.size();
+		long total_size = 0;
+		for( int i = 0; i < (int)nodes_layer.size(); i++ ) {
+			total_size += nodes_layer[i]->state.get_size();
+		}
+
+		// exact modes must merge the same pairs
+		const char* same = "";
+		if( mode != SymmDiffSketch ) {
+			if( reference.empty() ) {
+				reference = nodes_layer;
+				nodes_layer.clear();
+			} else {
+				same = " - same as all pairs";
+				for( int i = 0; i < (int)nodes_layer.size(); i++ ) {
+					if( i >= (int)reference.size() || !nodes_layer[i]->state.equals_to(reference[i]->state)
+							|| nodes_layer[i]->longest_path != reference[i]->longest_path ) {
+						same = " - DIFFERENT from all pairs";
+					}
+				}
+			}
+		}
+
+		printf("%-12s %10.4fs - nodes: %d - total state size: %ld%s\n",
+				mode_names[mode], seconds, n_result, total_size, same);
+
+		for( int i = 0; i < (int)nodes_layer.size(); i++ ) {
+			delete nodes_layer[i];
+		}
+	}
+
+	// relaxation bounds of random graphs, compared with the all-pairs mode
+	double densities[] = { 0.1, 0.3, 0.5 };
+	int widths[] = { 5, 10, 40 };
+	vector<int> reference_bounds;
+	cout << "relaxations: 60 vertices, densities 0.1/0.3/0.5, widths 5/10/40, 5 graphs each" << endl;
+	for( int mode = SymmDiffAllPairs; mode <= SymmDiffSketch; mode++ ) {
+		long total_bound = 0;
+		int n_tighter = 0, n_looser = 0, n = 0;
+		for( int d = 0; d < 3; d++ ) {
+			for( int seed = 0; seed < 5; seed++ ) {
+				IndepSetInst* inst = random_instance(60, densities[d], seed);
+				for( int w = 0; w < 3; w++, n++ ) {
+					int bound = relaxation_bound(inst, widths[w], (SymmDiffMode)mode);
+					if( mode == SymmDiffAllPairs ) {
+						reference_bounds.push_back(bound);
+					}
+					n_tighter += ( bound < reference_bounds[n] ) ? 1 : 0;
+					n_looser += ( bound > reference_bounds[n] ) ? 1 : 0;
+					total_bound += bound;
+				}
+				delete inst;
+			}
+		}
+		printf("%-12s total bound: %ld - tighter: %d, looser: %d (of %d)\n",
+				mode_names[mode], total_bound, n_tighter, n_looser, n);
+	}
+
+	return 0;
+}
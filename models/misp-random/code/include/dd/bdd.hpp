@@ -31,11 +31,22 @@ struct Node {
 
 	int				relax_ub;
 
+	int				pool_id;		/**< entry in the node pool index (-1 if not in pool) */
+	int				dd_slot;		/**< slot in the materialized diagram (see CompactDDBuilder) */
+
 
 	/**
 	 * Node constructor if one wishes only to create a relaxation
 	 */
-	Node(IntSet &_state, int _longest_path)	: state(_state), longest_path(_longest_path)
+	Node(IntSet &_state, int _longest_path)	: state(_state), longest_path(_longest_path), pool_id(-1), dd_slot(-1)
+	{
+	}
+
+	/**
+	 * Node constructor with given storage for the state words (see NodeArena)
+	 */
+	Node(IntSet &_state, int _longest_path, uint64_t* state_words)
+		: state(_state, state_words), longest_path(_longest_path), pool_id(-1), dd_slot(-1)
 	{
 	}
 };
@@ -58,6 +69,15 @@ struct CompareNodesLongestPath {
 	}
 };
 
+/**
+ * Node comparator by state (lexicographic)
+ */
+struct CompareNodesStateLex {
+	bool operator()(const Node* nodeA, const Node* nodeB) const {
+		return nodeA->state.lex_less(nodeB->state);
+	}
+};
+
 /**
  * Node comparator by state size
  */
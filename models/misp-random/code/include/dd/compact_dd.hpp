@@ -0,0 +1,385 @@
+/*
+ * --------------------------------------------------------
+ * Materialized decision diagram in compact arrays
+ *
+ * Nodes are numbered in the order they are branched, so
+ * the nodes of a layer are contiguous (CSR-like layout,
+ * delimited by layer_start) and arcs always go to nodes
+ * with larger numbers. Zero arcs may skip layers whose
+ * vertex is not in the node state. The last layer holds
+ * the terminal node.
+ *
+ * CompactDDBuilder records the diagram while the solver
+ * builds it. Every node in the pool or in a layer holds a
+ * slot (Node::dd_slot); arcs point to slots, and a slot is
+ * bound to a diagram node when its node is branched.
+ * Merged nodes forward their slot to the node they were
+ * merged into, and slots of removed nodes drop their arcs.
+ * --------------------------------------------------------
+ */
+
+#ifndef COMPACT_DD_HPP_
+#define COMPACT_DD_HPP_
+
+#include <cassert>
+#include <limits>
+#include <vector>
+#include "bdd.hpp"
+#include "util.hpp"
+
+using namespace std;
+
+#define COMPACT_DD_NO_PATH (numeric_limits<int>::min() / 2)	/**< value of unreachable nodes */
+
+
+struct CompactDD {
+
+	vector<int>		layer_start;		/**< nodes of layer l are layer_start[l] .. layer_start[l+1]-1 */
+	vector<int>		layer_vertex;		/**< vertex branched at each layer (-1 for the terminal layer) */
+	vector<int>		zero_child;			/**< child of each node by its zero arc (-1 if none) */
+	vector<int>		one_child;			/**< child of each node by its one arc (-1 if none) */
+	vector<int>		one_weight;			/**< weight of the one arc of each node */
+	int				root_longest_path;	/**< longest path of the root when diagram was built */
+
+	vector<int>		values;				/**< scratch space of the longest path passes */
+	vector<int>		parents;
+
+	/** Constructor */
+	CompactDD() : root_longest_path(0) { layer_start.push_back(0); }
+
+	/** Remove all nodes */
+	void clear();
+
+	/** Number of nodes (the root is node 0) */
+	int get_n_nodes() const { return zero_child.size(); }
+
+	/** Number of layers, including the terminal one */
+	int get_n_layers() const { return layer_vertex.size(); }
+
+	/** Longest path from the root to the terminal with the weights of the diagram */
+	int longest_path();
+
+	/** Same, also giving the vertices of the one arcs of a longest path */
+	int longest_path(vector<int> &solution);
+
+	/**
+	 * Longest paths for several objectives in one pass, starting from zero at the root.
+	 * weights[v*n_objectives + k] is the weight of vertex v in objective k; the longest
+	 * path of objective k is written to lengths[k] (COMPACT_DD_NO_PATH if terminal is unreachable)
+	 */
+	void longest_paths(const int* weights, int n_objectives, int* lengths);
+
+private:
+	int forward_pass(bool keep_parents);
+};
+
+
+struct CompactDDBuilder {
+
+	CompactDD*		dd;					/**< diagram being built */
+	vector<int>		slot_target;		/**< slot each slot was merged into (itself if none, -1 if removed) */
+	vector<int>		slot_node;			/**< diagram node bound to each slot (-1 if not branched yet) */
+	vector<int>		zero_slot;			/**< child slots of each diagram node */
+	vector<int>		one_slot;
+
+	/** Constructor */
+	CompactDDBuilder() : dd(NULL) { }
+
+	/** Start a diagram with a root node */
+	void start(CompactDD* _dd, Node* root);
+
+	/** Give a new slot to a node entering the pool */
+	void add(Node* node);
+
+	/** Node was merged into another one (before it is released) */
+	void merge(Node* node, Node* into);
+
+	/** Node was removed from the diagram (restriction) */
+	void remove(Node* node);
+
+	/** Start a new layer */
+	void begin_layer(int vertex);
+
+	/** Bind the slot of a node of the current layer to a new diagram node (before its arcs are created) */
+	int branch(Node* node, int one_weight);
+
+	/** Set arcs of a diagram node to the slots of its children (NULL if arc does not exist) */
+	void set_arcs(int dd_node, Node* zero, Node* one);
+
+	/** Put nodes left in the pool in the terminal layer and resolve all arcs */
+	void finish(vector<Node*> &terminal_nodes);
+
+private:
+	int find(int slot);
+};
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Remove all nodes
+ */
+inline void CompactDD::clear() {
+	layer_start.assign(1, 0);
+	layer_vertex.clear();
+	zero_child.clear();
+	one_child.clear();
+	one_weight.clear();
+	root_longest_path = 0;
+}
+
+
+/**
+ * Longest path from the root to the terminal
+ */
+inline int CompactDD::longest_path() {
+	return forward_pass(false);
+}
+
+
+/**
+ * Longest path and its vertices
+ */
+inline int CompactDD::longest_path(vector<int> &solution) {
+	int length = forward_pass(true);
+
+	solution.clear();
+	int best = -1;
+	for( int i = layer_start[get_n_layers()-1]; i < get_n_nodes(); i++ ) {
+		if( values[i] != COMPACT_DD_NO_PATH && (best == -1 || values[i] > values[best]) ) {
+			best = i;
+		}
+	}
+
+	// parents hold 2*node for zero arcs and 2*node+1 for one arcs
+	int layer = get_n_layers()-1;
+	for( int i = best; i > 0; i = parents[i] / 2 ) {
+		int parent = parents[i] / 2;
+		while( layer_start[layer] > parent ) {
+			layer--;
+		}
+		if( parents[i] % 2 == 1 ) {
+			solution.push_back(layer_vertex[layer]);
+		}
+	}
+	return length;
+}
+
+
+/**
+ * Longest paths with the arc weights of the diagram (parents are kept if asked)
+ */
+inline int CompactDD::forward_pass(bool keep_parents) {
+	int n_nodes = get_n_nodes();
+	if( n_nodes == 0 ) {
+		return COMPACT_DD_NO_PATH;
+	}
+
+	values.assign(n_nodes, COMPACT_DD_NO_PATH);
+	if( keep_parents ) {
+		parents.assign(n_nodes, -1);
+	}
+	values[0] = root_longest_path;
+
+	for( int i = 0; i < n_nodes; i++ ) {
+		if( values[i] == COMPACT_DD_NO_PATH ) {
+			continue;
+		}
+		int child = zero_child[i];
+		if( child != -1 && values[i] > values[child] ) {
+			values[child] = values[i];
+			if( keep_parents )
+				parents[child] = 2*i;
+		}
+		child = one_child[i];
+		if( child != -1 && values[i] + one_weight[i] > values[child] ) {
+			values[child] = values[i] + one_weight[i];
+			if( keep_parents )
+				parents[child] = 2*i+1;
+		}
+	}
+
+	int length = COMPACT_DD_NO_PATH;
+	for( int i = layer_start[get_n_layers()-1]; i < n_nodes; i++ ) {
+		length = MAX(length, values[i]);
+	}
+	return length;
+}
+
+
+/**
+ * Longest paths for several objectives in one pass. Values of the objectives
+ * are contiguous for each node, so the inner loops run over vectors.
+ */
+inline void CompactDD::longest_paths(const int* weights, int n_objectives, int* lengths) {
+	int n_nodes = get_n_nodes();
+	for( int k = 0; k < n_objectives; k++ ) {
+		lengths[k] = COMPACT_DD_NO_PATH;
+	}
+	if( n_nodes == 0 ) {
+		return;
+	}
+
+	values.assign((size_t)n_nodes * n_objectives, COMPACT_DD_NO_PATH);
+	for( int k = 0; k < n_objectives; k++ ) {
+		values[k] = 0;
+	}
+
+	// all objectives reach the same nodes, so only the first one is checked
+	for( int layer = 0; layer < get_n_layers()-1; layer++ ) {
+		const int* w = weights + (size_t)layer_vertex[layer] * n_objectives;
+		for( int i = layer_start[layer]; i < layer_start[layer+1]; i++ ) {
+			const int* value = &values[(size_t)i * n_objectives];
+			if( value[0] == COMPACT_DD_NO_PATH ) {
+				continue;
+			}
+			if( zero_child[i] != -1 ) {
+				int* child = &values[(size_t)zero_child[i] * n_objectives];
+				for( int k = 0; k < n_objectives; k++ ) {
+					child[k] = MAX(child[k], value[k]);
+				}
+			}
+			if( one_child[i] != -1 ) {
+				int* child = &values[(size_t)one_child[i] * n_objectives];
+				for( int k = 0; k < n_objectives; k++ ) {
+					child[k] = MAX(child[k], value[k] + w[k]);
+				}
+			}
+		}
+	}
+
+	for( int i = layer_start[get_n_layers()-1]; i < n_nodes; i++ ) {
+		const int* value = &values[(size_t)i * n_objectives];
+		for( int k = 0; k < n_objectives; k++ ) {
+			lengths[k] = MAX(lengths[k], value[k]);
+		}
+	}
+}
+
+
+/**
+ * Start a diagram with a root node
+ */
+inline void CompactDDBuilder::start(CompactDD* _dd, Node* root) {
+	dd = _dd;
+	dd->clear();
+	dd->root_longest_path = root->longest_path;
+	slot_target.clear();
+	slot_node.clear();
+	zero_slot.clear();
+	one_slot.clear();
+	add(root);
+}
+
+
+/**
+ * Give a new slot to a node
+ */
+inline void CompactDDBuilder::add(Node* node) {
+	node->dd_slot = slot_target.size();
+	slot_target.push_back(node->dd_slot);
+	slot_node.push_back(-1);
+}
+
+
+/**
+ * Forward slot of a merged node
+ */
+inline void CompactDDBuilder::merge(Node* node, Node* into) {
+	assert( node != into );
+	slot_target[node->dd_slot] = into->dd_slot;
+}
+
+
+/**
+ * Drop arcs to a removed node
+ */
+inline void CompactDDBuilder::remove(Node* node) {
+	slot_target[node->dd_slot] = -1;
+}
+
+
+/**
+ * Start a new layer
+ */
+inline void CompactDDBuilder::begin_layer(int vertex) {
+	if( dd->get_n_layers() > 0 && dd->layer_start[dd->get_n_layers()-1] == dd->get_n_nodes() ) {
+		// previous layer had no nodes
+		dd->layer_vertex.back() = vertex;
+		return;
+	}
+	dd->layer_vertex.push_back(vertex);
+	dd->layer_start.push_back(dd->get_n_nodes());
+}
+
+
+/**
+ * Bind slot of a node to a new diagram node
+ */
+inline int CompactDDBuilder::branch(Node* node, int one_weight) {
+	int dd_node = dd->get_n_nodes();
+	assert( slot_target[node->dd_slot] == node->dd_slot );
+	slot_node[node->dd_slot] = dd_node;
+
+	dd->zero_child.push_back(-1);
+	dd->one_child.push_back(-1);
+	dd->one_weight.push_back(one_weight);
+	dd->layer_start.back() = dd->get_n_nodes();
+	zero_slot.push_back(-1);
+	one_slot.push_back(-1);
+	return dd_node;
+}
+
+
+/**
+ * Set arcs of a diagram node
+ */
+inline void CompactDDBuilder::set_arcs(int dd_node, Node* zero, Node* one) {
+	zero_slot[dd_node] = ( zero != NULL ) ? zero->dd_slot : -1;
+	one_slot[dd_node] = ( one != NULL ) ? one->dd_slot : -1;
+}
+
+
+/**
+ * Put pool nodes in the terminal layer and resolve arcs
+ */
+inline void CompactDDBuilder::finish(vector<Node*> &terminal_nodes) {
+	begin_layer(-1);
+	for( vector<Node*>::iterator node = terminal_nodes.begin(); node != terminal_nodes.end(); ++node ) {
+		branch(*node, 0);
+	}
+
+	for( int i = 0; i < dd->get_n_nodes(); i++ ) {
+		int slot = ( zero_slot[i] != -1 ) ? find(zero_slot[i]) : -1;
+		dd->zero_child[i] = ( slot != -1 ) ? slot_node[slot] : -1;
+		slot = ( one_slot[i] != -1 ) ? find(one_slot[i]) : -1;
+		dd->one_child[i] = ( slot != -1 ) ? slot_node[slot] : -1;
+		assert( dd->zero_child[i] == -1 || dd->zero_child[i] > i );
+		assert( dd->one_child[i] == -1 || dd->one_child[i] > i );
+	}
+}
+
+
+/**
+ * Slot a slot was finally merged into (-1 if it was removed)
+ */
+inline int CompactDDBuilder::find(int slot) {
+	int root = slot;
+	while( root != -1 && slot_target[root] != root ) {
+		root = slot_target[root];
+	}
+	// compress path
+	while( slot != root && slot != -1 ) {
+		int next = slot_target[slot];
+		slot_target[slot] = root;
+		slot = next;
+	}
+	return root;
+}
+
+
+#endif /* COMPACT_DD_HPP_ */
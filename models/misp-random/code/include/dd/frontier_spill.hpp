@@ -0,0 +1,472 @@
+/*
+ * --------------------------------------------------------
+ * Frontier nodes spilled to disk
+ *
+ * Pool nodes that do not fit in memory are written to one
+ * file per bucket. A node goes to the bucket of the element
+ * of its state with the smallest rank: with a static vertex
+ * ordering (rank = position in the ordering), this is the
+ * vertex whose layer will take the node out of the pool, so
+ * only the bucket of the current vertex must be read back.
+ *
+ * Each bucket also keeps the union of its states. Taking the
+ * layer of a vertex streams every bucket whose union contains
+ * it: records with the vertex go to a layer file, which is
+ * then read back in chunks, and the others are written back
+ * to their bucket.
+ *
+ * Records are compact: longest path, then either all words
+ * of the state (dense) or the index and value of its nonzero
+ * words (sparse), whichever is smaller.
+ * --------------------------------------------------------
+ */
+
+#ifndef FRONTIER_SPILL_HPP_
+#define FRONTIER_SPILL_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "bdd.hpp"
+#include "intset.hpp"
+
+using namespace std;
+
+#define FRONTIER_SPILL_DENSE -1		/**< record code of states stored with all their words */
+
+
+/**
+ * Counters of a spill store
+ */
+struct FrontierSpillStats {
+	long	n_spilled;		/**< nodes written to disk */
+	long	n_loaded;		/**< nodes read back into memory */
+	long	n_chunks;		/**< chunks of layers read back */
+	long	n_rewritten;	/**< records written back to their bucket while streaming */
+	long	bytes_written;
+	long	bytes_read;
+
+	FrontierSpillStats() : n_spilled(0), n_loaded(0), n_chunks(0), n_rewritten(0), bytes_written(0), bytes_read(0) { }
+};
+
+
+struct FrontierSpill {
+
+	int						n_vertices;
+	int						n_words;		/**< words of the states */
+	string					parent_dir;		/**< where the directory of bucket files is created */
+	string					dir;			/**< directory of bucket files (empty until first spill) */
+
+	vector<int>				rank;			/**< nodes go to the bucket of their element of smallest rank */
+	vector<long>			bucket_nodes;	/**< nodes in each bucket file */
+	vector<IntSet>			bucket_union;	/**< union of the states of each bucket */
+	long					n_nodes;		/**< nodes on disk (in buckets and layer file) */
+
+	FILE*					layer_file;		/**< nodes of the layer being read back (NULL if none) */
+	long					layer_nodes;	/**< nodes left in the layer file */
+
+	IntSet					record_state;	/**< state of the record being read */
+	vector<uint64_t>		record_words;	/**< scratch space of record encoding */
+
+	FrontierSpillStats		stats;
+
+	/** Constructor */
+	FrontierSpill();
+
+	/** Destructor: removes all files */
+	~FrontierSpill();
+
+	/** Set number of vertices and directory of the files (all nodes are discarded) */
+	void resize(int _n_vertices, const char* _parent_dir);
+
+	/** Discard all nodes on disk, with buckets given by vertex index */
+	void clear();
+
+	/** Discard all nodes on disk and set the rank of each vertex */
+	void clear(vector<int> &_rank);
+
+	/** Bucket of a (non-empty) state */
+	int bucket_of(IntSet &state);
+
+	/** Append nodes to a bucket (nodes are not deleted) */
+	void write(int bucket, vector<Node*>::iterator begin, vector<Node*>::iterator end);
+
+	/** Move nodes whose state contains vertex to the layer file, returning their number */
+	long take_layer(int vertex);
+
+	/** Call f(state, longest_path) for up to max_nodes nodes of the layer file, returning their number */
+	template<class F>
+	int read_layer(int max_nodes, F f);
+
+	/** Check if no node is on disk */
+	bool empty() const { return n_nodes == 0; }
+
+	/** Print counters */
+	void print_stats(ostream &os);
+
+private:
+	string bucket_path(int bucket);
+	string layer_path() { return dir + "/layer.bin"; }
+	FILE* open_file(const string &path, const char* mode);
+	long write_record(FILE* file, IntSet &state, int longest_path);
+	long read_record(FILE* file, int &longest_path);
+	void remove_files();
+};
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Constructor
+ */
+inline FrontierSpill::FrontierSpill() : n_vertices(0), n_words(0), n_nodes(0), layer_file(NULL), layer_nodes(0) {
+}
+
+
+/**
+ * Destructor
+ */
+inline FrontierSpill::~FrontierSpill() {
+	remove_files();
+	if( !dir.empty() ) {
+		rmdir(dir.c_str());
+	}
+}
+
+
+/**
+ * Set number of vertices and directory of the files
+ */
+inline void FrontierSpill::resize(int _n_vertices, const char* _parent_dir) {
+	remove_files();
+	n_vertices = _n_vertices;
+	n_words = intset_words_for_bits(n_vertices);
+	parent_dir = _parent_dir;
+
+	bucket_nodes.assign(n_vertices, 0);
+	bucket_union.assign(n_vertices, IntSet(0, n_vertices-1, false));
+	record_state.resize(0, n_vertices-1, false);
+	record_words.resize(2*n_words);
+	clear();
+}
+
+
+/**
+ * Discard all nodes, with buckets given by vertex index
+ */
+inline void FrontierSpill::clear() {
+	rank.resize(n_vertices);
+	for( int v = 0; v < n_vertices; v++ ) {
+		rank[v] = v;
+	}
+	remove_files();
+}
+
+
+/**
+ * Discard all nodes and set the rank of each vertex
+ */
+inline void FrontierSpill::clear(vector<int> &_rank) {
+	assert( (int)_rank.size() == n_vertices );
+	rank = _rank;
+	remove_files();
+}
+
+
+/**
+ * Bucket of a state
+ */
+inline int FrontierSpill::bucket_of(IntSet &state) {
+	int bucket = state.get_first();
+	assert( bucket != state.get_end() );
+	for( int v = state.get_next(bucket); v != state.get_end(); v = state.get_next(v) ) {
+		if( rank[v] < rank[bucket] ) {
+			bucket = v;
+		}
+	}
+	return bucket;
+}
+
+
+/**
+ * Append nodes to a bucket
+ */
+inline void FrontierSpill::write(int bucket, vector<Node*>::iterator begin, vector<Node*>::iterator end) {
+	if( dir.empty() ) {
+		string pattern = parent_dir + "/misp_spill_XXXXXX";
+		vector<char> name(pattern.begin(), pattern.end());
+		name.push_back('\0');
+		if( mkdtemp(name.data()) == NULL ) {
+			cout << "ERROR - could not create spill directory in " << parent_dir << endl;
+			exit(1);
+		}
+		dir = name.data();
+	}
+
+	FILE* file = open_file(bucket_path(bucket), "ab");
+	for( vector<Node*>::iterator node = begin; node != end; ++node ) {
+		stats.bytes_written += write_record(file, (*node)->state, (*node)->longest_path);
+		bucket_union[bucket].union_with((*node)->state);
+		bucket_nodes[bucket]++;
+		n_nodes++;
+		stats.n_spilled++;
+	}
+	fclose(file);
+}
+
+
+/**
+ * Move nodes with vertex from the buckets that may hold them to the layer file
+ */
+inline long FrontierSpill::take_layer(int vertex) {
+	assert( layer_file == NULL );
+
+	// all records of the bucket of vertex contain it: the file becomes the layer file
+	if( bucket_nodes[vertex] > 0 ) {
+		if( rename(bucket_path(vertex).c_str(), layer_path().c_str()) != 0 ) {
+			cout << "ERROR - could not rename spill file " << bucket_path(vertex) << endl;
+			exit(1);
+		}
+		layer_file = open_file(layer_path(), "r+b");
+		fseek(layer_file, 0, SEEK_END);
+		layer_nodes = bucket_nodes[vertex];
+		bucket_nodes[vertex] = 0;
+		bucket_union[vertex].clear();
+	}
+
+	for( int bucket = 0; bucket < n_vertices && n_nodes > layer_nodes; bucket++ ) {
+		if( bucket_nodes[bucket] == 0 || !bucket_union[bucket].contains(vertex) ) {
+			continue;
+		}
+		if( layer_file == NULL ) {
+			layer_file = open_file(layer_path(), "w+b");
+		}
+
+		// records of other vertices go to a new file of the bucket
+		string path = bucket_path(bucket);
+		string old_path = path + ".old";
+		if( rename(path.c_str(), old_path.c_str()) != 0 ) {
+			cout << "ERROR - could not rename spill file " << path << endl;
+			exit(1);
+		}
+		FILE* in = open_file(old_path, "rb");
+		FILE* out = NULL;
+
+		n_nodes -= bucket_nodes[bucket];
+		bucket_nodes[bucket] = 0;
+		bucket_union[bucket].clear();
+
+		int longest_path;
+		long bytes;
+		long n_moved = 0;
+		while( (bytes = read_record(in, longest_path)) > 0 ) {
+			stats.bytes_read += bytes;
+
+			if( record_state.contains(vertex) ) {
+				stats.bytes_written += write_record(layer_file, record_state, longest_path);
+				n_moved++;
+
+			} else {
+				if( out == NULL ) {
+					out = open_file(path, "wb");
+				}
+				stats.bytes_written += write_record(out, record_state, longest_path);
+				bucket_union[bucket].union_with(record_state);
+				bucket_nodes[bucket]++;
+				stats.n_rewritten++;
+			}
+		}
+		n_nodes += bucket_nodes[bucket] + n_moved;
+		layer_nodes += n_moved;
+
+		fclose(in);
+		if( out != NULL ) {
+			fclose(out);
+		}
+		unlink(old_path.c_str());
+	}
+
+	if( layer_file != NULL ) {
+		rewind(layer_file);
+	}
+	return layer_nodes;
+}
+
+
+/**
+ * Read back a chunk of the layer file
+ */
+template<class F>
+inline int FrontierSpill::read_layer(int max_nodes, F f) {
+	int n_read = 0;
+	int longest_path;
+	while( layer_nodes > 0 && n_read < max_nodes ) {
+		long bytes = read_record(layer_file, longest_path);
+		assert( bytes > 0 );
+		stats.bytes_read += bytes;
+		stats.n_loaded++;
+		layer_nodes--;
+		n_nodes--;
+		n_read++;
+		f(record_state, longest_path);
+	}
+
+	if( n_read > 0 ) {
+		stats.n_chunks++;
+	}
+	if( layer_nodes == 0 && layer_file != NULL ) {
+		fclose(layer_file);
+		layer_file = NULL;
+		unlink(layer_path().c_str());
+	}
+	return n_read;
+}
+
+
+/**
+ * Print counters
+ */
+inline void FrontierSpill::print_stats(ostream &os) {
+	os << "\tnodes spilled: " << stats.n_spilled << endl;
+	os << "\tnodes loaded: " << stats.n_loaded << endl;
+	os << "\tlayer chunks loaded: " << stats.n_chunks << endl;
+	os << "\trecords rewritten: " << stats.n_rewritten << endl;
+	os << "\tbytes written: " << stats.bytes_written << endl;
+	os << "\tbytes read: " << stats.bytes_read << endl;
+}
+
+
+/**
+ * File of a bucket
+ */
+inline string FrontierSpill::bucket_path(int bucket) {
+	char name[32];
+	sprintf(name, "/bucket_%d.bin", bucket);
+	return dir + name;
+}
+
+
+/**
+ * Open a file, exiting if it fails
+ */
+inline FILE* FrontierSpill::open_file(const string &path, const char* mode) {
+	FILE* file = fopen(path.c_str(), mode);
+	if( file == NULL ) {
+		cout << "ERROR - could not open spill file " << path << endl;
+		exit(1);
+	}
+	return file;
+}
+
+
+/**
+ * Write a record, returning its size in bytes
+ */
+inline long FrontierSpill::write_record(FILE* file, IntSet &state, int longest_path) {
+	assert( state.n_words == n_words );
+
+	int n_nonzero = 0;
+	for( int i = state.first_word; i < n_words; i++ ) {
+		if( state.words[i] != 0 ) {
+			record_words[2*n_nonzero] = i;
+			record_words[2*n_nonzero+1] = state.words[i];
+			n_nonzero++;
+		}
+	}
+
+	int32_t header[2];
+	header[0] = longest_path;
+	long bytes = sizeof(header);
+	if( 2*n_nonzero < n_words ) {
+		header[1] = n_nonzero;
+		bytes += sizeof(uint64_t)*2*n_nonzero;
+		fwrite(header, sizeof(header), 1, file);
+		fwrite(record_words.data(), sizeof(uint64_t), 2*n_nonzero, file);
+	} else {
+		header[1] = FRONTIER_SPILL_DENSE;
+		bytes += sizeof(uint64_t)*n_words;
+		fwrite(header, sizeof(header), 1, file);
+		memset(record_words.data(), 0, sizeof(uint64_t)*state.first_word);
+		fwrite(record_words.data(), sizeof(uint64_t), state.first_word, file);
+		fwrite(state.words + state.first_word, sizeof(uint64_t), n_words - state.first_word, file);
+	}
+	if( ferror(file) ) {
+		cout << "ERROR - could not write spill file in " << dir << endl;
+		exit(1);
+	}
+	return bytes;
+}
+
+
+/**
+ * Read a record into record_state, returning its size in bytes (0 at end of file)
+ */
+inline long FrontierSpill::read_record(FILE* file, int &longest_path) {
+	int32_t header[2];
+	if( fread(header, sizeof(header), 1, file) != 1 ) {
+		return 0;
+	}
+	longest_path = header[0];
+	long bytes = sizeof(header);
+
+	if( header[1] == FRONTIER_SPILL_DENSE ) {
+		bytes += sizeof(uint64_t)*n_words;
+		record_state.first_word = 0;
+		if( fread(record_state.words, sizeof(uint64_t), n_words, file) != (size_t)n_words ) {
+			cout << "ERROR - truncated spill file in " << dir << endl;
+			exit(1);
+		}
+	} else {
+		int n_nonzero = header[1];
+		bytes += sizeof(uint64_t)*2*n_nonzero;
+		if( fread(record_words.data(), sizeof(uint64_t), 2*n_nonzero, file) != (size_t)2*n_nonzero ) {
+			cout << "ERROR - truncated spill file in " << dir << endl;
+			exit(1);
+		}
+		record_state.clear();
+		for( int j = 0; j < n_nonzero; j++ ) {
+			record_state.words[record_words[2*j]] = record_words[2*j+1];
+		}
+	}
+	record_state.size = NOT_COMPUTED;
+	return bytes;
+}
+
+
+/**
+ * Remove files of all buckets
+ */
+inline void FrontierSpill::remove_files() {
+	if( layer_file != NULL ) {
+		fclose(layer_file);
+		layer_file = NULL;
+		unlink(layer_path().c_str());
+	}
+	layer_nodes = 0;
+	if( !dir.empty() ) {
+		for( int b = 0; b < n_vertices; b++ ) {
+			if( bucket_nodes[b] > 0 ) {
+				unlink(bucket_path(b).c_str());
+			}
+		}
+	}
+	for( int b = 0; b < (int)bucket_nodes.size(); b++ ) {
+		if( bucket_nodes[b] > 0 ) {
+			bucket_nodes[b] = 0;
+			bucket_union[b].clear();
+		}
+	}
+	n_nodes = 0;
+}
+
+
+#endif /* FRONTIER_SPILL_HPP_ */
@@ -6,18 +6,23 @@
  *
  * Simple graph structure that assumes that
  * arcs/nodes are not removed once inserted.
- * It keeps a redundant representation as an
- * adjacent matrix and list for fast iteration
- * and adjacency check.
+ * Neighbors are stored in compressed sparse rows
+ * (sorted, each vertex being adjacent to itself).
+ * An adjacent matrix for constant time adjacency
+ * checks is only built on request.
  * -------------------------------------------------
  */
 
 #ifndef GRAPH_HPP_
 #define GRAPH_HPP_
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <vector>
 
+#include "graph_reader.hpp"
+
 using namespace std;
 
 /**
@@ -25,27 +30,43 @@ using namespace std;
  */
 struct Graph_BDD {
 
-    bool**                      adj_m;              /**< adjacent matrix */
-    vector< vector<int> >       adj_list;           /**< adjacent list */
+    bool**                      adj_m;              /**< adjacent matrix (NULL until build_adj_matrix) */
+    vector<int>                 adj_start;          /**< neighbors of v are adj_vertices[adj_start[v] .. adj_start[v+1]-1] */
+    vector<int>                 adj_vertices;       /**< neighbors of all vertices, sorted by vertex */
 
     int                         n_vertices;         /**< |V| */
     int                         n_edges;            /**< |E| */
 
 
-    /** Set two vertices as adjacents */
-    void set_adj(int i, int j);
+    /** Build graph from a list of edges (in any direction, repetitions and loops allowed) */
+    void build(int _n_vertices, const vector< pair<int,int> > &edges);
+
+    /** Build the adjacent matrix from the neighbor lists */
+    void build_adj_matrix();
 
     /** Check if two vertices are adjancent */
     bool is_adj(int i, int j);
 
+    /** Number of neighbors of a vertex (itself included) */
+    int n_neighbors(int v) const { return adj_start[v+1] - adj_start[v]; }
+
+    /** First neighbor of a vertex */
+    const int* neighbors_begin(int v) const { return adj_vertices.data() + adj_start[v]; }
+
+    /** Position after last neighbor of a vertex */
+    const int* neighbors_end(int v) const { return adj_vertices.data() + adj_start[v+1]; }
+
     /** Empty constructor */
     Graph_BDD();
 
+    /** Destructor */
+    ~Graph_BDD();
+
     /** Create an isomorphic graph according to a vertex mapping */
     Graph_BDD(Graph_BDD* graph, vector<int>& mapping);
 
-    /** Read graph from a DIMACS format */
-    void read_dimacs(const char* filename);
+    /** Read graph from a DIMACS, edge list or METIS file (see graph_reader.hpp) */
+    void read_dimacs(const char* filename, GraphFormat format = GRAPH_FORMAT_AUTO);
 
     /** Export to GML format */
     void export_to_gml(const char* output);
@@ -61,39 +82,141 @@ struct Graph_BDD {
 /**
  * Empty constructor
  */
-inline Graph_BDD::Graph_BDD() : n_vertices(0), n_edges(0) {
+inline Graph_BDD::Graph_BDD() : adj_m(NULL), n_vertices(0), n_edges(0) {
+    adj_start.push_back(0);
+}
+
 
+/**
+ * Destructor
+ */
+inline Graph_BDD::~Graph_BDD() {
+    if( adj_m != NULL ) {
+        for( int i = 0; i < n_vertices; i++ ) {
+            delete[] adj_m[i];
+        }
+        delete[] adj_m;
+    }
 }
 
 
 /**
- * Check if two vertices are adjacent
+ * Build graph from a list of edges. Arcs are sorted by head and then by tail
+ * with two counting sorts, so rows come out sorted in O(|V| + |E|).
  */
-inline bool Graph_BDD::is_adj(int i, int j) {
-    assert(i >= 0);
-    assert(j >= 0);
-    assert(i < n_vertices);
-    assert(j < n_vertices);
-    return adj_m[i][j];
+inline void Graph_BDD::build(int _n_vertices, const vector< pair<int,int> > &edges) {
+    assert( adj_m == NULL );
+    n_vertices = _n_vertices;
+
+    // arcs in both directions, and a vertex is adjacent to itself
+    vector<int> tails, heads;
+    tails.reserve(2*edges.size() + n_vertices);
+    heads.reserve(2*edges.size() + n_vertices);
+    for( int v = 0; v < n_vertices; v++ ) {
+        tails.push_back(v);
+        heads.push_back(v);
+    }
+    for( int e = 0; e < (int)edges.size(); e++ ) {
+        assert( edges[e].first >= 0 && edges[e].first < n_vertices );
+        assert( edges[e].second >= 0 && edges[e].second < n_vertices );
+        if( edges[e].first != edges[e].second ) {
+            tails.push_back(edges[e].first);
+            heads.push_back(edges[e].second);
+            tails.push_back(edges[e].second);
+            heads.push_back(edges[e].first);
+        }
+    }
+    int n_arcs = tails.size();
+
+    // 1. order arcs by head
+    vector<int> start(n_vertices+1, 0);
+    for( int a = 0; a < n_arcs; a++ ) {
+        start[heads[a]+1]++;
+    }
+    for( int v = 0; v < n_vertices; v++ ) {
+        start[v+1] += start[v];
+    }
+    vector<int> by_head(n_arcs);
+    for( int a = 0; a < n_arcs; a++ ) {
+        by_head[start[heads[a]]++] = a;
+    }
+
+    // 2. stable order by tail: rows are sorted
+    start.assign(n_vertices+1, 0);
+    for( int a = 0; a < n_arcs; a++ ) {
+        start[tails[a]+1]++;
+    }
+    for( int v = 0; v < n_vertices; v++ ) {
+        start[v+1] += start[v];
+    }
+    adj_vertices.resize(n_arcs);
+    for( int k = 0; k < n_arcs; k++ ) {
+        int a = by_head[k];
+        adj_vertices[start[tails[a]]++] = heads[a];
+    }
+
+    // 3. remove repeated arcs (start[v] is now the end of row v)
+    adj_start.assign(n_vertices+1, 0);
+    int n_kept = 0;
+    int row_begin = 0;
+    for( int v = 0; v < n_vertices; v++ ) {
+        int row_end = start[v];
+        for( int k = row_begin; k < row_end; k++ ) {
+            if( k == row_begin || adj_vertices[k] != adj_vertices[k-1] ) {
+                adj_vertices[n_kept++] = adj_vertices[k];
+            }
+        }
+        row_begin = row_end;
+        adj_start[v+1] = n_kept;
+    }
+    adj_vertices.resize(n_kept);
+    adj_vertices.shrink_to_fit();
+
+    n_edges = (n_kept - n_vertices) / 2;
 }
 
 
 /**
- * Set two vertices as adjacent
+ * Read graph from a DIMACS, edge list or METIS file: the mapped file is parsed
+ * into a list of edges and the neighbor lists are built from it
  */
-inline void Graph_BDD::set_adj(int i, int j) {
+inline void Graph_BDD::read_dimacs(const char* filename, GraphFormat format) {
+    GraphFileEdges graph_file;
+    read_graph_file(filename, graph_file, format);
+    build(graph_file.n_vertices, graph_file.edges);
+}
+
+
+/**
+ * Build the adjacent matrix from the neighbor lists
+ */
+inline void Graph_BDD::build_adj_matrix() {
+    if( adj_m != NULL ) {
+        return;
+    }
+    adj_m = new bool*[n_vertices];
+    for( int i = 0; i < n_vertices; i++ ) {
+        adj_m[i] = new bool[n_vertices];
+        memset(adj_m[i], false, sizeof(bool)*n_vertices);
+        for( const int* j = neighbors_begin(i); j != neighbors_end(i); ++j ) {
+            adj_m[i][*j] = true;
+        }
+    }
+}
+
+
+/**
+ * Check if two vertices are adjacent
+ */
+inline bool Graph_BDD::is_adj(int i, int j) {
     assert(i >= 0);
     assert(j >= 0);
     assert(i < n_vertices);
     assert(j < n_vertices);
-
-    // check if already adjacent
-    if( adj_m[i][j] )
-        return;
-
-    // add to adjacent matrix and list
-    adj_m[i][j] = true;
-    adj_list[i].push_back(j);
+    if( adj_m != NULL ) {
+        return adj_m[i][j];
+    }
+    return binary_search(neighbors_begin(i), neighbors_end(i), j);
 }
 
 
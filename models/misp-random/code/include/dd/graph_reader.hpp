@@ -0,0 +1,390 @@
+/*
+ * -------------------------------------------------
+ * Graph file reader
+ *
+ * Reads graphs in DIMACS ("p edge n m" and "e u v"
+ * lines), edge list ("n m" header followed by "u v"
+ * lines) and METIS (header followed by one line of
+ * neighbors per vertex) formats, with 1-based vertices
+ * and optional integer edge weights.
+ *
+ * The file is mapped in memory and parsed in place,
+ * without tokenizing streams. Large files are split in
+ * chunks at line boundaries that are parsed by several
+ * threads, and the edges of the chunks are concatenated
+ * in file order.
+ * -------------------------------------------------
+ */
+
+#ifndef GRAPH_READER_HPP_
+#define GRAPH_READER_HPP_
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+/**
+ * Graph file formats
+ */
+enum GraphFormat {
+    GRAPH_FORMAT_AUTO,          /**< METIS for .graph/.metis files, DIMACS if the file starts with 'c' or 'p', edge list otherwise */
+    GRAPH_FORMAT_DIMACS,
+    GRAPH_FORMAT_EDGE_LIST,
+    GRAPH_FORMAT_METIS
+};
+
+
+/**
+ * Edges read from a graph file
+ */
+struct GraphFileEdges {
+
+    int                         n_vertices;         /**< |V| from the header */
+    int                         n_edges;            /**< |E| from the header */
+    vector< pair<int,int> >     edges;              /**< edges in file order (0-based vertices) */
+    vector<int>                 weights;            /**< weight of each edge (empty if the file has none) */
+
+    /** Empty constructor */
+    GraphFileEdges() : n_vertices(0), n_edges(0) { }
+};
+
+
+/**
+ * Read the edges of a graph file, parsing with n_threads threads (0: one per core)
+ */
+void read_graph_file(const char* filename, GraphFileEdges &graph_file, GraphFormat format = GRAPH_FORMAT_AUTO, int n_threads = 0);
+
+
+/**
+ * ----------------------------------------------
+ * Inline implementations
+ * ----------------------------------------------
+ */
+
+namespace graph_reader {
+
+/** Files smaller than this are parsed by a single thread */
+const size_t MIN_CHUNK_BYTES = (size_t)1 << 22;
+
+
+/**
+ * Edges of a chunk of a file
+ */
+struct Chunk {
+    const char*                 begin;
+    const char*                 end;
+    vector< pair<int,int> >     edges;
+    vector<int>                 weights;
+    int                         n_lines;            /**< vertex lines of a METIS chunk */
+    bool                        weighted;
+    bool                        error;
+};
+
+
+/**
+ * Skip spaces and tabs (not line ends)
+ */
+inline const char* skip_blanks(const char* p, const char* end) {
+    while( p != end && (*p == ' ' || *p == '\t' || *p == '\r') ) {
+        ++p;
+    }
+    return p;
+}
+
+
+/**
+ * Position after the end of the current line
+ */
+inline const char* next_line(const char* p, const char* end) {
+    const char* eol = (const char*)memchr(p, '\n', end - p);
+    return ( eol == NULL ) ? end : eol + 1;
+}
+
+
+/**
+ * Parse an integer at p (after blanks); returns false if there is none before the end of the line
+ */
+inline bool parse_int(const char* &p, const char* end, long &value) {
+    p = skip_blanks(p, end);
+    bool negative = false;
+    if( p != end && (*p == '-' || *p == '+') ) {
+        negative = ( *p == '-' );
+        ++p;
+    }
+    if( p == end || *p < '0' || *p > '9' ) {
+        return false;
+    }
+    long v = 0;
+    while( p != end && *p >= '0' && *p <= '9' ) {
+        v = 10*v + (*p - '0');
+        ++p;
+    }
+    value = negative ? -v : v;
+    return true;
+}
+
+
+/**
+ * Parse the edge lines of a DIMACS or edge list chunk
+ */
+inline void parse_edge_lines(Chunk &chunk, GraphFormat format, int n_vertices) {
+    const char* end = chunk.end;
+    for( const char* line = chunk.begin; line != end && !chunk.error; line = next_line(line, end) ) {
+        const char* p = skip_blanks(line, end);
+        if( p == end || *p == '\n' ) {
+            continue;
+        }
+        if( format == GRAPH_FORMAT_DIMACS ) {
+            if( *p != 'e' ) {
+                continue;
+            }
+            ++p;
+        } else if( *p == '#' || *p == '%' ) {
+            continue;
+        }
+
+        long u, v, w;
+        if( !parse_int(p, end, u) || !parse_int(p, end, v) || u < 1 || v < 1 || u > n_vertices || v > n_vertices ) {
+            chunk.error = true;
+            break;
+        }
+        chunk.edges.push_back(pair<int,int>(u-1, v-1));
+        if( parse_int(p, end, w) ) {
+            if( !chunk.weighted ) {
+                chunk.weights.resize(chunk.edges.size() - 1, 1);
+                chunk.weighted = true;
+            }
+            chunk.weights.push_back(w);
+        } else if( chunk.weighted ) {
+            chunk.weights.push_back(1);
+        }
+    }
+}
+
+
+/**
+ * Parse the vertex lines of a METIS chunk (vertices are numbered from the start
+ * of the chunk until the offsets of the chunks are known)
+ */
+inline void parse_metis_lines(Chunk &chunk, int n_vertices, bool vertex_sizes, int n_vertex_weights, bool edge_weights) {
+    const char* end = chunk.end;
+    chunk.n_lines = 0;
+    chunk.weighted = edge_weights;
+    for( const char* line = chunk.begin; line != end && !chunk.error; line = next_line(line, end) ) {
+        const char* p = skip_blanks(line, end);
+        if( p != end && *p == '%' ) {
+            continue;
+        }
+        int u = chunk.n_lines++;
+
+        long value;
+        if( vertex_sizes ) {
+            parse_int(p, end, value);
+        }
+        for( int k = 0; k < n_vertex_weights; k++ ) {
+            parse_int(p, end, value);
+        }
+        long v, w = 1;
+        while( parse_int(p, end, v) ) {
+            if( v < 1 || v > n_vertices || (edge_weights && !parse_int(p, end, w)) ) {
+                chunk.error = true;
+                break;
+            }
+            // each edge is listed from both ends: the duplicates are removed with the chunk offsets
+            chunk.edges.push_back(pair<int,int>(u, v-1));
+            if( edge_weights ) {
+                chunk.weights.push_back(w);
+            }
+        }
+    }
+}
+
+
+/**
+ * Split [begin, end) in chunks at line boundaries
+ */
+inline void split_chunks(const char* begin, const char* end, int n_threads, vector<Chunk> &chunks) {
+    size_t size = end - begin;
+    int n_chunks = (int)(size / MIN_CHUNK_BYTES);
+    n_chunks = ( n_chunks < 1 ) ? 1 : ( n_chunks > n_threads ? n_threads : n_chunks );
+    chunks.resize(n_chunks);
+    const char* p = begin;
+    for( int c = 0; c < n_chunks; c++ ) {
+        chunks[c].begin = p;
+        const char* q = ( c == n_chunks-1 ) ? end : begin + (size * (c+1)) / n_chunks;
+        if( q < p ) {
+            q = p;
+        }
+        if( q != end && q != begin && *(q-1) != '\n' ) {
+            q = next_line(q, end);
+        }
+        chunks[c].end = q;
+        chunks[c].n_lines = 0;
+        chunks[c].weighted = false;
+        chunks[c].error = false;
+        p = q;
+    }
+}
+
+} // namespace graph_reader
+
+
+/**
+ * Read the edges of a graph file
+ */
+inline void read_graph_file(const char* filename, GraphFileEdges &graph_file, GraphFormat format, int n_threads) {
+    using namespace graph_reader;
+
+    int fd = open(filename, O_RDONLY);
+    struct stat file_stat;
+    if( fd == -1 || fstat(fd, &file_stat) == -1 ) {
+        cout << "ERROR - could not open " << filename << endl;
+        exit(1);
+    }
+    size_t size = file_stat.st_size;
+    const char* begin = NULL;
+    if( size > 0 ) {
+        void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if( mapped == MAP_FAILED ) {
+            cout << "ERROR - could not map " << filename << endl;
+            exit(1);
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        begin = (const char*)mapped;
+    }
+    const char* end = begin + size;
+
+    if( format == GRAPH_FORMAT_AUTO ) {
+        const char* ext = strrchr(filename, '.');
+        const char* p = skip_blanks(begin, end);
+        if( ext != NULL && (strcmp(ext, ".graph") == 0 || strcmp(ext, ".metis") == 0) ) {
+            format = GRAPH_FORMAT_METIS;
+        } else if( p != end && (*p == 'c' || *p == 'p') ) {
+            format = GRAPH_FORMAT_DIMACS;
+        } else {
+            format = GRAPH_FORMAT_EDGE_LIST;
+        }
+    }
+
+    // header: "p <type> n m" in DIMACS, first line that is not a comment otherwise
+    long n = -1, m = -1, fmt = 0, n_vertex_weights = 0;
+    const char* body = begin;
+    while( body != end && n == -1 ) {
+        const char* p = skip_blanks(body, end);
+        body = next_line(body, end);
+        if( format == GRAPH_FORMAT_DIMACS ) {
+            if( p == end || *p != 'p' ) {
+                continue;
+            }
+            ++p;
+            p = skip_blanks(p, end);
+            while( p != end && *p != ' ' && *p != '\t' && *p != '\n' ) {
+                ++p;
+            }
+        } else if( p == end || *p == '%' || *p == '#' || *p == '\n' ) {
+            continue;
+        }
+        if( !parse_int(p, end, n) || !parse_int(p, end, m) || n < 0 || m < 0 ) {
+            cout << "ERROR - invalid header in " << filename << endl;
+            exit(1);
+        }
+        if( format == GRAPH_FORMAT_METIS && parse_int(p, end, fmt) ) {
+            parse_int(p, end, n_vertex_weights);
+            if( fmt % 100 >= 10 && n_vertex_weights == 0 ) {
+                n_vertex_weights = 1;
+            }
+        }
+    }
+    if( n == -1 ) {
+        cout << "ERROR - no header in " << filename << endl;
+        exit(1);
+    }
+
+    // parse chunks in parallel
+    if( n_threads <= 0 ) {
+        n_threads = thread::hardware_concurrency();
+        n_threads = ( n_threads <= 0 ) ? 1 : n_threads;
+    }
+    vector<Chunk> chunks;
+    split_chunks(body, end, n_threads, chunks);
+
+    auto parse = [&](int c) {
+        if( format == GRAPH_FORMAT_METIS ) {
+            parse_metis_lines(chunks[c], n, fmt >= 100, fmt % 100 >= 10 ? n_vertex_weights : 0, fmt % 10 == 1);
+        } else {
+            parse_edge_lines(chunks[c], format, n);
+        }
+    };
+    vector<thread> threads;
+    for( int c = 1; c < (int)chunks.size(); c++ ) {
+        threads.push_back(thread(parse, c));
+    }
+    parse(0);
+    for( int t = 0; t < (int)threads.size(); t++ ) {
+        threads[t].join();
+    }
+
+    // concatenate in file order
+    bool weighted = false;
+    size_t n_parsed = 0;
+    for( int c = 0; c < (int)chunks.size(); c++ ) {
+        if( chunks[c].error ) {
+            cout << "ERROR - invalid edge in " << filename << endl;
+            exit(1);
+        }
+        weighted = weighted || chunks[c].weighted;
+        n_parsed += chunks[c].edges.size();
+    }
+
+    graph_file.n_vertices = n;
+    graph_file.n_edges = m;
+    graph_file.edges.clear();
+    graph_file.weights.clear();
+    graph_file.edges.reserve(format == GRAPH_FORMAT_METIS ? n_parsed/2 : n_parsed);
+    if( weighted ) {
+        graph_file.weights.reserve(graph_file.edges.capacity());
+    }
+
+    int first_vertex = 0;
+    for( int c = 0; c < (int)chunks.size(); c++ ) {
+        Chunk &chunk = chunks[c];
+        for( size_t e = 0; e < chunk.edges.size(); e++ ) {
+            pair<int,int> edge = chunk.edges[e];
+            if( format == GRAPH_FORMAT_METIS ) {
+                edge.first += first_vertex;
+                if( edge.first > n-1 ) {
+                    cout << "ERROR - more vertex lines than vertices in " << filename << endl;
+                    exit(1);
+                }
+                if( edge.first >= edge.second ) {
+                    continue;
+                }
+            }
+            graph_file.edges.push_back(edge);
+            if( weighted ) {
+                graph_file.weights.push_back(chunk.weighted ? chunk.weights[e] : 1);
+            }
+        }
+        first_vertex += chunk.n_lines;
+        vector< pair<int,int> >().swap(chunk.edges);
+        vector<int>().swap(chunk.weights);
+    }
+
+    if( size > 0 ) {
+        munmap((void*)begin, size);
+    }
+    close(fd);
+}
+
+
+#endif
@@ -0,0 +1,317 @@
+/*
+ * --------------------------------------------------------
+ * Number of pool nodes whose state contains each vertex
+ *
+ * States added or removed are not applied vertex by vertex.
+ * They are accumulated word by word into bit-sliced counters
+ * (plane k holds bit k of the pending count of every vertex)
+ * with a ripple carry over the planes, and the net change of
+ * each vertex is applied when counters are read.
+ *
+ * Vertices with a positive count are kept in a bucket queue
+ * indexed by count. Each bucket is a min-heap of vertices,
+ * so the vertex with the smallest count (ties broken by
+ * smallest index) is found without scanning all vertices.
+ * Heaps are cleaned lazily: an entry is valid only while
+ * the count of its vertex equals the bucket index.
+ * --------------------------------------------------------
+ */
+
+#ifndef IN_STATE_COUNTER_HPP_
+#define IN_STATE_COUNTER_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include "intset.hpp"
+
+using namespace std;
+
+#define IN_STATE_PLANES 16		/**< bits of the pending counts (flushed before they overflow) */
+
+
+struct InStateCounter {
+
+	int						n_vertices;
+	int						n_words;		/**< words of the states */
+
+	vector<int>				count;			/**< count of each vertex (up to date after flush) */
+
+	vector<uint64_t>		added;			/**< pending additions, planes of word i at i*IN_STATE_PLANES */
+	vector<uint64_t>		removed;		/**< pending removals, same layout */
+	int						n_added;		/**< states added since last flush */
+	int						n_removed;		/**< states removed since last flush */
+
+	vector< vector<int> >	buckets;		/**< min-heap of vertices of each count */
+	vector<int>				bucket_size;	/**< number of vertices with each count */
+	int						min_bucket;		/**< no vertex has a smaller positive count */
+	int						max_bucket;		/**< no bucket above it has entries */
+	int						n_active;		/**< vertices with positive count */
+
+	/** Constructor */
+	InStateCounter();
+
+	/** Set number of vertices (all counts become zero) */
+	void resize(int _n_vertices);
+
+	/** Set count of elements of a state to one, and of all other vertices to zero */
+	void reset(IntSet& state);
+
+	/** Increment count of all elements of a state */
+	void add(IntSet& state);
+
+	/** Decrement count of all elements of a state */
+	void remove(IntSet& state);
+
+	/** Apply pending additions and removals */
+	void flush();
+
+	/** Vertex with smallest positive count, ties broken by smallest index (-1 if none) */
+	int min_vertex();
+
+private:
+	void accumulate(vector<uint64_t>& planes, IntSet& state);
+	void set_count(int vertex, int new_count);
+	void compact_bucket(int bucket);
+};
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Constructor
+ */
+inline InStateCounter::InStateCounter()
+	: n_vertices(0), n_words(0), n_added(0), n_removed(0), min_bucket(1), max_bucket(0), n_active(0)
+{
+}
+
+
+/**
+ * Set number of vertices
+ */
+inline void InStateCounter::resize(int _n_vertices) {
+	n_vertices = _n_vertices;
+	n_words = intset_words_for_bits(n_vertices);
+	count.assign(n_vertices, 0);
+	added.assign(n_words * IN_STATE_PLANES, 0);
+	removed.assign(n_words * IN_STATE_PLANES, 0);
+	n_added = 0;
+	n_removed = 0;
+	buckets.clear();
+	bucket_size.clear();
+	min_bucket = 1;
+	max_bucket = 0;
+	n_active = 0;
+}
+
+
+/**
+ * Set count of elements of a state to one
+ */
+inline void InStateCounter::reset(IntSet& state) {
+	assert( state.n_words <= n_words );
+
+	// discard pending changes
+	if( n_added > 0 || n_removed > 0 ) {
+		memset(added.data(), 0, sizeof(uint64_t)*added.size());
+		memset(removed.data(), 0, sizeof(uint64_t)*removed.size());
+		n_added = 0;
+		n_removed = 0;
+	}
+
+	for( int b = 0; b <= max_bucket && b < (int)buckets.size(); b++ ) {
+		buckets[b].clear();
+		bucket_size[b] = 0;
+	}
+	memset(count.data(), 0, sizeof(int)*n_vertices);
+
+	if( buckets.size() < 2 ) {
+		buckets.resize(2);
+		bucket_size.resize(2, 0);
+	}
+
+	// elements are visited in increasing order, which is a valid min-heap
+	vector<int>& ones = buckets[1];
+	for( int v = state.get_first(); v != state.get_end(); v = state.get_next(v) ) {
+		count[v] = 1;
+		ones.push_back(v);
+	}
+	bucket_size[1] = ones.size();
+	n_active = ones.size();
+	min_bucket = 1;
+	max_bucket = 1;
+}
+
+
+/**
+ * Increment count of all elements of a state
+ */
+inline void InStateCounter::add(IntSet& state) {
+	if( n_added == (1 << IN_STATE_PLANES) - 1 ) {
+		flush();
+	}
+	accumulate(added, state);
+	n_added++;
+}
+
+
+/**
+ * Decrement count of all elements of a state
+ */
+inline void InStateCounter::remove(IntSet& state) {
+	if( n_removed == (1 << IN_STATE_PLANES) - 1 ) {
+		flush();
+	}
+	accumulate(removed, state);
+	n_removed++;
+}
+
+
+/**
+ * Add one to the bit-sliced count of each element of a state
+ */
+inline void InStateCounter::accumulate(vector<uint64_t>& planes, IntSet& state) {
+	assert( state.n_words <= n_words );
+	uint64_t* word_planes = planes.data() + state.first_word * IN_STATE_PLANES;
+	for( int i = state.first_word; i < state.n_words; i++, word_planes += IN_STATE_PLANES ) {
+		uint64_t carry = state.words[i];
+		for( int k = 0; carry != 0; k++ ) {
+			uint64_t next_carry = word_planes[k] & carry;
+			word_planes[k] ^= carry;
+			carry = next_carry;
+		}
+	}
+}
+
+
+/**
+ * Apply pending additions and removals
+ */
+inline void InStateCounter::flush() {
+	if( n_added == 0 && n_removed == 0 ) {
+		return;
+	}
+
+	// planes that may have bits set
+	int n_planes = 0;
+	while( n_planes < IN_STATE_PLANES && ((n_added | n_removed) >> n_planes) != 0 ) {
+		n_planes++;
+	}
+
+	for( int i = 0; i < n_words; i++ ) {
+		uint64_t* add_planes = &added[i * IN_STATE_PLANES];
+		uint64_t* remove_planes = &removed[i * IN_STATE_PLANES];
+
+		uint64_t touched = 0;
+		for( int k = 0; k < n_planes; k++ ) {
+			touched |= add_planes[k] | remove_planes[k];
+		}
+
+		while( touched != 0 ) {
+			int bit = count_trailing_zeros_word(touched);
+			touched &= touched - 1;
+
+			int delta = 0;
+			for( int k = 0; k < n_planes; k++ ) {
+				delta += (int)((add_planes[k] >> bit) & 1) << k;
+				delta -= (int)((remove_planes[k] >> bit) & 1) << k;
+			}
+			if( delta != 0 ) {
+				int vertex = (i << 6) + bit;
+				assert( count[vertex] + delta >= 0 );
+				set_count(vertex, count[vertex] + delta);
+			}
+		}
+
+		for( int k = 0; k < n_planes; k++ ) {
+			add_planes[k] = 0;
+			remove_planes[k] = 0;
+		}
+	}
+	n_added = 0;
+	n_removed = 0;
+}
+
+
+/**
+ * Vertex with smallest positive count
+ */
+inline int InStateCounter::min_vertex() {
+	flush();
+	if( n_active == 0 ) {
+		return -1;
+	}
+
+	while( bucket_size[min_bucket] == 0 ) {
+		min_bucket++;
+	}
+
+	// drop entries of vertices that left the bucket
+	vector<int>& heap = buckets[min_bucket];
+	while( count[heap.front()] != min_bucket ) {
+		pop_heap(heap.begin(), heap.end(), greater<int>());
+		heap.pop_back();
+	}
+	return heap.front();
+}
+
+
+/**
+ * Move a vertex to the bucket of its new count
+ */
+inline void InStateCounter::set_count(int vertex, int new_count) {
+	int old_count = count[vertex];
+	count[vertex] = new_count;
+
+	if( old_count > 0 ) {
+		bucket_size[old_count]--;
+		n_active--;
+		if( (int)buckets[old_count].size() > 2*bucket_size[old_count] + 32 ) {
+			compact_bucket(old_count);
+		}
+	}
+
+	if( new_count > 0 ) {
+		if( new_count >= (int)buckets.size() ) {
+			buckets.resize(2*new_count);
+			bucket_size.resize(2*new_count, 0);
+		}
+		buckets[new_count].push_back(vertex);
+		push_heap(buckets[new_count].begin(), buckets[new_count].end(), greater<int>());
+		bucket_size[new_count]++;
+		n_active++;
+		min_bucket = MIN(min_bucket, new_count);
+		max_bucket = MAX(max_bucket, new_count);
+	}
+}
+
+
+/**
+ * Rebuild the heap of a bucket with valid entries only
+ */
+inline void InStateCounter::compact_bucket(int bucket) {
+	vector<int>& heap = buckets[bucket];
+	int n_valid = 0;
+	for( int j = 0; j < (int)heap.size(); j++ ) {
+		if( count[heap[j]] == bucket ) {
+			heap[n_valid++] = heap[j];
+		}
+	}
+	heap.resize(n_valid);
+
+	// a vertex that left and came back has several entries
+	sort(heap.begin(), heap.end());
+	heap.erase(unique(heap.begin(), heap.end()), heap.end());
+	assert( (int)heap.size() == bucket_size[bucket] );
+}
+
+
+#endif /* IN_STATE_COUNTER_HPP_ */
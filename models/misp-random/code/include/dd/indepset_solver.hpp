@@ -12,14 +12,27 @@
 
 #define EXACT_BDD -1
 
+#ifndef BRANCH_PARALLEL_MIN_NODES
+#define BRANCH_PARALLEL_MIN_NODES 512		/**< smallest layer branched with several threads */
+#endif
+
 #include "bdd.hpp"
+#include "node_pool.hpp"
+#include "node_arena.hpp"
+#include "in_state_counter.hpp"
+#include "compact_dd.hpp"
+#include "frontier_spill.hpp"
 #include "instance.hpp"
 #include "stats.hpp"
+#include "layer_stats.hpp"
 #include "intset.hpp"
 #include "orderings.hpp"
 #include "merge.hpp"
 
 #include <boost/random/discrete_distribution.hpp>
+#include <cstdlib>
+#include <functional>
+#include <string>
 #include <vector>
 #include <map>
 #include <queue>
@@ -44,18 +57,48 @@ struct CompareNodesRelaxUB {
 
 typedef priority_queue<Node*, vector<Node*>, CompareNodesRelaxUB> NodeQueue;
 
+
+/**
+ * Signature of a layer node for dominance checks: if state A is a subset of state B,
+ * the bits of A's signatures are in B's
+ */
+struct DominanceKey {
+	int			size;					/**< number of vertices in the state */
+	uint64_t	folded;					/**< bitwise or of the words of the state */
+	uint64_t	word_mask;				/**< nonzero words of the state (modulo 64) */
+	bool		dominated;
+};
+
 struct Bounds {
 	int lb;
 	int ub;
 };
 
+/**
+ * Branch and bound parameters
+ */
+struct BranchAndBoundParams {
+	int			n_threads;				/**< number of workers */
+	long		node_limit;				/**< maximum number of subproblems explored (-1: no limit) */
+	bool		prune_nodes;			/**< if subproblem diagrams prune nodes that cannot beat the incumbent */
+	double		time_limit;				/**< maximum time in seconds (-1: no limit) */
+	double		report_interval;		/**< seconds between progress lines (-1: silent) */
+
+	/** Orderings and mergers of additional workers (both required if n_threads > 1) */
+	std::function<IS_Ordering*(IndepSetInst*)>			make_ordering;
+	std::function<IS_Merging*(IndepSetInst*, int)>		make_merger;
+
+	BranchAndBoundParams() : n_threads(1), node_limit(-1), prune_nodes(true), time_limit(-1), report_interval(-1) { }
+};
+
 struct IndepSetSolver {
 
-	NodeMap  						node_list;
+	NodePool  						node_list;				      /**< pool of nodes, indexed by state and vertex */
+	NodeArena						arena;						  /**< allocator of all nodes of the diagram */
 
 	vector<int>						active_vertices;
-	int*							in_state_counter;
-	int*							active_vertex_map;
+	InStateCounter					in_state;					  /**< number of pool nodes containing each vertex */
+	vector<int>						active_vertex_map;
 
 	vector<Node*>					nodes_layer;			      /**< nodes in a layer */
 
@@ -77,8 +120,16 @@ struct IndepSetSolver {
 	int								global_LB;
 	int								global_UB;
 
+	BranchAndBoundParams			bb_params;
+	long							bb_explored;				  /**< subproblems explored in last search */
+
+	bool							exact;						  /**< if last diagram had no merged/removed nodes */
+	bool							collect_cutset;				  /**< if relaxations keep their exact cutset */
+	vector<Node*>					exact_cutset;				  /**< exact nodes where last relaxation started merging */
+	vector<Node*>					cutset_aux;
 
 	Bounds							branch_and_bound();
+	void							save_exact_cutset();
 
 	//vector< vector<Node*> >		final_bdd;
 
@@ -88,17 +139,115 @@ struct IndepSetSolver {
 
 	vector<int>						selectable_vertices;
 
+	/**
+	 * Parallel branching (children of layer node i are candidates 2i and 2i+1)
+	 */
+	int								n_threads;					 /**< threads used to branch large layers */
+	IntSet							one_arc_state;				 /**< one-arc child looked up before a node is made for it (serial) */
+	vector<IntSet>					branch_states;				 /**< one-arc state of each layer node */
+	vector<uint64_t>				branch_hash;				 /**< state hash of each candidate */
+	vector<int>						branch_longest_path;		 /**< longest path of each candidate */
+	vector<int>						branch_rep;					 /**< first candidate with same state (-1 if in pool) */
+	vector< vector<int> >			branch_shards;				 /**< candidates of each hash shard */
+	vector< vector<int> >			branch_shard_tables;		 /**< open addressing table of each shard */
+
+	/**
+	 * Materialized diagram (opt-in: arcs of the last diagram are kept in compact_dd)
+	 */
+	bool							materialize;				 /**< if diagrams are materialized */
+	CompactDD						compact_dd;					 /**< last materialized diagram */
+	CompactDDBuilder				dd_builder;
+
+	void							finish_compact_dd();		 /**< complete compact_dd (needed only after step by step builds) */
+
+	/**
+	 * Memory-bounded exact diagrams: when nodes take more than the budget after a layer
+	 * is branched, pool nodes needed last are spilled to disk until half of it is used.
+	 * Spilled nodes of a layer are read back and branched in chunks.
+	 */
+	long							memory_budget;				 /**< bytes of nodes kept in memory by exact diagrams (-1: no limit) */
+	string							spill_dir;					 /**< where spill files are created */
+	FrontierSpill					spill;						 /**< pool nodes on disk */
+	long							peak_bytes;					 /**< peak bytes of nodes, pool and layer in last diagram */
+
+	bool							spills();					 /**< if the current diagram may spill nodes */
+	long							memory_in_use();			 /**< bytes of nodes, pool and layer */
+	void							branch_spilled_layer();		 /**< branch on current vertex, reading spilled nodes in chunks */
+	void							bound_memory();				 /**< track peak memory and spill nodes if over budget */
+	void							print_memory_stats(ostream &os);
+
+	/**
+	 * Completion bounds: the relax_ub of a layer node is its longest path plus the clique
+	 * cover bound of its state (sum over cliques of the heaviest vertex in the state).
+	 * Nodes whose relax_ub does not exceed prune_lb are discarded before merging and
+	 * branching. Restrictions built with pruning on raise prune_lb to their value.
+	 */
+	int								prune_lb;					 /**< value that nodes must beat (-INF: no pruning) */
+	long							n_pruned;					 /**< nodes pruned in last diagram */
+	vector<int>						clique_best;				 /**< heaviest vertex of each clique seen in a state */
+	vector<int>						cliques_seen;
+
+	int								completion_bound(IntSet &state);	/**< clique cover bound of a state */
+	void							prune_layer();				 /**< set relax_ub of layer nodes and discard hopeless ones */
+	int								final_value(bool destroy_terminal);	/**< value of the last diagram */
+
+	/**
+	 * Dominance filter (opt-in): a layer node whose state is a subset of the state of another
+	 * layer node with at least its longest path cannot lead to a better solution. Such nodes
+	 * are discarded from layers wider than the maximum width before these are merged or
+	 * restricted, so both bounds stay valid (see dominance.cpp).
+	 */
+	bool							dominance;					 /**< if dominated layer nodes are discarded */
+	long							n_dominated;				 /**< nodes discarded in last diagram */
+	vector<int>						dominated_in_layer;			 /**< nodes discarded at each layer of last diagram */
+	vector<DominanceKey>			dominance_keys;				 /**< key of each layer node */
+	vector<int>						dominance_order;
+	vector<int>						dominance_kept;
+
+	void							remove_dominated();			 /**< discard dominated nodes of the layer */
+
+	/**
+	 * Construction counters (see layer_stats.hpp): a record per layer of the last diagram,
+	 * filled by extract_layer, merging and branch_layer. Forks start with an empty log.
+	 */
+	LayerStatsLog					layer_stats;
+	long							stats_slab_bytes;			 /**< arena slab bytes when the layer was extracted */
+
+	/**
+	 * Component decomposition (opt-in): before each layer of a relaxation, the vertices left
+	 * in the states of the pool are checked for connectivity. If they split into several
+	 * components, each projection of the pool states on a component is relaxed separately
+	 * and the bounds of the projections are summed (see decomposition.cpp). Diagrams of the
+	 * projections are built by n_threads solvers, whose orderings and mergers come from the
+	 * factories in bb_params; without factories, one solver shares those of this solver.
+	 * Relaxations that collect an exact cutset (branch and bound) are not decomposed.
+	 */
+	bool							decompose;					 /**< if relaxations are decomposed into components */
+	int								decompose_max_roots;		 /**< projections on a component relaxed separately (more are merged) */
+	int								decomposed_layer;			 /**< layer where last relaxation was decomposed (-1: none) */
+	IntSet							remaining;					 /**< vertices left in the pool */
+	int								n_components;				 /**< components of the vertices left */
+	vector<int>						component_of;				 /**< component of each vertex left (-1: none) */
+	vector<int>						component_stack;
+	vector<IndepSetSolver*>			component_solvers;
+
+	bool							find_components();			 /**< split vertices left into components (true if more than one) */
+	int								relax_components();			 /**< bound of the pool from relaxations of each component */
+
 	// added for RL
 
 	int eligible_vertex;
 	Node* initial_node;
-	NodeMap::iterator node_it;
-	NodeMap::iterator existing_node_it;
+	Node* existing_node;
 	int current_vertex;
 	Node* node;
 
 	// auxiliaries
 	int  generate_relaxation(IntSet &initial_state, int initial_longest_path);
+	int  relax_layers();								 /**< complete a relaxation from the current layer */
+	vector<int> generate_relaxations(IntSet &initial_state, int initial_longest_path, const vector<int> &widths);
+	IndepSetSolver* fork();								 /**< new solver continuing this diagram (between steps), sharing its nodes */
+	void share_frontier(IndepSetSolver &from);			 /**< continue the diagram of a solver that called share on its pool */
 	int  generate_restriction_with_ordering(IntSet &initial_state, int initial_longest_path);
 	int  generate_restriction(IntSet &initial_state, int initial_longest_path);
 
@@ -109,14 +258,36 @@ struct IndepSetSolver {
 	void relax_layer_shortestpath();
 	void restrict_layer_shortestpath();
 
-	void update_node_match(Node* nodeA, Node* nodeB);
+	void update_node_match(Node*& nodeA, int longest_path);
+
+	Node* create_root(IntSet &initial_state, int initial_longest_path);	/**< start a new diagram */
+	void extract_layer(bool update_in_state);		/**< take nodes of current vertex from the pool */
+	void branch_layer(bool update_in_state);		/**< branch on current vertex for all nodes in layer */
+	void branch_layer_parallel(bool update_in_state);
+	void dedup_branch_shard(int shard);
+	bool tracks_in_state();							/**< if in state counters must be maintained */
+	void add_to_in_state(IntSet& state, int delta);
 
 	void initialize(IntSet &initial_state, int initial_longest_path);
+	int select_vertex(int next_vertex);				/**< vertex of the next step */
+	int process_layer(bool relaxed);				/**< merge or restrict the extracted layer, then branch */
 	int generate_next_step_relaxation(int next_vertex);
 	int generate_next_step_restriction(int next_vertex);
+	int generate_next_step_bounds(int next_vertex);	/**< step of a relaxation and a restriction together */
 	int get_bound();
+	int get_restriction_bound();
+
+	/**
+	 * Combined bounds: restriction forked from this solver at the first layer that
+	 * exceeds the width (kept allocated across diagrams)
+	 */
+	IndepSetSolver*					restriction;
+	bool							split;						 /**< if restriction is being built */
 
 	IndepSetSolver(IndepSetInst* _inst, int _width);
+	~IndepSetSolver();
+
+	void reset(IndepSetInst* _inst);		/**< solve another instance, keeping allocated buffers */
 };
 
 
@@ -124,28 +295,177 @@ inline IndepSetSolver::IndepSetSolver(IndepSetInst* _inst, int _width) : inst(_i
 {
 	relax = false;
 
-	in_state_counter = new int[inst->graph->n_vertices];
-	active_vertex_map = new int[inst->graph->n_vertices];
+	ordering = NULL;
+	merger = NULL;
 
-	if( width != EXACT_BDD )
+	n_threads = 1;
+	materialize = false;
+
+	prune_lb = -INF;
+	n_pruned = 0;
+
+	dominance = false;
+	n_dominated = 0;
+	stats_slab_bytes = 0;
+
+	memory_budget = -1;
+	spill_dir = ( getenv("TMPDIR") != NULL ) ? getenv("TMPDIR") : "/tmp";
+	peak_bytes = 0;
+
+	collect_cutset = false;
+
+	restriction = NULL;
+	split = false;
+
+	decompose = false;
+	decompose_max_roots = 16;
+	n_components = 0;
+	decomposed_layer = -1;
+
+	// exact diagrams grow their layers as needed
+	if( width != EXACT_BDD ) {
 		nodes_layer.reserve(2*width*100);
-	else {
-		nodes_layer.reserve(100000000);
+		node_list.reserve(2*width);
 	}
 
+	reset(_inst);
+}
+
 
-	vertex_in_layer.resize(inst->graph->n_vertices+1);
 
-	selectable_vertices.reserve(inst->graph->n_vertices);
+inline IndepSetSolver::~IndepSetSolver() {
+	delete restriction;
+	for( int t = 0; t < (int)component_solvers.size(); t++ ) {
+		delete component_solvers[t]->ordering;
+		delete component_solvers[t]->merger;
+		delete component_solvers[t];
+	}
+	for( vector<Node*>::iterator it = exact_cutset.begin(); it != exact_cutset.end(); ++it ) {
+		delete (*it);
+	}
 }
 
 
+/**
+ * Bind the solver to an instance. Nodes of the last diagram are discarded, while the
+ * arena slabs, pool table, counters and layer vectors keep their capacity, so that
+ * solving many instances of similar size does not allocate again.
+ */
+inline void IndepSetSolver::reset(IndepSetInst* _inst) {
+	inst = _inst;
+	int n_vertices = inst->graph->n_vertices;
+
+	final_width = -1;
+	exact = true;
+	bb_explored = 0;
+	for( vector<Node*>::iterator it = exact_cutset.begin(); it != exact_cutset.end(); ++it ) {
+		delete (*it);
+	}
+	exact_cutset.clear();
+	layer_stats.clear();
+
+	node_list.clear();
+	node_list.resize(n_vertices);
+	nodes_layer.clear();
+	arena.reset();
+	arena.set_state_size(n_vertices);
+	in_state.resize(n_vertices);
+	one_arc_state.resize(0, n_vertices-1, false);
+
+	active_vertices.clear();
+	active_vertex_map.resize(n_vertices);
+	vertex_in_layer.resize(n_vertices+1);
+	selectable_vertices.reserve(n_vertices);
+
+	if( materialize ) {
+		compact_dd.clear();
+	}
+}
+
+
+
+/**
+ * Pool node nodeA has the state of a child with a given longest path: keep the longest
+ * of both. If nodeA is shared with forks and its path grows, it is replaced in the pool
+ * by an own copy.
+ */
+inline void IndepSetSolver::update_node_match(Node*& nodeA, int longest_path) {
+
+	if( longest_path > nodeA->longest_path && !node_list.shared.empty() && node_list.is_shared(nodeA) ) {
+		Node* copy = arena.create(nodeA->state, nodeA->longest_path);
+		node_list.erase(nodeA);
+		node_list.insert(copy);
+		nodeA = copy;
+	}
+	nodeA->longest_path = MAX(nodeA->longest_path, longest_path);
 
-inline void IndepSetSolver::update_node_match(Node* nodeA, Node* nodeB) {
+}
 
-	nodeA->longest_path = MAX(nodeA->longest_path, nodeB->longest_path);
-	nodeB->longest_path = nodeA->longest_path;
 
+/**
+ * Only exact diagrams spill (materialized ones keep all their nodes anyway)
+ */
+inline bool IndepSetSolver::spills() {
+	return ( width == EXACT_BDD && memory_budget >= 0 && !materialize );
+}
+
+
+/**
+ * Bytes of nodes alive, pool index and current layer
+ */
+inline long IndepSetSolver::memory_in_use() {
+	return arena.n_live * (long)arena.slot_bytes
+		+ node_list.table.slots.size() * (long)sizeof(NodeTable::Slot)
+		+ node_list.n_postings * (long)sizeof(int)
+		+ node_list.entries.capacity() * (long)sizeof(Node*)
+		+ nodes_layer.capacity() * (long)sizeof(Node*);
+}
+
+
+/**
+ * Clique cover bound of a state: an independent set has at most one vertex of each clique
+ */
+inline int IndepSetSolver::completion_bound(IntSet &state) {
+	if( (int)clique_best.size() != inst->n_cliques ) {
+		clique_best.assign(inst->n_cliques, 0);
+	}
+
+	int bound = 0;
+	for( int v = state.get_first(); v != state.get_end(); v = state.get_next(v) ) {
+		int c = inst->clique_of[v];
+		int w = inst->weights[v];
+		if( clique_best[c] == 0 ) {
+			cliques_seen.push_back(c);
+		}
+		if( w > clique_best[c] ) {
+			bound += w - clique_best[c];
+			clique_best[c] = w;
+		}
+	}
+
+	for( int i = 0; i < (int)cliques_seen.size(); i++ ) {
+		clique_best[cliques_seen[i]] = 0;
+	}
+	cliques_seen.clear();
+	return bound;
+}
+
+
+inline bool IndepSetSolver::tracks_in_state() {
+	return ( ordering->order_type == MinState || ordering->order_type == RandMinState );
+}
+
+
+/**
+ * Add (delta = 1) or remove (delta = -1) a state from the in state counters
+ */
+inline void IndepSetSolver::add_to_in_state(IntSet& state, int delta) {
+	assert( delta == 1 || delta == -1 );
+	if( delta > 0 ) {
+		in_state.add(state);
+	} else {
+		in_state.remove(state);
+	}
 }
 
 
@@ -170,7 +490,10 @@ inline void IndepSetSolver::relax_layer_shortestpath() {
 	for( vector<Node*>::iterator node = nodes_layer.begin()+width; node != nodes_layer.end(); ++node) {
 		state->union_with((*node)->state);
 
-			delete (*node);
+			if( materialize ) {
+				dd_builder.merge(*node, nodes_layer[width-1]);
+			}
+			arena.destroy(*node);
 //		}
 	}
 	nodes_layer.resize(width);
@@ -187,7 +510,10 @@ inline void IndepSetSolver::relax_layer_shortestpath() {
 		if( node->state.equals_to(*state) ) {
 
 			// delete the last node
-			delete nodes_layer.back();
+			if( materialize ) {
+				dd_builder.merge(nodes_layer.back(), node);
+			}
+			arena.destroy(nodes_layer.back());
 
 			// remove it from queue
 			nodes_layer.pop_back();
@@ -200,19 +526,7 @@ inline void IndepSetSolver::relax_layer_shortestpath() {
 
 
 inline int IndepSetSolver::choose_next_vertex_min_size_next_layer() {
-
-
-	int min = INF;
-	int selected_vertex = -1;
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		if( in_state_counter[i] > 0 && in_state_counter[i] < min ) {
-			selected_vertex = i;
-			min = in_state_counter[i];
-		}
-	}
-
-
-	return selected_vertex;
+	return in_state.min_vertex();
 }
 
 inline int IndepSetSolver::choose_next_vertex_min_size_next_layer_random() {
@@ -228,21 +542,15 @@ inline int IndepSetSolver::choose_next_vertex_min_size_next_layer_random() {
 	if( dist(min_state->gen) == 0 ) {
 
 		// min state !
-		int min = INF;
-
-		for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-			if( in_state_counter[i] > 0 && in_state_counter[i] < min ) {
-				selected_vertex = i;
-				min = in_state_counter[i];
-			}
-		}
+		selected_vertex = in_state.min_vertex();
 
 	} else {
 
 		// randomized!
+		in_state.flush();
 		selectable_vertices.clear();
 		for( int v = 0; v < inst->graph->n_vertices; v++ ) {
-			if( in_state_counter[v] > 0 ) {
+			if( in_state.count[v] > 0 ) {
 				selectable_vertices.push_back(v);
 			}
 		}
@@ -27,7 +27,10 @@ enum VertexOrder {
 };
 
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <map>
 #include "graph.hpp"
 #include "intset.hpp"
@@ -69,8 +72,13 @@ struct IndepSetInst {
 
   IntSet*			  adj_mask_compl;	 /**< complement mask of adjacencies */
   map<int, int>       node_mapping;
+
+  vector<int>         clique_of;         /**< clique of each vertex in a clique cover (empty until built) */
+  int                 n_cliques;         /**< number of cliques of the cover */
+
+  vector<int>         original_vertex;   /**< vertex of the instance this one was relabeled from (empty if not relabeled) */
  
-  /** Read DIMACS independent set instance */
+  /** Read independent set instance from a DIMACS, edge list or METIS file */
   void read_DIMACS(const char* filename);
 
   /** Read DIMACS independent set instance with costs */
@@ -79,11 +87,27 @@ struct IndepSetInst {
   /** Build a graph from an adj list */
   void build_instance_from_edge_list(vector<pair<int, int> >, set<int>);
 
-  void build_complete_instance(std::vector< std::vector< std::pair<int, double> > > adj);
+  void build_complete_instance(const std::vector< std::vector< std::pair<int, double> > > &adj);
   /** Assign weights to vertices */
   void assign_weights();
 
+  /** Build graph, unit weights and adjacency masks from a list of edges in O(n*n/64 + |E|) */
+  void build_from_edges(int n_vertices, const vector< pair<int,int> > &edges);
+
+  /** Greedy partition of the vertices into cliques, heavier vertices first */
+  void build_clique_cover();
+
+  /** Build a copy of another instance where vertex i is the vertex order[i] of the other */
+  void build_relabeled(const IndepSetInst &other, const vector<int> &order);
 
+  /** Constructor */
+  IndepSetInst();
+
+  /** Destructor */
+  ~IndepSetInst();
+
+private:
+  void build_adj_masks();
 
 };
 
@@ -118,20 +142,7 @@ inline void IndepSetInst::read_DIMACS(const char *filename) {
   memset(weights_exclusion, 0, sizeof(int)*graph->n_vertices);
 
   // create complement mask of adjacencies
-  adj_mask_compl = new IntSet[graph->n_vertices];
-  for( int v = 0; v < graph->n_vertices; v++ ) {
-
-	  adj_mask_compl[v].resize(0, graph->n_vertices-1, true);
-	  for( int w = 0; w < graph->n_vertices; w++ ) {
-		  if( graph->is_adj(v,w) ) {
-			  adj_mask_compl[v].remove(w);
-		  }
-	  }
-
-	  // a vertex is adjacent to itself
-	  adj_mask_compl[v].remove(v);
-
-  }
+  build_adj_masks();
 
   assign_weights();
 
@@ -139,53 +150,59 @@ inline void IndepSetInst::read_DIMACS(const char *filename) {
 }
 
 /**
- * Read DIMACS independent set instance with no costs
+ * Build instance from a list of edges over the vertices of covered_set
  */
 inline void IndepSetInst::build_instance_from_edge_list(vector< pair<int, int> > edge_list,set<int> covered_set) {
 
-    graph = new Graph_BDD;
-
     int count = 0;
     for (auto v: covered_set) {
         node_mapping.insert({v,count});
         count++;
     }
 
-
-
-    graph->n_vertices = node_mapping.size();
-    //cout << "vertices: " << n  << '\n';
-    // allocate adjacent matrix
-    graph->adj_m = new bool*[graph->n_vertices];
-    for( int i = 0; i < graph->n_vertices; i++ ) {
-        graph->adj_m[i] = new bool[graph->n_vertices];
-        memset(graph->adj_m[i], false, sizeof(bool)*graph->n_vertices);
+    for (auto& e: edge_list) {
+        e.first = node_mapping.at(e.first);
+        e.second = node_mapping.at(e.second);
     }
 
-    // allocate adjacent list
-    graph->adj_list.resize(graph->n_vertices);
+    build_from_edges(node_mapping.size(), edge_list);
+}
 
 
-    for (auto e: edge_list) {
-        //cout.flush();
-        graph->set_adj(node_mapping.at(e.first),node_mapping.at(e.second));
-        graph->set_adj(node_mapping.at(e.second),node_mapping.at(e.first));
-    }
+/**
+ * Build instance from adjacency lists (edges may be listed in both directions)
+ */
+inline void IndepSetInst::build_complete_instance(const std::vector< std::vector< std::pair<int, double> > > &adj) {
 
-    for( int i = 0; i < graph->n_vertices; i++ ) {
-        graph->set_adj(i, i);
+    vector< pair<int,int> > edges;
+    for( int i = 0; i < (int)adj.size(); i++ ) {
+        for( auto& neigh : adj[i] ) {
+            edges.push_back(pair<int,int>(i, neigh.first));
+        }
     }
 
-    int count_edges = 0;
+    build_from_edges(adj.size(), edges);
+}
+
+
+/**
+ * Assign unit weights to vertices
+ */
+inline void IndepSetInst::assign_weights() {
+    weights = new int[graph->n_vertices];
     for( int i = 0; i < graph->n_vertices; i++ ) {
-        for( int j = i+1; j < graph->n_vertices; j++ ) {
-            if( graph->is_adj(i,j) ) {
-                count_edges++;
-            }
-        }
+        weights[i] = 1;
     }
+}
 
-    graph->n_edges += count_edges;
+
+/**
+ * Build graph, unit weights and adjacency masks from a list of edges
+ */
+inline void IndepSetInst::build_from_edges(int n_vertices, const vector< pair<int,int> > &edges) {
+
+    graph = new Graph_BDD;
+    graph->build(n_vertices, edges);
 
     // allocate weights: 1 for inclusion, 0 for exclusion
     weights_inclusion = new int[graph->n_vertices];
@@ -195,20 +212,7 @@ inline void IndepSetInst::build_instance_from_edge_list(vector< pair<int, int> >
     memset(weights_exclusion, 0, sizeof(int)*graph->n_vertices);
 
     // create complement mask of adjacencies
-    adj_mask_compl = new IntSet[graph->n_vertices];
-    for( int v = 0; v < graph->n_vertices; v++ ) {
-
-        adj_mask_compl[v].resize(0, graph->n_vertices-1, true);
-        for( int w = 0; w < graph->n_vertices; w++ ) {
-            if( graph->is_adj(v,w) ) {
-                adj_mask_compl[v].remove(w);
-            }
-        }
-
-        // a vertex is adjacent to itself
-        adj_mask_compl[v].remove(v);
-
-    }
+    build_adj_masks();
 
     srand(0);
     weights = new int[graph->n_vertices];
@@ -218,89 +222,148 @@ inline void IndepSetInst::build_instance_from_edge_list(vector< pair<int, int> >
         //weights[i] = graph->n_vertices-graph->adj_list[i].size();
         weights[i] = 1;
     }
-
-
 }
 
 
-inline void IndepSetInst::build_complete_instance(std::vector< std::vector< std::pair<int, double> > > adj) {
-
-    graph = new Graph_BDD;
-
-
+/**
+ * Complement masks of adjacencies, from the neighbor lists (a vertex is adjacent to itself)
+ */
+inline void IndepSetInst::build_adj_masks() {
 
-    graph->n_vertices = adj.size();
-    //cout << "vertices: " << n  << '\n';
-    // allocate adjacent matrix
-    graph->adj_m = new bool*[graph->n_vertices];
-    for( int i = 0; i < graph->n_vertices; i++ ) {
-        graph->adj_m[i] = new bool[graph->n_vertices];
-        memset(graph->adj_m[i], false, sizeof(bool)*graph->n_vertices);
+    adj_mask_compl = new IntSet[graph->n_vertices];
+    for( int v = 0; v < graph->n_vertices; v++ ) {
+        adj_mask_compl[v].resize(0, graph->n_vertices-1, true);
+        for( const int* w = graph->neighbors_begin(v); w != graph->neighbors_end(v); ++w ) {
+            adj_mask_compl[v].remove(*w);
+        }
     }
+}
 
-    // allocate adjacent list
-    graph->adj_list.resize(graph->n_vertices);
 
-    for(int i = 0 ; i < graph->n_vertices ; i++) {
-        for (auto& neigh : adj[i]) {
-            graph->set_adj(i,neigh.first);
-            graph->set_adj(neigh.first,i);
-            //cout << i << ' ' << neigh.first << " ; added" <<  endl;
-        }
-    }
+/**
+ * Greedy clique cover: each clique starts at the heaviest vertex not covered yet and
+ * grows with its uncovered neighbors that are adjacent to all vertices added so far.
+ * Takes O(sum of degrees of each clique) per clique.
+ */
+inline void IndepSetInst::build_clique_cover() {
 
+    int n_vertices = graph->n_vertices;
+    clique_of.assign(n_vertices, -1);
+    n_cliques = 0;
 
-    for( int i = 0; i < graph->n_vertices; i++ ) {
-        graph->set_adj(i, i);
+    vector<int> order(n_vertices);
+    for( int v = 0; v < n_vertices; v++ ) {
+        order[v] = v;
     }
+    int* w = weights;
+    stable_sort(order.begin(), order.end(), [w](int a, int b) { return w[a] > w[b]; });
+
+    vector<int> candidates, common;
+    for( int i = 0; i < n_vertices; i++ ) {
+        int v = order[i];
+        if( clique_of[v] != -1 ) {
+            continue;
+        }
+        clique_of[v] = n_cliques;
 
-    int count_edges = 0;
-    for( int i = 0; i < graph->n_vertices; i++ ) {
-        for( int j = i+1; j < graph->n_vertices; j++ ) {
-            if( graph->is_adj(i,j) ) {
-                count_edges++;
+        // uncovered neighbors of v, in increasing order
+        candidates.clear();
+        for( const int* u = graph->neighbors_begin(v); u != graph->neighbors_end(v); ++u ) {
+            if( clique_of[*u] == -1 ) {
+                candidates.push_back(*u);
+            }
+        }
+
+        // add the heaviest candidate and keep the candidates adjacent to it
+        while( !candidates.empty() ) {
+            int best = 0;
+            for( int k = 1; k < (int)candidates.size(); k++ ) {
+                if( w[candidates[k]] > w[candidates[best]] ) {
+                    best = k;
+                }
+            }
+            int u = candidates[best];
+            clique_of[u] = n_cliques;
+
+            common.clear();
+            set_intersection(candidates.begin(), candidates.end(),
+                    graph->neighbors_begin(u), graph->neighbors_end(u), back_inserter(common));
+            candidates.clear();
+            for( int k = 0; k < (int)common.size(); k++ ) {
+                if( clique_of[common[k]] == -1 ) {
+                    candidates.push_back(common[k]);
+                }
             }
         }
+        n_cliques++;
     }
+}
 
-    graph->n_edges += count_edges;
 
-    //cout << "\tnumber of vertices: " << graph->n_vertices << endl;
-    //cout << "\tnumber of edges: " << graph->n_edges << endl;
-    // allocate weights: 1 for inclusion, 0 for exclusion
-    weights_inclusion = new int[graph->n_vertices];
-    memset(weights_inclusion, -1, sizeof(int)*graph->n_vertices);
+/**
+ * Copy of another instance with vertices relabeled: vertex i is the vertex order[i]
+ * of the other instance, with its weights, clique and action id
+ */
+inline void IndepSetInst::build_relabeled(const IndepSetInst &other, const vector<int> &order) {
 
-    weights_exclusion = new int[graph->n_vertices];
-    memset(weights_exclusion, 0, sizeof(int)*graph->n_vertices);
+    int n_vertices = other.graph->n_vertices;
+    assert( (int)order.size() == n_vertices );
 
-    // create complement mask of adjacencies
-    adj_mask_compl = new IntSet[graph->n_vertices];
-    for( int v = 0; v < graph->n_vertices; v++ ) {
+    vector<int> label(n_vertices, -1);
+    for( int i = 0; i < n_vertices; i++ ) {
+        assert( label[order[i]] == -1 );
+        label[order[i]] = i;
+    }
 
-        adj_mask_compl[v].resize(0, graph->n_vertices-1, true);
-        for( int w = 0; w < graph->n_vertices; w++ ) {
-            if( graph->is_adj(v,w) ) {
-                adj_mask_compl[v].remove(w);
+    vector< pair<int,int> > edges;
+    edges.reserve(other.graph->n_edges);
+    for( int v = 0; v < n_vertices; v++ ) {
+        for( const int* w = other.graph->neighbors_begin(v); w != other.graph->neighbors_end(v); ++w ) {
+            if( *w > v ) {
+                edges.push_back(pair<int,int>(label[v], label[*w]));
             }
         }
+    }
+    build_from_edges(n_vertices, edges);
 
-        // a vertex is adjacent to itself
-        adj_mask_compl[v].remove(v);
-
+    for( int i = 0; i < n_vertices; i++ ) {
+        weights_inclusion[i] = other.weights_inclusion[order[i]];
+        weights_exclusion[i] = other.weights_exclusion[order[i]];
+        weights[i] = other.weights[order[i]];
+    }
+    if( !other.clique_of.empty() ) {
+        clique_of.resize(n_vertices);
+        for( int i = 0; i < n_vertices; i++ ) {
+            clique_of[i] = other.clique_of[order[i]];
+        }
+        n_cliques = other.n_cliques;
+    }
+    node_mapping.clear();
+    for( map<int,int>::const_iterator it = other.node_mapping.begin(); it != other.node_mapping.end(); ++it ) {
+        node_mapping[it->first] = label[it->second];
     }
+    original_vertex = order;
+}
 
-    srand(0);
-    weights = new int[graph->n_vertices];
 
-    for( int i = 0; i < graph->n_vertices; i++ ) {
-        //weights[i] = (1+graph->n_vertices-graph->adj_list[i].size())*3 + rand()%10;
-        //weights[i] = graph->n_vertices-graph->adj_list[i].size();
-        weights[i] = 1;
-    }
+/**
+ * Constructor
+ */
+inline IndepSetInst::IndepSetInst()
+    : graph(NULL), weights_inclusion(NULL), weights_exclusion(NULL), weights(NULL), adj_mask_compl(NULL), n_cliques(0)
+{
+}
 
-    //cout << "\tdone." << endl;
 
+/**
+ * Destructor
+ */
+inline IndepSetInst::~IndepSetInst() {
+    delete graph;
+    delete[] weights_inclusion;
+    delete[] weights_exclusion;
+    delete[] weights;
+    delete[] adj_mask_compl;
 }
 
 
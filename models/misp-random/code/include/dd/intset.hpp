@@ -15,15 +15,31 @@
 
 #define NOT_COMPUTED -1     /**< indicates if the size was not computed */
 
-#include <boost/dynamic_bitset.hpp>
+#define INTSET_INLINE_WORDS 4   /**< sets up to this number of words are stored inside the object */
+
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include "util.hpp"
+#include "wordops.hpp"
 
 
 /**
  * Integer Set structure
+ *
+ * Elements are stored as a bitvector of 64-bit words. Sets of up to
+ * 64*INTSET_INLINE_WORDS elements need no heap allocation; larger sets
+ * use heap storage, or storage given at construction. Word count is
+ * padded to a multiple of WORDOPS_VECTOR_WORDS beyond INTSET_SMALL_WORDS,
+ * so bitwise operations run on whole vectors; padding bits are always zero.
+ *
+ * Words before first_word are empty whatever they hold, and operations
+ * skip them. Once the smallest elements can no longer be in a set (e.g.
+ * vertices branched on, when vertices are labeled in processing order),
+ * trim() moves first_word past its leading empty words, so that the
+ * words left to operate on shrink as the set does.
  */
 struct IntSet {
 
@@ -33,6 +49,15 @@ struct IntSet {
     /** Empty constructor */
     IntSet();
 
+    /** Copy constructor */
+    IntSet(const IntSet& other);
+
+    /** Copy constructor placing the words in given storage (used if set is not inline) */
+    IntSet(const IntSet& other, uint64_t* storage);
+
+    /** Destructor */
+    ~IntSet();
+
     /** Check if set contains element */
     bool contains(int elem);
 
@@ -68,6 +93,9 @@ struct IntSet {
 
     /** Take the intersection with another intset */
     void intersect_with(IntSet& intset);
+
+    /** Remove all elements of another intset */
+    void difference_with(IntSet& intset);
     
     /** Checks if one intersects with the other intset */
     void does_intersect(IntSet& intset);
@@ -81,15 +109,36 @@ struct IntSet {
     /** Returns if one set equals another */
     bool equals_to(const IntSet& other);
 
+    /** Returns if set comes before another in lexicographic order */
+    bool lex_less(const IntSet& other) const;
+
+    /** Get number of elements in exactly one of the two sets */
+    int get_symmetric_difference_size(const IntSet& other) const;
+
+    /** Get 64-bit hash of the set */
+    uint64_t get_hash() const;
+
+    /** Skip the leading empty words in later operations */
+    void trim();
+
 
     // parameters
 
-    boost::dynamic_bitset<>     set;            /**< bitvector representing the set */
+    uint64_t*                   words;          /**< bitvector representing the set */
+    int                         n_words;        /**< number of words of the bitvector */
+    int                         first_word;     /**< words before this one are empty (multiple of WORDOPS_VECTOR_WORDS) */
+    bool                        external_words; /**< if words are stored (and freed) elsewhere */
     const int                   end;            /**< position beyond end of the set */
     int                         size;           /**< number of elements in the set */
     int                         min;            /**< minimum possible element of the set */
     int                         max;            /**< maximum possible element of the set */
     //int                         shift;          /**< shift of element to be added in the set */
+
+    uint64_t                    inline_words[INTSET_INLINE_WORDS];  /**< storage of small sets */
+
+private:
+    void allocate(int _n_words);
+    void release();
 };
 
 
@@ -98,12 +147,62 @@ struct IntSet {
  */
 struct IntSetLexLessThan {
     bool operator()(const IntSet* setA, const IntSet* setB) const {
-        return setA->set < setB->set;
+        return setA->lex_less(*setB);
     }
 };
 
 
 
+/**
+ * Mixing function for hashing (splitmix64 finalizer)
+ */
+inline uint64_t mix_hash_word(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Hash of words [first, n_words) of a sequence of 64-bit words (zero words do not
+ * contribute, so words before first may be taken as zero)
+ */
+inline uint64_t hash_words(const uint64_t* words, int n_words, int first = 0) {
+    uint64_t h = 0;
+    for( int i = first; i < n_words; i++ ) {
+        if( words[i] != 0 ) {
+            h += mix_hash_word(words[i] ^ (0x9e3779b97f4a7c15ULL * (uint64_t)(i+1)));
+        }
+    }
+    return h;
+}
+
+/**
+ * Check if any of the words [from, to) is not zero
+ */
+inline bool any_word_in(const uint64_t* words, int from, int to) {
+    for( int i = from; i < to; i++ ) {
+        if( words[i] != 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Number of words needed to store a number of bits
+ */
+inline int intset_words_for_bits(int n_bits) {
+    int n_words = (n_bits + 63) / 64;
+    if( n_words > INTSET_SMALL_WORDS ) {
+        n_words = ((n_words + WORDOPS_VECTOR_WORDS - 1) / WORDOPS_VECTOR_WORDS) * WORDOPS_VECTOR_WORDS;
+    }
+    return n_words;
+}
+
+
 /**
  * -----------------------------------------------
  * Inline implementations
@@ -113,7 +212,7 @@ struct IntSetLexLessThan {
 /**
  * Constructor
  */
-inline IntSet::IntSet(int _min, int _max, bool _filled) : end((int)set.npos) {
+inline IntSet::IntSet(int _min, int _max, bool _filled) : words(inline_words), n_words(0), first_word(0), external_words(false), end(-1) {
     resize(_min, _max, _filled);
     size = NOT_COMPUTED;
 }
@@ -121,7 +220,65 @@ inline IntSet::IntSet(int _min, int _max, bool _filled) : end((int)set.npos) {
 /**
  * Empty constructor
  */
-inline IntSet::IntSet() : end((int)set.npos) {
+inline IntSet::IntSet() : words(inline_words), n_words(0), first_word(0), external_words(false), end(-1), size(0), min(0), max(-1) {
+}
+
+/**
+ * Copy constructor
+ */
+inline IntSet::IntSet(const IntSet& other)
+    : words(inline_words), n_words(0), first_word(other.first_word), external_words(false), end(-1),
+      size(other.size), min(other.min), max(other.max)
+{
+    allocate(other.n_words);
+    memcpy(words + first_word, other.words + first_word, sizeof(uint64_t)*(n_words - first_word));
+}
+
+/**
+ * Copy constructor placing the words in given storage
+ */
+inline IntSet::IntSet(const IntSet& other, uint64_t* storage)
+    : words(inline_words), n_words(0), first_word(other.first_word), external_words(false), end(-1),
+      size(other.size), min(other.min), max(other.max)
+{
+    if( other.n_words > INTSET_INLINE_WORDS && storage != NULL ) {
+        words = storage;
+        n_words = other.n_words;
+        external_words = true;
+    } else {
+        allocate(other.n_words);
+    }
+    memcpy(words + first_word, other.words + first_word, sizeof(uint64_t)*(n_words - first_word));
+}
+
+/**
+ * Destructor
+ */
+inline IntSet::~IntSet() {
+    release();
+}
+
+/**
+ * Set storage for a number of words (contents are undefined)
+ */
+inline void IntSet::allocate(int _n_words) {
+    if( _n_words != n_words ) {
+        release();
+        words = ( _n_words > INTSET_INLINE_WORDS ) ? new uint64_t[_n_words] : inline_words;
+        n_words = _n_words;
+    }
+}
+
+/**
+ * Free heap storage, if any
+ */
+inline void IntSet::release() {
+    if( words != inline_words && !external_words ) {
+        delete[] words;
+    }
+    words = inline_words;
+    external_words = false;
+    n_words = 0;
 }
 
 
@@ -130,7 +287,8 @@ inline IntSet::IntSet() : end((int)set.npos) {
  */
 inline bool IntSet::contains(int elem) {
     assert( elem >= min && elem <= max );
-    return( set.test(elem) );
+    int i = elem >> 6;
+    return( i >= first_word && ((words[i] >> (elem & 63)) & 1) );
 }
 
 
@@ -139,14 +297,23 @@ inline bool IntSet::contains(int elem) {
  */
 inline void IntSet::add(int elem) {
     assert( elem >= min && elem <= max );
-    set.set(elem, true);
+    int i = elem >> 6;
+    if( i < first_word ) {
+        int from = i - (i % WORDOPS_VECTOR_WORDS);
+        memset(words + from, 0, sizeof(uint64_t)*(first_word - from));
+        first_word = from;
+    }
+    words[i] |= (uint64_t)1 << (elem & 63);
     size = NOT_COMPUTED;
 }
 
 /** Remove element, if it is contained */
 inline void IntSet::remove(int elem) {
     assert( elem >= min && elem <= max );
-    set.set(elem, false);
+    int i = elem >> 6;
+    if( i >= first_word ) {
+        words[i] &= ~((uint64_t)1 << (elem & 63));
+    }
     size = NOT_COMPUTED;
 }
 
@@ -154,7 +321,12 @@ inline void IntSet::remove(int elem) {
  * Get the first element of the set
  */
 inline int IntSet::get_first() {
-    return (set.find_first());
+    for( int i = first_word; i < n_words; i++ ) {
+        if( words[i] != 0 ) {
+            return (i << 6) + count_trailing_zeros_word(words[i]);
+        }
+    }
+    return end;
 }
 
 /**
@@ -162,7 +334,24 @@ inline int IntSet::get_first() {
  */
 inline int IntSet::get_next(int elem) {
     assert( elem >= min && elem <= max );
-    return (set.find_next(elem));
+    elem++;
+    int i = elem >> 6;
+    uint64_t keep = ~(uint64_t)0 << (elem & 63);
+    if( i < first_word ) {
+        i = first_word;
+        keep = ~(uint64_t)0;
+    }
+    if( i >= n_words ) {
+        return end;
+    }
+    uint64_t word = words[i] & keep;
+    while( word == 0 ) {
+        if( ++i == n_words ) {
+            return end;
+        }
+        word = words[i];
+    }
+    return (i << 6) + count_trailing_zeros_word(word);
 }
 
 /**
@@ -176,7 +365,8 @@ inline const int IntSet::get_end() {
  * Clear set
  */
 inline void IntSet::clear() {
-    set.reset();
+    memset(words, 0, sizeof(uint64_t)*n_words);
+    first_word = 0;
     size = 0;
 }
 
@@ -187,7 +377,9 @@ inline void IntSet::clear() {
 inline IntSet& IntSet::operator=(const IntSet& rhs) {
     assert(rhs.max == max && rhs.min == min);
     if (this != &rhs) {
-        set = rhs.set;
+        allocate(rhs.n_words);
+        first_word = rhs.first_word;
+        memcpy(words + first_word, rhs.words + first_word, sizeof(uint64_t)*(n_words - first_word));
         size = NOT_COMPUTED;
     }
     return *this;
@@ -206,12 +398,12 @@ inline void IntSet::resize(int _min, int _max, bool _filled) {
     min = _min;
     max = _max;
 
-    set.resize(max - min + 1);
+    allocate(intset_words_for_bits(max - min + 1));
 
     if( _filled )
-        set.set();
+        add_all_elements();
     else
-        set.reset();
+        clear();
 
     size = NOT_COMPUTED;
 }
@@ -220,7 +412,15 @@ inline void IntSet::resize(int _min, int _max, bool _filled) {
  * Take the union with another intset
  */
 inline void IntSet::union_with(IntSet& intset) {
-    set |= intset.set;
+    int from = MAX(first_word, intset.first_word);
+    if( intset.first_word < first_word ) {
+        memcpy(words + intset.first_word, intset.words + intset.first_word, sizeof(uint64_t)*(first_word - intset.first_word));
+        first_word = intset.first_word;
+    }
+    if( n_words <= INTSET_SMALL_WORDS )
+        or_words_scalar(words + from, intset.words + from, n_words - from);
+    else
+        word_ops.or_words(words + from, intset.words + from, n_words - from);
     size = NOT_COMPUTED;
 }
 
@@ -228,14 +428,33 @@ inline void IntSet::union_with(IntSet& intset) {
  * Take the intersection with another intset
  */
 inline void IntSet::intersect_with(IntSet& intset) {
-    set &= intset.set;
+    first_word = MAX(first_word, intset.first_word);
+    if( n_words <= INTSET_SMALL_WORDS )
+        and_words_scalar(words + first_word, intset.words + first_word, n_words - first_word);
+    else
+        word_ops.and_words(words + first_word, intset.words + first_word, n_words - first_word);
+    size = NOT_COMPUTED;
+}
+
+/**
+ * Remove all elements of another intset
+ */
+inline void IntSet::difference_with(IntSet& intset) {
+    int from = MAX(first_word, intset.first_word);
+    if( n_words <= INTSET_SMALL_WORDS )
+        andnot_words_scalar(words + from, intset.words + from, n_words - from);
+    else
+        word_ops.andnot_words(words + from, intset.words + from, n_words - from);
     size = NOT_COMPUTED;
 }
 
 /** Get number of elements in the set */
 inline int IntSet::get_size() {
     if( size == NOT_COMPUTED ) {
-        size = set.count();
+        if( n_words <= INTSET_SMALL_WORDS )
+            size = count_words_scalar(words + first_word, n_words - first_word);
+        else
+            size = word_ops.count_words(words + first_word, n_words - first_word);
     }
     return size;
 }
@@ -244,8 +463,14 @@ inline int IntSet::get_size() {
  * Add all possible elements to the set
  */
 inline void IntSet::add_all_elements() {
-    set.set();
-    size = set.size();
+    int n_bits = max - min + 1;
+    first_word = 0;
+    memset(words, 0, sizeof(uint64_t)*n_words);
+    memset(words, 0xff, sizeof(uint64_t)*(n_bits >> 6));
+    if( (n_bits & 63) != 0 ) {
+        words[n_bits >> 6] = ((uint64_t)1 << (n_bits & 63)) - 1;
+    }
+    size = n_bits;
 }
 
 
@@ -268,17 +493,79 @@ inline std::ostream& operator<<(std::ostream &os, IntSet &intset) {
  * Returns if set is a subset of another 
  */
 inline bool IntSet::is_subset(const IntSet& other) {
-    return set.is_subset_of(other.set);
+    assert( n_words == other.n_words );
+    int from = MAX(first_word, other.first_word);
+    if( any_word_in(words, first_word, from) )
+        return false;
+    if( n_words <= INTSET_SMALL_WORDS )
+        return subset_words_scalar(words + from, other.words + from, n_words - from);
+    return word_ops.subset_words(words + from, other.words + from, n_words - from);
 }
 
 /**
  * Returns if one is equal to the other
  */
 inline bool IntSet::equals_to(const IntSet& other) {
-	return (set == other.set);
+    assert( n_words == other.n_words );
+    int from = MAX(first_word, other.first_word);
+    if( any_word_in(words, first_word, from) || any_word_in(other.words, other.first_word, from) )
+        return false;
+    if( n_words <= INTSET_SMALL_WORDS )
+        return equal_words_scalar(words + from, other.words + from, n_words - from);
+    return word_ops.equal_words(words + from, other.words + from, n_words - from);
 }
 
+/**
+ * Returns if set comes before another in lexicographic order
+ * (the bitvectors are compared as numbers, highest element first)
+ */
+inline bool IntSet::lex_less(const IntSet& other) const {
+    assert( n_words == other.n_words );
+    int from = MAX(first_word, other.first_word);
+    for( int i = n_words-1; i >= from; i-- ) {
+        if( words[i] != other.words[i] ) {
+            return words[i] < other.words[i];
+        }
+    }
+    // below, only the words of the set starting first may be nonzero
+    return any_word_in(other.words, other.first_word, from);
+}
 
+/**
+ * Get number of elements in exactly one of the two sets
+ */
+inline int IntSet::get_symmetric_difference_size(const IntSet& other) const {
+    assert( n_words == other.n_words );
+    int from = MAX(first_word, other.first_word);
+    int n_skipped = 0;
+    for( int i = first_word; i < from; i++ ) {
+        n_skipped += popcount_word(words[i]);
+    }
+    for( int i = other.first_word; i < from; i++ ) {
+        n_skipped += popcount_word(other.words[i]);
+    }
+    if( n_words <= INTSET_SMALL_WORDS )
+        return n_skipped + xor_count_words_scalar(words + from, other.words + from, n_words - from);
+    return n_skipped + word_ops.xor_count_words(words + from, other.words + from, n_words - from);
+}
 
-#endif /* INTSET_HPP_ */
+/**
+ * Get 64-bit hash of the set
+ */
+inline uint64_t IntSet::get_hash() const {
+    return hash_words(words, n_words, first_word);
+}
 
+/**
+ * Skip the leading empty words in later operations, a vector at a time
+ */
+inline void IntSet::trim() {
+    while( first_word + WORDOPS_VECTOR_WORDS <= n_words && n_words > INTSET_SMALL_WORDS
+            && !any_word_in(words, first_word, first_word + WORDOPS_VECTOR_WORDS) ) {
+        first_word += WORDOPS_VECTOR_WORDS;
+    }
+}
+
+
+
+#endif /* INTSET_HPP_ */
@@ -0,0 +1,149 @@
+/*
+ * --------------------------------------------------------
+ * Kernelization of independent set instances
+ *
+ * Reductions that keep the optimal value, applied until
+ * none is left before any diagram is built:
+ *
+ *  - neighborhood: v at least as heavy as its neighbors
+ *    of positive weight together is taken (covers
+ *    isolated vertices, and pendant vertices at least as
+ *    heavy as their neighbor)
+ *  - pendant folding: a lighter pendant vertex v of u is
+ *    removed and its weight taken from u (u or v is in an
+ *    optimal solution)
+ *  - degree 2 folding: v with non-adjacent neighbors a, b,
+ *    w(v) >= max(w(a), w(b)), becomes a vertex z replacing
+ *    v, a and b, of weight w(a) + w(b) - w(v) (either v or
+ *    both a and b are in an optimal solution)
+ *  - domination: a neighbor u of v with N[v] in N[u] and
+ *    w(u) <= w(v) is removed (simplicial vertices end up
+ *    isolated)
+ *  - twins: non-adjacent u, v with N(u) = N(v) are merged
+ *  - vertices of nonpositive weight are removed
+ *
+ * The kernel is a new instance of the vertices left. The
+ * weight fixed by the reductions is added to its bounds,
+ * and solutions are lifted back by undoing the reductions
+ * in reverse order.
+ * --------------------------------------------------------
+ */
+
+#ifndef KERNELIZATION_HPP_
+#define KERNELIZATION_HPP_
+
+#include <vector>
+#include "instance.hpp"
+
+using namespace std;
+
+
+/**
+ * Reduction undone when lifting solutions
+ */
+struct KernelStep {
+	enum Type { Take, Pendant, Fold, Twin };
+
+	Type	type;
+	int		v;			/**< vertex taken, pendant, center of fold, or twin merged away */
+	int		u;			/**< neighbor of the pendant, first neighbor of fold, or twin kept */
+	int		w;			/**< second neighbor of fold */
+	int		z;			/**< vertex made by fold */
+
+	KernelStep(Type _type, int _v, int _u = -1, int _w = -1, int _z = -1)
+		: type(_type), v(_v), u(_u), w(_w), z(_z) { }
+};
+
+
+/**
+ * Kernel of an instance and the map to lift its solutions
+ */
+struct Kernelization {
+
+	IndepSetInst*			kernel;				/**< instance of the vertices left (owned) */
+	int						offset;				/**< weight of the reductions, added to kernel bounds */
+	vector<int>				kernel_vertex;		/**< vertex of the kernel standing for each original vertex (-1 if none) */
+
+	long					n_taken;			/**< vertices taken by neighborhood reduction */
+	long					n_pendant;			/**< pendant vertices folded */
+	long					n_folded;			/**< degree 2 vertices folded */
+	long					n_dominated;		/**< vertices removed by domination */
+	long					n_twins;			/**< twins merged */
+	long					n_nonpositive;		/**< vertices of nonpositive weight removed */
+	double					seconds;			/**< time of the reductions */
+
+	/** Constructor */
+	Kernelization();
+
+	/** Destructor */
+	~Kernelization();
+
+	/** Reduce an instance (vertices are taken in increasing order) */
+	void reduce(IndepSetInst* inst);
+
+	/** Bound of the original instance from a bound of the kernel */
+	int lift_bound(int kernel_bound) const { return kernel_bound + offset; }
+
+	/** Solution of the original instance from a solution of the kernel (lists of vertices) */
+	void lift_solution(const vector<int> &kernel_solution, vector<int> &solution) const;
+
+private:
+	int						n_original;			/**< vertices of the original instance */
+	vector< vector<int> >	adj;				/**< sorted neighbors of each vertex (made by folds too) */
+	vector<int>				weight;				/**< weight of each vertex */
+	vector<int>				original_of;		/**< original vertex standing for each vertex */
+	vector<char>			alive;				/**< vertices not reduced yet */
+	vector<int>				kernel_of;			/**< vertex of the kernel (-1 if reduced) */
+	vector<int>				kernel_id;			/**< vertex of each kernel vertex */
+	vector<KernelStep>		steps;				/**< reductions, in the order applied */
+
+	vector<int>				queue;				/**< vertices to check */
+	vector<char>			queued;
+	size_t					queue_head;
+
+	void	push(int v);
+	void	remove_vertex(int v);
+	int		add_vertex(const vector<int> &neighbors, int w, int original);
+	bool	reduce_vertex(int v);
+	bool	dominates(int v, int u);
+	int		find_twin(int v);
+	void	build_kernel(IndepSetInst* inst);
+};
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Constructor
+ */
+inline Kernelization::Kernelization()
+	: kernel(NULL), offset(0), n_taken(0), n_pendant(0), n_folded(0), n_dominated(0), n_twins(0),
+	  n_nonpositive(0), seconds(0), n_original(0), queue_head(0)
+{
+}
+
+
+/**
+ * Destructor
+ */
+inline Kernelization::~Kernelization() {
+	delete kernel;
+}
+
+
+/**
+ * Add vertex to the queue of vertices to check, if it is not there
+ */
+inline void Kernelization::push(int v) {
+	if( !queued[v] ) {
+		queued[v] = 1;
+		queue.push_back(v);
+	}
+}
+
+
+#endif /* KERNELIZATION_HPP_ */
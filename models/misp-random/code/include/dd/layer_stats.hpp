@@ -0,0 +1,135 @@
+/*
+ * --------------------------------------------------------
+ * Per-layer counters of diagram construction
+ *
+ * Counters and phase timers (in nanoseconds) recorded for
+ * each layer of the last diagram built step by step. They
+ * are collected unless compiled with -DDD_STATS=0, in which
+ * case the DD_STAT statements vanish and the log stays
+ * empty. Each record is a row of longs, in the order of
+ * LAYER_STATS_NAMES, so that it can be copied to callers
+ * of the C interface as is.
+ * --------------------------------------------------------
+ */
+
+#ifndef LAYER_STATS_HPP_
+#define LAYER_STATS_HPP_
+
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+#ifndef DD_STATS
+#define DD_STATS 1
+#endif
+
+#if DD_STATS
+#define DD_STAT(statement) statement
+#else
+#define DD_STAT(statement)
+#endif
+
+/** Field names of a record, in memory order */
+#define LAYER_STATS_NAMES "pool_size", "layer_size", "nodes_created", "dedup_hits", "nodes_merged", \
+	"bytes_allocated", "ns_extract", "ns_merge", "ns_branch", "ns_dedup", "ns_inference"
+
+
+/**
+ * Counters of a layer
+ */
+struct LayerStats {
+	long	pool_size;			/**< nodes stored before the layer is taken out */
+	long	layer_size;			/**< nodes of the layer before merging or restricting */
+	long	nodes_created;		/**< children created by branching */
+	long	dedup_hits;			/**< children matched to a node with the same state */
+	long	nodes_merged;		/**< nodes merged (relaxation) or removed (restriction) */
+	long	bytes_allocated;	/**< bytes requested from the heap for nodes */
+	long	ns_extract;			/**< taking the layer out of the pool */
+	long	ns_merge;			/**< merging or restricting the layer */
+	long	ns_branch;			/**< branching, including dedup */
+	long	ns_dedup;			/**< matching children to existing nodes (parallel branching) */
+	long	ns_inference;		/**< choosing the vertex of the layer (set by the caller) */
+
+	LayerStats() : pool_size(0), layer_size(0), nodes_created(0), dedup_hits(0), nodes_merged(0),
+			bytes_allocated(0), ns_extract(0), ns_merge(0), ns_branch(0), ns_dedup(0), ns_inference(0) { }
+};
+
+#define LAYER_STATS_FIELDS ((int)(sizeof(LayerStats) / sizeof(long)))
+
+
+/**
+ * Records of the layers of a diagram
+ */
+struct LayerStatsLog {
+	vector<LayerStats>	layers;
+
+	/** Record of a layer (added if needed) */
+	LayerStats& at(int layer);
+
+	/** Add the records of another log, layer by layer */
+	void add(const LayerStatsLog &other);
+
+	/** Copy at most max_layers records to an array of longs, returning how many were copied */
+	int copy_to(long* out, int max_layers) const;
+
+	/** Discard all records */
+	void clear() { layers.clear(); }
+};
+
+
+/**
+ * Monotonic clock in nanoseconds
+ */
+inline long stats_clock_ns() {
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Record of a layer
+ */
+inline LayerStats& LayerStatsLog::at(int layer) {
+	if( layer >= (int)layers.size() ) {
+		layers.resize(layer+1);
+	}
+	return layers[layer];
+}
+
+
+/**
+ * Add the records of another log
+ */
+inline void LayerStatsLog::add(const LayerStatsLog &other) {
+	for( int l = 0; l < (int)other.layers.size(); l++ ) {
+		long* to = (long*)&at(l);
+		const long* from = (const long*)&other.layers[l];
+		for( int f = 0; f < LAYER_STATS_FIELDS; f++ ) {
+			to[f] += from[f];
+		}
+	}
+}
+
+
+/**
+ * Copy records to an array of longs, one row of LAYER_STATS_FIELDS per layer
+ */
+inline int LayerStatsLog::copy_to(long* out, int max_layers) const {
+	int n_layers = ( (int)layers.size() < max_layers ) ? (int)layers.size() : max_layers;
+	for( int l = 0; l < n_layers; l++ ) {
+		const long* from = (const long*)&layers[l];
+		for( int f = 0; f < LAYER_STATS_FIELDS; f++ ) {
+			out[l*LAYER_STATS_FIELDS + f] = from[f];
+		}
+	}
+	return n_layers;
+}
+
+
+#endif /* LAYER_STATS_HPP_ */
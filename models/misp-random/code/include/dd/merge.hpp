@@ -13,10 +13,14 @@
 #include <cstdio>
 #include <vector>
 #include <list>
+#include <set>
 
 
 #include "instance.hpp"
 #include "bdd.hpp"
+#include "node_table.hpp"
+#include "node_arena.hpp"
+#include "compact_dd.hpp"
 
 using namespace std;
 
@@ -27,12 +31,33 @@ struct IS_Merging {
 	IndepSetInst   		*inst;
 	char           		name[256];
 	int					width;
-	double				gap = 0;
+	double				gap = 0;		/**< sum of symmetric differences of the states merged in last layer */
+	bool				track_gap;		/**< if gap is computed (only needed by the merge reward) */
+	NodeArena			*arena;			/**< allocator of the layer nodes (NULL if allocated with new) */
+	CompactDDBuilder	*dd_builder;	/**< records merges of a materialized diagram (NULL if none) */
 
-	IS_Merging(IndepSetInst* _inst, int _width) : inst(_inst), width(_width) { }
+	IS_Merging(IndepSetInst* _inst, int _width) : inst(_inst), width(_width), track_gap(true), arena(NULL), dd_builder(NULL) { }
+
+	virtual ~IS_Merging() { }
 
 	// returns vertex corresponding to particular layer
 	virtual void merge_layer(int layer, vector<Node*> &nodes_layer) = 0;
+
+	// accounts for the merge of two states: |A u B| - |A n B| = |A xor B|
+	void add_gap(IntSet &stateA, IntSet &stateB) {
+		if( track_gap )
+			gap += stateA.get_symmetric_difference_size(stateB);
+	}
+
+	// deletes a node that was merged into another one
+	void release_node(Node* node, Node* into) {
+		if( dd_builder != NULL )
+			dd_builder->merge(node, into);
+		if( arena != NULL )
+			arena->destroy(node);
+		else
+			delete node;
+	}
 };
 
 
@@ -50,7 +75,7 @@ struct MinLongestPath : IS_Merging {
 // Minimum longest path: Pair by Pair
 struct PairMinLongestPath : IS_Merging {
 
-	NodeMap	current_states;		/**< current layer states */
+	NodeTable	current_states;		/**< current layer states */
 
 	PairMinLongestPath(IndepSetInst *_inst, int _width) : IS_Merging(_inst, _width) {
 		sprintf(name, "pair_lp");
@@ -105,7 +130,7 @@ struct MaxSizeMerger : IS_Merging {
 // Lexicographic merger
 struct LexicographicMerger : IS_Merging {
 
-	NodeMap	current_states;		/**< current layer states */
+	NodeMap	current_states;		/**< current layer states (ordered view) */
 
 	LexicographicMerger(IndepSetInst *_inst, int _width) : IS_Merging(_inst, _width) {
 		sprintf(name, "lex");
@@ -116,52 +141,105 @@ struct LexicographicMerger : IS_Merging {
 
 
 // Symmetric Difference merger
-struct SymmetricDifferenceMerger : IS_Merging {
-
-	typedef pair<Node*,Node*> NodePair;
+//
+// Repeatedly merges the pair of nodes with the largest symmetric difference
+// (ties: smallest longest path). Modes:
+//  - SymmDiffAllPairs: recomputes and sorts all pairs before each merge, the
+//      pairs in the current lexicographic order of the nodes, as the original
+//      merger did (other ties are left to std::sort, so bounds are the same)
+//  - SymmDiffIncremental: ties broken by the first pair in the initial
+//      lexicographic order, keeping pairs in a priority queue;
+//      only pairs of the node that changed are added after a merge, and
+//      entries of merged nodes are skipped when they reach the top
+//  - SymmDiffSketch: approximate, for very wide layers. States are projected
+//      on random +1/-1 vertex weights (and on their size); only pairs taken
+//      from opposite extremes of a projection are compared
+enum SymmDiffMode {
+	SymmDiffAllPairs,
+	SymmDiffIncremental,
+	SymmDiffSketch
+};
 
-	NodeMap					current_states;		/**< current layer states */
-	IntSet  				aux;
-	vector<NodePair> 		node_pairs;
+#define SYMM_DIFF_SKETCH_PROJECTIONS	8		/**< projections of the sketch mode */
+#define SYMM_DIFF_SKETCH_EXTREMES		4		/**< nodes taken from each end of a projection */
 
-	vector<int>				symm_diff_vals;		/**< symmetric difference */
-	vector<int>				longest_path_val;	/**< value of longest path with pairs are merged */
-	vector<int>				indices;
+struct SymmetricDifferenceMerger : IS_Merging {
 
 	/**
-	 * Comparator by symmetric difference and longest path
+	 * Pair of layer nodes, identified by their positions in the initial layer (a is merged
+	 * into b; a < b except in the all-pairs mode)
 	 */
-	struct ComparatorNodePairSymmLP {
-
-		vector<int>	 &symm_diff_vals;
-		vector<int>	 &longest_path_val;
+	struct PairEntry {
+		int		symm_diff;			/**< symmetric difference of the states */
+		int		longest_path;		/**< longest path of the merged node */
+		int		a, b;
+		int		version_a;			/**< versions of the nodes when pair was evaluated */
+		int		version_b;
+	};
 
-		ComparatorNodePairSymmLP(vector<int> &_symm_diff_vals, vector<int> &_longest_path_val)
-		: symm_diff_vals(_symm_diff_vals), longest_path_val(_longest_path_val) { }
+	/**
+	 * Pair comparator: true if pairA is merged after pairB
+	 */
+	struct ComparePairEntry {
+		bool operator()(const PairEntry &pairA, const PairEntry &pairB) const {
+			if( pairA.symm_diff != pairB.symm_diff )
+				return pairA.symm_diff < pairB.symm_diff;
+			if( pairA.longest_path != pairB.longest_path )
+				return pairA.longest_path > pairB.longest_path;
+			if( pairA.a != pairB.a )
+				return pairA.a > pairB.a;
+			return pairA.b > pairB.b;
+		}
+	};
 
-		bool operator()(int pairA, int pairB) {
-			if( symm_diff_vals[pairA] != symm_diff_vals[pairB] )
-				return symm_diff_vals[pairA] < symm_diff_vals[pairB];
-			return longest_path_val[pairA] > longest_path_val[pairB];
+	/**
+	 * Pair comparator of the all-pairs mode, without tie-breaking by position
+	 */
+	struct ComparePairEntrySymmLP {
+		bool operator()(const PairEntry &pairA, const PairEntry &pairB) const {
+			if( pairA.symm_diff != pairB.symm_diff )
+				return pairA.symm_diff < pairB.symm_diff;
+			return pairA.longest_path > pairB.longest_path;
 		}
 	};
 
+	SymmDiffMode			mode;
 
+	NodeTable				current_states;		/**< current layer states */
+	vector<Node*>			layer_nodes;		/**< node at each initial position (NULL once merged away) */
+	vector<int>				layer_versions;		/**< incremented when state or longest path of a node changes */
+	int						n_alive;			/**< nodes left in the layer */
 
-	SymmetricDifferenceMerger(IndepSetInst *_inst, int _width) : IS_Merging(_inst, _width) {
-		sprintf(name, "symmetric_diff");
+	vector<PairEntry>		pairs;				/**< all pairs, or priority queue of pairs */
+	vector<int>				lex_positions;		/**< positions of the nodes left, in lexicographic order of their states */
 
-		aux.resize(0, inst->graph->n_vertices-1, false);
+	int						n_projections;		/**< sketch mode parameters */
+	int						n_extremes;
+	vector<uint64_t>		projection_masks;	/**< vertices of weight +1 of each projection */
+	vector<int>				projection_vals;	/**< projection values of each node */
+	vector< set< pair<int,int> > >	projection_order;	/**< (value, node) of each projection */
+	vector<int>				top_nodes;
+	vector<int>				bottom_nodes;
 
-		node_pairs.reserve(inst->graph->n_vertices * inst->graph->n_vertices+1);
-		indices.reserve(inst->graph->n_vertices * inst->graph->n_vertices+1);
-		if( width != -1 ) {
-			symm_diff_vals.reserve(width*width+1);
-			longest_path_val.reserve(width*width+1);
-		}
+	SymmetricDifferenceMerger(IndepSetInst *_inst, int _width, SymmDiffMode _mode = SymmDiffIncremental)
+		: IS_Merging(_inst, _width), mode(_mode), n_alive(0),
+		  n_projections(SYMM_DIFF_SKETCH_PROJECTIONS), n_extremes(SYMM_DIFF_SKETCH_EXTREMES)
+	{
+		sprintf(name, "symmetric_diff");
 	}
 
 	void merge_layer(int layer, vector<Node*> &nodes_layer);
+
+private:
+	void merge_all_pairs();
+	void merge_incremental();
+	void merge_sketch();
+
+	PairEntry evaluate_pair(int a, int b);
+	int  merge_pair(int a, int b);				/**< returns position of resulting node */
+	void push_pairs_of(int a);
+	void set_projections(int a);
+	void unset_projections(int a);
 };
 
 
@@ -0,0 +1,249 @@
+/*
+ * --------------------------------------------------------
+ * Slab allocator for BDD nodes
+ *
+ * A node and the words of its state are allocated in one
+ * fixed-size slot. Slots are carved from large slabs and
+ * recycled through a free list, so creating and deleting
+ * nodes does not call the heap. Resetting the arena makes
+ * all slots available again in O(1); slabs are kept for
+ * the next diagram.
+ *
+ * Nodes of an arena own no heap memory (their state words
+ * are inline or in the slot), which is why a reset can skip
+ * their destructors.
+ * --------------------------------------------------------
+ */
+
+#ifndef NODE_ARENA_HPP_
+#define NODE_ARENA_HPP_
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+#include "bdd.hpp"
+
+using namespace std;
+
+#define NODE_ARENA_SLAB_BYTES (1 << 20)		/**< size of each slab */
+
+
+/**
+ * Allocation counters of an arena
+ */
+struct NodeArenaStats {
+	long	n_created;		/**< nodes created */
+	long	n_destroyed;	/**< nodes destroyed one by one */
+	long	n_resets;		/**< times the arena was reset */
+	long	n_slabs;		/**< slabs allocated (heap allocations) */
+	long	slab_bytes;		/**< bytes allocated for slabs */
+	long	max_live;		/**< maximum number of nodes alive at once */
+
+	NodeArenaStats() : n_created(0), n_destroyed(0), n_resets(0), n_slabs(0), slab_bytes(0), max_live(0) { }
+};
+
+
+struct NodeArena {
+
+	int				n_state_words;		/**< words stored in the slot after the node (0 if state is inline) */
+	size_t			slot_bytes;			/**< size of a slot */
+	int				slots_per_slab;		/**< number of slots of each slab */
+
+	vector<char*>	slabs;				/**< allocated slabs */
+	int				current_slab;		/**< slab being carved */
+	int				next_slot;			/**< first unused slot of the current slab */
+	void*			free_list;			/**< slots of destroyed nodes */
+	long			n_live;				/**< nodes currently alive */
+
+	NodeArenaStats	stats;				/**< allocation counters */
+
+	/** Constructor */
+	NodeArena();
+
+	/** Destructor: frees all slabs */
+	~NodeArena();
+
+	/** Set number of possible state elements (only when no nodes are alive) */
+	void set_state_size(int n_elements);
+
+	/** Create a node */
+	Node* create(IntSet &state, int longest_path);
+
+	/** Destroy a node created by this arena */
+	void destroy(Node* node);
+
+	/** Make all slots available again (nodes alive are discarded) */
+	void reset();
+
+	/** Hand all nodes alive (and their slabs) over to an arena without nodes */
+	void give_nodes(NodeArena &to);
+
+	/** Print allocation counters */
+	void print_stats(ostream &os);
+
+private:
+	void* take_slot();
+};
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Constructor
+ */
+inline NodeArena::NodeArena()
+	: n_state_words(0), slot_bytes(0), slots_per_slab(0), current_slab(0), next_slot(0), free_list(NULL), n_live(0)
+{
+	set_state_size(0);
+}
+
+
+/**
+ * Destructor
+ */
+inline NodeArena::~NodeArena() {
+	for( int i = 0; i < (int)slabs.size(); i++ ) {
+		free(slabs[i]);
+	}
+}
+
+
+/**
+ * Set number of possible state elements
+ */
+inline void NodeArena::set_state_size(int n_elements) {
+	assert( n_live == 0 );
+
+	int words = intset_words_for_bits(n_elements);
+	n_state_words = ( words > INTSET_INLINE_WORDS ) ? words : 0;
+
+	size_t new_slot_bytes = sizeof(Node) + sizeof(uint64_t)*n_state_words;
+	new_slot_bytes = (new_slot_bytes + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+
+	// slabs of a different slot size cannot be reused
+	if( new_slot_bytes != slot_bytes ) {
+		for( int i = 0; i < (int)slabs.size(); i++ ) {
+			free(slabs[i]);
+		}
+		slabs.clear();
+		slot_bytes = new_slot_bytes;
+		slots_per_slab = MAX(1, (int)(NODE_ARENA_SLAB_BYTES / slot_bytes));
+	}
+	reset();
+}
+
+
+/**
+ * Create a node
+ */
+inline Node* NodeArena::create(IntSet &state, int longest_path) {
+	assert( state.n_words <= INTSET_INLINE_WORDS || state.n_words == n_state_words );
+
+	void* slot = take_slot();
+	uint64_t* state_words = ( n_state_words > 0 ) ? (uint64_t*)((char*)slot + sizeof(Node)) : NULL;
+
+	stats.n_created++;
+	n_live++;
+	stats.max_live = MAX(stats.max_live, n_live);
+
+	return new (slot) Node(state, longest_path, state_words);
+}
+
+
+/**
+ * Destroy a node created by this arena
+ */
+inline void NodeArena::destroy(Node* node) {
+	node->~Node();
+	*(void**)node = free_list;
+	free_list = node;
+
+	stats.n_destroyed++;
+	n_live--;
+}
+
+
+/**
+ * Make all slots available again
+ */
+inline void NodeArena::reset() {
+	current_slab = 0;
+	next_slot = 0;
+	free_list = NULL;
+	n_live = 0;
+	stats.n_resets++;
+}
+
+
+/**
+ * Hand all nodes alive over to another arena: its slabs are freed and replaced by the
+ * slabs of this arena, which is left empty. Nodes do not move.
+ */
+inline void NodeArena::give_nodes(NodeArena &to) {
+	assert( to.n_live == 0 );
+
+	for( int i = 0; i < (int)to.slabs.size(); i++ ) {
+		free(to.slabs[i]);
+	}
+	to.slabs.clear();
+	to.slabs.swap(slabs);
+
+	to.n_state_words = n_state_words;
+	to.slot_bytes = slot_bytes;
+	to.slots_per_slab = slots_per_slab;
+	to.current_slab = current_slab;
+	to.next_slot = next_slot;
+	to.free_list = free_list;
+	to.n_live = n_live;
+
+	reset();
+}
+
+
+/**
+ * Get memory for a node: recycled slot, or next slot of the slabs
+ */
+inline void* NodeArena::take_slot() {
+	if( free_list != NULL ) {
+		void* slot = free_list;
+		free_list = *(void**)slot;
+		return slot;
+	}
+
+	if( next_slot == slots_per_slab ) {
+		current_slab++;
+		next_slot = 0;
+	}
+	if( current_slab == (int)slabs.size() ) {
+		slabs.push_back((char*)malloc(slots_per_slab * slot_bytes));
+		if( slabs.back() == NULL ) {
+			throw bad_alloc();
+		}
+		stats.n_slabs++;
+		stats.slab_bytes += slots_per_slab * slot_bytes;
+	}
+	return slabs[current_slab] + (next_slot++) * slot_bytes;
+}
+
+
+/**
+ * Print allocation counters
+ */
+inline void NodeArena::print_stats(ostream &os) {
+	os << "\tnodes created: " << stats.n_created << endl;
+	os << "\tnodes destroyed: " << stats.n_destroyed << endl;
+	os << "\tmax. nodes alive: " << stats.max_live << endl;
+	os << "\tarena resets: " << stats.n_resets << endl;
+	os << "\theap allocations: " << stats.n_slabs << endl;
+	os << "\theap bytes: " << stats.slab_bytes << endl;
+	os << "\tbytes per node: " << slot_bytes << endl;
+}
+
+
+#endif /* NODE_ARENA_HPP_ */
@@ -0,0 +1,445 @@
+/*
+ * --------------------------------------------------------
+ * Pool of BDD nodes with a per-vertex index
+ *
+ * Nodes are kept in a NodeTable (lookup by state). In
+ * addition, every vertex has a list of the pool entries
+ * whose state contains it, so the nodes of a layer can be
+ * extracted without scanning the whole pool.
+ *
+ * Lists are not updated when a node leaves the pool: each
+ * pool entry gets a new id, and ids of removed nodes are
+ * simply marked as free. Lists of a vertex are emptied
+ * when the vertex is extracted, and all lists are rebuilt
+ * when free entries dominate.
+ *
+ * Pools of forked solvers share nodes (see share): the own
+ * nodes of a pool are frozen into a shared level, which is
+ * never modified again and is freed with its last pool.
+ * Each pool marks the level entries it no longer holds.
+ * Shared nodes must be copied before they are modified.
+ * --------------------------------------------------------
+ */
+
+#ifndef NODE_POOL_HPP_
+#define NODE_POOL_HPP_
+
+#include <cassert>
+#include <memory>
+#include <vector>
+#include "bdd.hpp"
+#include "node_arena.hpp"
+#include "node_table.hpp"
+
+using namespace std;
+
+#define NODE_POOL_MIN_COMPACT 4096
+#define NODE_POOL_MAX_SHARED 8			/**< shared levels of a pool before they are copied */
+
+
+struct SharedNodes;
+
+/**
+ * Shared level of a pool
+ */
+struct SharedLevel {
+	shared_ptr<SharedNodes>	nodes;			/**< frozen nodes */
+	vector<char>			taken;			/**< if each frozen entry left this pool */
+	int						n_live;			/**< frozen nodes still in this pool */
+};
+
+
+struct NodePool {
+
+	NodeTable				table;			/**< nodes indexed by state */
+	vector< vector<int> >	vertex_nodes;	/**< pool entries containing each vertex */
+	vector<Node*>			entries;		/**< node of each pool entry (NULL if removed) */
+
+	long					n_postings;		/**< total size of vertex lists */
+	long					n_live_postings;/**< entries of vertex lists that are in use */
+
+	vector<SharedLevel>		shared;			/**< nodes shared with other pools */
+
+	/** Constructor */
+	NodePool();
+
+	/** Set number of vertices of the states */
+	void resize(int n_vertices);
+
+	/** Find node with a given state (NULL if there is none) */
+	Node* find(IntSet& state) { return find(state, state.get_hash()); }
+
+	/** Find node with a given state whose hash is known */
+	Node* find(IntSet& state, uint64_t hash);
+
+	/** Add node to the pool. Its state must not be in the pool yet */
+	void insert(Node* node);
+
+	/** Add node whose state hash is known */
+	void insert(Node* node, uint64_t hash);
+
+	/** Remove node from the pool */
+	void erase(Node* node);
+
+	/** Move all nodes whose state contains vertex to the end of a vector */
+	void extract(int vertex, vector<Node*> &nodes);
+
+	/** Remove all nodes (nodes are not deleted) */
+	void clear();
+
+	/** Add all nodes of the pool to the end of a vector */
+	void get_nodes(vector<Node*> &nodes);
+
+	/** Make room for a number of nodes */
+	void reserve(int n) { table.reserve(n); }
+
+	/** Node with lexicographically smallest state (NULL if empty) */
+	Node* first_lex();
+
+	/** Number of nodes */
+	int size() const;
+
+	/** Check if pool has no nodes */
+	bool empty() const { return size() == 0; }
+
+	/** Freeze own nodes (allocated by arena) into a shared level */
+	void share(NodeArena &arena);
+
+	/** Hold the nodes of another pool, which must have no own nodes */
+	void share_with(const NodePool &from);
+
+	/** Check if node belongs to a shared level */
+	bool is_shared(Node* node) const;
+
+private:
+	void post(Node* node);
+	void compact();
+	void unshare(NodeArena &arena);
+};
+
+
+/**
+ * Frozen pool nodes and the memory they live in
+ */
+struct SharedNodes {
+	NodePool	pool;
+	NodeArena	arena;
+};
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Constructor
+ */
+inline NodePool::NodePool() : n_postings(0), n_live_postings(0) {
+}
+
+
+/**
+ * Set number of vertices of the states
+ */
+inline void NodePool::resize(int n_vertices) {
+	vertex_nodes.resize(n_vertices);
+}
+
+
+/**
+ * Find node with a given state whose hash is known
+ */
+inline Node* NodePool::find(IntSet& state, uint64_t hash) {
+	Node* node = table.find(state, hash);
+	for( int l = 0; node == NULL && l < (int)shared.size(); l++ ) {
+		if( shared[l].n_live == 0 ) {
+			continue;
+		}
+		node = shared[l].nodes->pool.table.find(state, hash);
+		if( node != NULL && shared[l].taken[node->pool_id] ) {
+			node = NULL;
+		}
+	}
+	return node;
+}
+
+
+/**
+ * Add node to the pool
+ */
+inline void NodePool::insert(Node* node) {
+	insert(node, node->state.get_hash());
+}
+
+
+/**
+ * Add node whose state hash is known
+ */
+inline void NodePool::insert(Node* node, uint64_t hash) {
+	table.insert(node, hash);
+	post(node);
+
+	// rebuild lists if most of their entries were removed
+	if( n_postings > NODE_POOL_MIN_COMPACT && n_postings > 4*n_live_postings ) {
+		compact();
+	}
+}
+
+
+/**
+ * Remove node from the pool
+ */
+inline void NodePool::erase(Node* node) {
+	if( table.erase(node) ) {
+		entries[node->pool_id] = NULL;
+		node->pool_id = -1;
+		n_live_postings -= node->state.get_size();
+		return;
+	}
+
+	// shared nodes keep their frozen entry
+	for( int l = 0; l < (int)shared.size(); l++ ) {
+		vector<Node*> &frozen = shared[l].nodes->pool.entries;
+		int id = node->pool_id;
+		if( id >= 0 && id < (int)frozen.size() && frozen[id] == node ) {
+			if( !shared[l].taken[id] ) {
+				shared[l].taken[id] = 1;
+				shared[l].n_live--;
+			}
+			return;
+		}
+	}
+}
+
+
+/**
+ * Move all nodes whose state contains vertex to the end of a vector
+ */
+inline void NodePool::extract(int vertex, vector<Node*> &nodes) {
+	vector<int> &list = vertex_nodes[vertex];
+	Node* node;
+	for( vector<int>::iterator id = list.begin(); id != list.end(); ++id ) {
+		node = entries[*id];
+		if( node != NULL ) {
+			assert( node->state.contains(vertex) );
+			erase(node);
+			nodes.push_back(node);
+		}
+	}
+	n_postings -= list.size();
+	list.clear();
+
+	for( int l = 0; l < (int)shared.size(); l++ ) {
+		SharedLevel &level = shared[l];
+		if( level.n_live == 0 ) {
+			continue;
+		}
+		vector<int> &frozen_list = level.nodes->pool.vertex_nodes[vertex];
+		for( vector<int>::iterator id = frozen_list.begin(); id != frozen_list.end(); ++id ) {
+			node = level.nodes->pool.entries[*id];
+			if( node != NULL && !level.taken[*id] ) {
+				level.taken[*id] = 1;
+				level.n_live--;
+				nodes.push_back(node);
+			}
+		}
+	}
+}
+
+
+/**
+ * Remove all nodes
+ */
+inline void NodePool::clear() {
+	table.clear();
+	for( int v = 0; v < (int)vertex_nodes.size(); v++ ) {
+		vertex_nodes[v].clear();
+	}
+	for( int i = 0; i < (int)entries.size(); i++ ) {
+		if( entries[i] != NULL ) {
+			entries[i]->pool_id = -1;
+		}
+	}
+	entries.clear();
+	n_postings = 0;
+	n_live_postings = 0;
+	shared.clear();
+}
+
+
+/**
+ * Add all nodes of the pool to the end of a vector
+ */
+inline void NodePool::get_nodes(vector<Node*> &nodes) {
+	for( int i = 0; i < (int)entries.size(); i++ ) {
+		if( entries[i] != NULL ) {
+			nodes.push_back(entries[i]);
+		}
+	}
+	for( int l = 0; l < (int)shared.size(); l++ ) {
+		vector<Node*> &frozen = shared[l].nodes->pool.entries;
+		for( int i = 0; i < (int)frozen.size(); i++ ) {
+			if( frozen[i] != NULL && !shared[l].taken[i] ) {
+				nodes.push_back(frozen[i]);
+			}
+		}
+	}
+}
+
+
+/**
+ * Node with lexicographically smallest state (shared levels are scanned)
+ */
+inline Node* NodePool::first_lex() {
+	Node* first = table.first_lex();
+	for( int l = 0; l < (int)shared.size(); l++ ) {
+		if( shared[l].n_live == 0 ) {
+			continue;
+		}
+		vector<Node*> &frozen = shared[l].nodes->pool.entries;
+		for( int i = 0; i < (int)frozen.size(); i++ ) {
+			if( frozen[i] != NULL && !shared[l].taken[i]
+					&& (first == NULL || frozen[i]->state.lex_less(first->state)) )
+			{
+				first = frozen[i];
+			}
+		}
+	}
+	return first;
+}
+
+
+/**
+ * Number of nodes
+ */
+inline int NodePool::size() const {
+	int n = table.size();
+	for( int l = 0; l < (int)shared.size(); l++ ) {
+		n += shared[l].n_live;
+	}
+	return n;
+}
+
+
+/**
+ * Freeze own nodes into a new shared level. Their memory moves from arena to the
+ * level, so that the nodes live as long as a pool holds the level. Takes O(levels).
+ */
+inline void NodePool::share(NodeArena &arena) {
+	if( (int)shared.size() >= NODE_POOL_MAX_SHARED ) {
+		unshare(arena);
+	}
+	if( table.empty() ) {
+		return;
+	}
+
+	shared_ptr<SharedNodes> frozen = make_shared<SharedNodes>();
+	swap(table, frozen->pool.table);
+	entries.swap(frozen->pool.entries);
+	vertex_nodes.swap(frozen->pool.vertex_nodes);
+	vertex_nodes.resize(frozen->pool.vertex_nodes.size());
+	n_postings = 0;
+	n_live_postings = 0;
+	arena.give_nodes(frozen->arena);
+
+	SharedLevel level;
+	level.nodes = frozen;
+	level.taken.assign(frozen->pool.entries.size(), 0);
+	level.n_live = frozen->pool.table.size();
+	shared.push_back(level);
+}
+
+
+/**
+ * Hold the nodes of another pool. Takes O(nodes) bytes for the entries taken.
+ */
+inline void NodePool::share_with(const NodePool &from) {
+	assert( from.table.empty() );
+	clear();
+	shared = from.shared;
+}
+
+
+/**
+ * Check if node belongs to a shared level
+ */
+inline bool NodePool::is_shared(Node* node) const {
+	int id = node->pool_id;
+	for( int l = 0; l < (int)shared.size(); l++ ) {
+		const vector<Node*> &frozen = shared[l].nodes->pool.entries;
+		if( id >= 0 && id < (int)frozen.size() && frozen[id] == node ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Give node a new pool entry and add it to the lists of its vertices
+ */
+inline void NodePool::post(Node* node) {
+	node->pool_id = entries.size();
+	entries.push_back(node);
+
+	int size = 0;
+	int v = node->state.get_first();
+	while( v != node->state.get_end() ) {
+		vertex_nodes[v].push_back(node->pool_id);
+		size++;
+		v = node->state.get_next(v);
+	}
+	n_postings += size;
+	n_live_postings += size;
+}
+
+
+/**
+ * Rebuild lists with the nodes that are still in the pool
+ */
+inline void NodePool::compact() {
+	vector<Node*> live;
+	live.reserve(table.size());
+	for( int i = 0; i < (int)entries.size(); i++ ) {
+		if( entries[i] != NULL ) {
+			live.push_back(entries[i]);
+		}
+	}
+
+	for( int v = 0; v < (int)vertex_nodes.size(); v++ ) {
+		vertex_nodes[v].clear();
+	}
+	entries.clear();
+	n_postings = 0;
+	n_live_postings = 0;
+
+	for( int i = 0; i < (int)live.size(); i++ ) {
+		post(live[i]);
+	}
+}
+
+
+/**
+ * Replace the shared nodes still in the pool by own copies
+ */
+inline void NodePool::unshare(NodeArena &arena) {
+	vector<Node*> copies;
+	for( int l = 0; l < (int)shared.size(); l++ ) {
+		vector<Node*> &frozen = shared[l].nodes->pool.entries;
+		for( int i = 0; i < (int)frozen.size(); i++ ) {
+			if( frozen[i] != NULL && !shared[l].taken[i] ) {
+				copies.push_back(arena.create(frozen[i]->state, frozen[i]->longest_path));
+			}
+		}
+	}
+	shared.clear();
+
+	for( int i = 0; i < (int)copies.size(); i++ ) {
+		insert(copies[i]);
+	}
+}
+
+
+#endif /* NODE_POOL_HPP_ */
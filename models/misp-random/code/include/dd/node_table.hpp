@@ -0,0 +1,264 @@
+/*
+ * --------------------------------------------------------
+ * Hash table of BDD nodes indexed by their state
+ *
+ * Open addressing with linear probing over a power-of-two
+ * number of slots. Each slot caches the 64-bit hash of the
+ * node state, so full bitset comparisons are only done
+ * when two hashes match. Erasing shifts the following
+ * entries back, hence no tombstones are left behind.
+ * --------------------------------------------------------
+ */
+
+#ifndef NODE_TABLE_HPP_
+#define NODE_TABLE_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "bdd.hpp"
+
+using namespace std;
+
+#define NODE_TABLE_MIN_SLOTS 16
+
+
+struct NodeTable {
+
+	struct Slot {
+		uint64_t	hash;			/**< cached hash of the node state */
+		Node*		node;			/**< node (NULL if slot is empty) */
+	};
+
+	vector<Slot>	slots;			/**< slots of the table */
+	uint64_t		mask;			/**< number of slots - 1 */
+	int				n_nodes;		/**< number of nodes in the table */
+
+	Node*			lex_min;		/**< cached lexicographically smallest node */
+	bool			lex_min_valid;	/**< if cached smallest node is up to date */
+
+	/** Constructor */
+	NodeTable();
+
+	/** Find node with a given state (NULL if there is none) */
+	Node* find(IntSet& state);
+
+	/** Find node with a given state whose hash is known */
+	Node* find(IntSet& state, uint64_t hash);
+
+	/** Add node to the table. Its state must not be in the table yet */
+	void insert(Node* node);
+
+	/** Add node whose state hash is known */
+	void insert(Node* node, uint64_t hash);
+
+	/** Remove node from the table, if it is there */
+	bool erase(Node* node);
+
+	/** Remove all nodes (nodes are not deleted) */
+	void clear();
+
+	/** Make room for a number of nodes */
+	void reserve(int n);
+
+	/** Node with lexicographically smallest state (NULL if empty) */
+	Node* first_lex();
+
+	/** Number of nodes */
+	int size() const { return n_nodes; }
+
+	/** Check if table has no nodes */
+	bool empty() const { return n_nodes == 0; }
+
+private:
+	void rehash(int n_slots);
+	void place(Node* node, uint64_t hash);
+};
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations
+ * ----------------------------------------
+ */
+
+/**
+ * Constructor
+ */
+inline NodeTable::NodeTable() : n_nodes(0), lex_min(NULL), lex_min_valid(true) {
+	slots.resize(NODE_TABLE_MIN_SLOTS);
+	for( int i = 0; i < (int)slots.size(); i++ ) {
+		slots[i].node = NULL;
+	}
+	mask = slots.size() - 1;
+}
+
+
+/**
+ * Find node with a given state
+ */
+inline Node* NodeTable::find(IntSet& state) {
+	return find(state, state.get_hash());
+}
+
+
+/**
+ * Find node with a given state whose hash is known
+ */
+inline Node* NodeTable::find(IntSet& state, uint64_t hash) {
+	uint64_t i = hash & mask;
+	while( slots[i].node != NULL ) {
+		if( slots[i].hash == hash && slots[i].node->state.equals_to(state) ) {
+			return slots[i].node;
+		}
+		i = (i+1) & mask;
+	}
+	return NULL;
+}
+
+
+/**
+ * Add node to the table
+ */
+inline void NodeTable::insert(Node* node) {
+	insert(node, node->state.get_hash());
+}
+
+
+/**
+ * Add node whose state hash is known
+ */
+inline void NodeTable::insert(Node* node, uint64_t hash) {
+	assert( find(node->state, hash) == NULL );
+
+	// keep load factor below 1/2
+	if( 2*(n_nodes+1) > (int)slots.size() ) {
+		rehash(2*slots.size());
+	}
+	place(node, hash);
+	n_nodes++;
+
+	if( lex_min_valid && (lex_min == NULL || IntSetLexLessThan()(&(node->state), &(lex_min->state))) ) {
+		lex_min = node;
+	}
+}
+
+
+/**
+ * Remove node from the table
+ */
+inline bool NodeTable::erase(Node* node) {
+	uint64_t i = node->state.get_hash() & mask;
+	while( slots[i].node != node ) {
+		if( slots[i].node == NULL ) {
+			return false;
+		}
+		i = (i+1) & mask;
+	}
+
+	// shift back entries whose probe sequence crosses the freed slot
+	uint64_t j = i;
+	while( true ) {
+		j = (j+1) & mask;
+		if( slots[j].node == NULL ) {
+			break;
+		}
+		uint64_t home = slots[j].hash & mask;
+		if( ((j - home) & mask) >= ((j - i) & mask) ) {
+			slots[i] = slots[j];
+			i = j;
+		}
+	}
+	slots[i].node = NULL;
+	n_nodes--;
+
+	if( node == lex_min ) {
+		lex_min = NULL;
+		lex_min_valid = false;
+	}
+	return true;
+}
+
+
+/**
+ * Remove all nodes
+ */
+inline void NodeTable::clear() {
+	if( n_nodes > 0 ) {
+		for( int i = 0; i < (int)slots.size(); i++ ) {
+			slots[i].node = NULL;
+		}
+	}
+	n_nodes = 0;
+	lex_min = NULL;
+	lex_min_valid = true;
+}
+
+
+/**
+ * Make room for a number of nodes
+ */
+inline void NodeTable::reserve(int n) {
+	int n_slots = slots.size();
+	while( n_slots < 2*n ) {
+		n_slots *= 2;
+	}
+	if( n_slots > (int)slots.size() ) {
+		rehash(n_slots);
+	}
+}
+
+
+/**
+ * Node with lexicographically smallest state
+ */
+inline Node* NodeTable::first_lex() {
+	if( !lex_min_valid ) {
+		lex_min = NULL;
+		IntSetLexLessThan less_than;
+		for( int i = 0; i < (int)slots.size(); i++ ) {
+			if( slots[i].node != NULL && (lex_min == NULL || less_than(&(slots[i].node->state), &(lex_min->state))) ) {
+				lex_min = slots[i].node;
+			}
+		}
+		lex_min_valid = true;
+	}
+	return lex_min;
+}
+
+
+/**
+ * Resize table, reinserting all nodes
+ */
+inline void NodeTable::rehash(int n_slots) {
+	assert( (n_slots & (n_slots-1)) == 0 );
+
+	vector<Slot> old_slots(n_slots);
+	old_slots.swap(slots);
+	for( int i = 0; i < (int)slots.size(); i++ ) {
+		slots[i].node = NULL;
+	}
+	mask = n_slots - 1;
+
+	for( int i = 0; i < (int)old_slots.size(); i++ ) {
+		if( old_slots[i].node != NULL ) {
+			place(old_slots[i].node, old_slots[i].hash);
+		}
+	}
+}
+
+
+/**
+ * Put node in the first free slot of its probe sequence
+ */
+inline void NodeTable::place(Node* node, uint64_t hash) {
+	uint64_t i = hash & mask;
+	while( slots[i].node != NULL ) {
+		i = (i+1) & mask;
+	}
+	slots[i].hash = hash;
+	slots[i].node = node;
+}
+
+
+#endif /* NODE_TABLE_HPP_ */
@@ -43,6 +43,8 @@ struct IS_Ordering {
 
 	IS_Ordering(IndepSetInst* _inst, OrderType _order_type) : inst(_inst), order_type(_order_type) { }
 
+	virtual ~IS_Ordering() { }
+
 	// returns vertex corresponding to particular layer
 	virtual int vertex_in_layer(BDD* bdd, int layer) = 0;
 };
@@ -203,19 +205,15 @@ struct OnlineOrdering : IS_Ordering {
 
 };
 
-// Cut vertex decomposition
+// Cut vertex decomposition of a spanning tree of the graph
 struct CutVertexDecompositionGeneralGraph : IS_Ordering {
 
 	vector<int> v_in_layer;      // vertex at each layer
-	bool** original_adj_matrix;
 
 	CutVertexDecompositionGeneralGraph(IndepSetInst *_inst) : IS_Ordering(_inst, CutVertexGen) {
 		sprintf(name, "cut-vertex-gen");
 		v_in_layer.resize(inst->graph->n_vertices);
-
-		restrict_graph();
 		construct_ordering();
-		regenerate_graph();
 	}
 
 	int vertex_in_layer(BDD* bdd, int layer) {
@@ -224,11 +222,8 @@ struct CutVertexDecompositionGeneralGraph : IS_Ordering {
 	}
 
 private:
-	void        restrict_graph();
-	void        regenerate_graph();
 	void        construct_ordering();
-	void        identify_components(vector< vector<int> > &comps, vector<bool> &is_in_graph);
-	vector<int> find_ordering(vector<bool> is_in_graph);
+	void        spanning_tree(vector<int> &tree_start, vector<int> &tree_adj);
 };
 
 
@@ -250,13 +245,35 @@ struct CutVertexDecomposition : IS_Ordering {
 
 private:
 	void        construct_ordering();
-	void        identify_components(vector< vector<int> > &comps, vector<bool> &is_in_graph);
-	vector<int> find_ordering(vector<bool> is_in_graph);
 };
 
 
+// Ordering of an instance relabeled in processing order (see relabel_in_order)
+struct RelabeledOrdering : IS_Ordering {
 
+	RelabeledOrdering(IndepSetInst *_inst) : IS_Ordering(_inst, Fixed) {
+		sprintf(name, "relabeled");
+	}
 
+	int vertex_in_layer(BDD* bdd, int layer) {
+		assert( layer >= 0 && layer < inst->graph->n_vertices);
+		return layer;
+	}
+};
+
+
+// Copy of an instance whose vertices are labeled in the order of a static ordering, to be
+// solved with RelabeledOrdering. Vertices branched on are then the smallest ones, so states
+// of later layers skip their words (see IntSet::trim); original_vertex maps vertices back.
+inline IndepSetInst* relabel_in_order(IndepSetInst* inst, IS_Ordering* ordering) {
+	vector<int> order(inst->graph->n_vertices);
+	for( int layer = 0; layer < inst->graph->n_vertices; layer++ ) {
+		order[layer] = ordering->vertex_in_layer(NULL, layer);
+	}
+	IndepSetInst* relabeled = new IndepSetInst;
+	relabeled->build_relabeled(*inst, order);
+	return relabeled;
+}
 
 
 #endif
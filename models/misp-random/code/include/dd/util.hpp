@@ -9,6 +9,7 @@
 #ifndef UTIL_HPP_
 #define UTIL_HPP_
 
+#include <limits>
 
 /**
  * -------------------------------------------------------------
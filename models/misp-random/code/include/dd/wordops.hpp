@@ -0,0 +1,111 @@
+/*
+ * --------------------------------------------------------
+ * Bitwise kernels over arrays of 64-bit words
+ *
+ * Sets with at most INTSET_SMALL_WORDS words use the inline
+ * scalar loops below. Larger sets have a word count that
+ * is a multiple of WORDOPS_VECTOR_WORDS and go through the
+ * kernel table `word_ops`, which is selected once at start
+ * up according to the instruction sets of the processor
+ * (AVX-512, AVX2 or plain scalar code).
+ * --------------------------------------------------------
+ */
+
+#ifndef WORDOPS_HPP_
+#define WORDOPS_HPP_
+
+#include <cstdint>
+
+#define INTSET_SMALL_WORDS		2		/**< sets up to this number of words use inline loops */
+#define WORDOPS_VECTOR_WORDS	4		/**< larger sets are padded to a multiple of this */
+
+
+/**
+ * Table of word kernels (n_words must be a multiple of WORDOPS_VECTOR_WORDS)
+ */
+struct WordOps {
+	const char*	name;												/**< instruction set used */
+	void		(*and_words)(uint64_t* a, const uint64_t* b, int n_words);		/**< a &= b */
+	void		(*or_words)(uint64_t* a, const uint64_t* b, int n_words);		/**< a |= b */
+	void		(*andnot_words)(uint64_t* a, const uint64_t* b, int n_words);	/**< a &= ~b */
+	int			(*count_words)(const uint64_t* a, int n_words);				/**< |a| */
+	int			(*xor_count_words)(const uint64_t* a, const uint64_t* b, int n_words);	/**< |a ^ b| */
+	bool		(*equal_words)(const uint64_t* a, const uint64_t* b, int n_words);		/**< a == b */
+	bool		(*subset_words)(const uint64_t* a, const uint64_t* b, int n_words);	/**< a is a subset of b */
+};
+
+/** Kernels selected for this processor */
+extern WordOps word_ops;
+
+/** Kernels of a given instruction set ("scalar", "avx2", "avx512"); NULL if not supported */
+const WordOps* get_word_ops(const char* name);
+
+
+/*
+ * ----------------------------------------
+ * Inline implementations (scalar)
+ * ----------------------------------------
+ */
+
+inline int popcount_word(uint64_t x) {
+	return __builtin_popcountll(x);
+}
+
+inline int count_trailing_zeros_word(uint64_t x) {
+	return __builtin_ctzll(x);
+}
+
+inline void and_words_scalar(uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i++ ) {
+		a[i] &= b[i];
+	}
+}
+
+inline void or_words_scalar(uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i++ ) {
+		a[i] |= b[i];
+	}
+}
+
+inline void andnot_words_scalar(uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i++ ) {
+		a[i] &= ~b[i];
+	}
+}
+
+inline int count_words_scalar(const uint64_t* a, int n_words) {
+	int count = 0;
+	for( int i = 0; i < n_words; i++ ) {
+		count += popcount_word(a[i]);
+	}
+	return count;
+}
+
+inline int xor_count_words_scalar(const uint64_t* a, const uint64_t* b, int n_words) {
+	int count = 0;
+	for( int i = 0; i < n_words; i++ ) {
+		count += popcount_word(a[i] ^ b[i]);
+	}
+	return count;
+}
+
+inline bool equal_words_scalar(const uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i++ ) {
+		if( a[i] != b[i] ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+inline bool subset_words_scalar(const uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i++ ) {
+		if( (a[i] & ~b[i]) != 0 ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+#endif /* WORDOPS_HPP_ */
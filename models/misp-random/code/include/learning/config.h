@@ -57,6 +57,8 @@ struct cfg
     static int edge_embed_dim;
     static int aux_dim;
     static int bdd_max_width;
+    static int bdd_threads;
+    static int bdd_kernelize;
     static Dtype decay;
     static Dtype learning_rate;
     static Dtype l2_penalty;
@@ -105,6 +107,10 @@ struct cfg
     			momentum = atof(argv[i + 1]);
             if (strcmp(argv[i], "-bdd_max_width") == 0)
                 bdd_max_width = atoi(argv[i + 1]);
+            if (strcmp(argv[i], "-bdd_threads") == 0)
+                bdd_threads = atoi(argv[i + 1]);
+            if (strcmp(argv[i], "-bdd_kernelize") == 0)
+                bdd_kernelize = atoi(argv[i + 1]);
             if (strcmp(argv[i], "-avg_global") == 0)
                 avg_global = atoi(argv[i + 1]);
     		if (strcmp(argv[i], "-save_dir") == 0)
@@ -145,6 +151,8 @@ struct cfg
         std::cerr << "[INFO] reward_type = " << reward_type << std::endl;
         std::cerr << "[INFO] bdd_type = " << bdd_type << std::endl;
         std::cerr << "[INFO] bdd_max_width = " << bdd_max_width << std::endl;
+        std::cerr << "[INFO] bdd_threads = " << bdd_threads << std::endl;
+        std::cerr << "[INFO] bdd_kernelize = " << bdd_kernelize << std::endl;
         std::cerr << "[INFO] r_scaling = " << r_scaling << std::endl;
     }
 };
@@ -33,6 +33,8 @@ SOFTWARE.
 extern char reward_type;
 extern char bdd_type;
 extern int bdd_max_width;
+extern int bdd_threads;
+extern int bdd_kernelize;
 extern double r_scaling;
 
 class IEnv
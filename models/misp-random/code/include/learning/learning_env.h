@@ -25,10 +25,40 @@ SOFTWARE.
 #define LEARNING_ENV_H
 
 #include "indepset_solver.hpp"
+#include "kernelization.hpp"
 #include "i_env.h"
 
+#include <map>
+#include <memory>
+
 extern int sign;
 
+/**
+ * Preprocessed instances of the graphs seen by the environments, so that a graph
+ * played in many episodes is only converted once. Entries of graphs that are no
+ * longer referenced anywhere are dropped when a new graph is added.
+ */
+class InstanceCache
+{
+public:
+
+    std::shared_ptr<IndepSetInst> Get(std::shared_ptr<Graph> g);
+
+    /** Kernel of the instance of a graph (reduced on first use) */
+    std::shared_ptr<Kernelization> GetKernel(std::shared_ptr<Graph> g);
+
+private:
+
+    struct Entry {
+        std::weak_ptr<Graph> graph;
+        std::shared_ptr<IndepSetInst> inst;
+        std::shared_ptr<Kernelization> kernel;
+    };
+    std::map<const Graph*, Entry> entries;
+};
+
+extern InstanceCache InstCache;
+
 class LearningEnv : public IEnv
 {
 public:
@@ -49,14 +79,18 @@ public:
 
     double getRewardLowerBound(int old_bound);
 
+    double getRewardGap(int old_bound, int old_lower_bound);
+
     double getRewardMerge();
 
     int width;
     int bound;
-    std::set<int> covered_set;
-    std::vector<int> avail_list;
-    IndepSetSolver* solver;
-    IndepSetInst* inst;
+    int lower_bound;                        // restriction bound when both diagrams are built
+    std::vector<int> avail_list;            // vertices not chosen yet
+    std::vector<int> avail_pos;             // position of each vertex in avail_list (-1 if chosen)
+    IndepSetSolver* solver;                 // reused by all episodes of this environment
+    std::shared_ptr<Kernelization> kernel;  // reductions of the graph (null unless bdd_kernelize)
+    std::shared_ptr<IndepSetInst> inst;     // instance the diagrams are built on (the kernel if reduced)
 };
 
 #endif
\ No newline at end of file
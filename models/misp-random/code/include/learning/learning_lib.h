@@ -48,5 +48,9 @@ extern "C" double GetSol(const int gid, int* sol);
 
 extern "C" double GetResult(const int gid, int* sol);
 
+// Construction counters of the last diagram of GetResult or GetSol, one row of LAYER_STATS_FIELDS
+// longs per layer (see layer_stats.hpp). Returns the number of rows written.
+extern "C" int GetDDStats(long* stats, const int max_layers);
+
 
 #endif
\ No newline at end of file
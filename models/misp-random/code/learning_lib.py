@@ -27,6 +27,10 @@ import numpy as np
 import os
 import sys
 
+# fields of a row of GetDDStats (LAYER_STATS_NAMES in layer_stats.hpp)
+DD_STATS_NAMES = ['pool_size', 'layer_size', 'nodes_created', 'dedup_hits', 'nodes_merged',
+                  'bytes_allocated', 'ns_extract', 'ns_merge', 'ns_branch', 'ns_dedup', 'ns_inference']
+
 class LearningLib(object):
 
     def __init__(self, args):
@@ -89,5 +93,11 @@ class LearningLib(object):
         val = self.lib.GetResult(gid, sol)
         return val, sol
 
+    def GetDDStats(self, max_layers):
+        n_fields = len(DD_STATS_NAMES)
+        stats = (ctypes.c_long * (max_layers * n_fields))()
+        n_layers = self.lib.GetDDStats(stats, max_layers)
+        return [dict(zip(DD_STATS_NAMES, stats[l*n_fields:(l+1)*n_fields])) for l in range(n_layers)]
+
 if __name__ == '__main__':
     f = LearningLib(sys.argv)
\ No newline at end of file
@@ -0,0 +1,315 @@
+/*
+ * --------------------------------------------------------
+ * Parallel branch and bound for the MISP - implementation
+ *
+ * Each subproblem is a node of an exact cutset: its state
+ * and the longest path from the root. A subproblem is
+ * solved with a restricted DD (lower bound) and a relaxed
+ * DD (upper bound); if the relaxation had to merge nodes,
+ * the exact nodes of the layer where merging started become
+ * new subproblems. With node pruning, both diagrams discard
+ * nodes whose completion bound cannot beat the incumbent,
+ * and subproblems get their own completion bound.
+ *
+ * Every worker owns a solver and a queue of subproblems
+ * ordered by upper bound. Idle workers steal the best
+ * subproblem of another queue. The incumbent value is
+ * shared by all workers.
+ * --------------------------------------------------------
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "indepset_solver.hpp"
+
+using namespace std;
+
+
+typedef chrono::steady_clock BBClock;
+
+
+/**
+ * Queue of subproblems of a worker
+ */
+struct BBQueue {
+	mutex			lock;
+	NodeQueue		nodes;
+};
+
+
+/**
+ * Search state shared by all workers
+ */
+struct BBSearch {
+	BranchAndBoundParams*	params;
+	vector<BBQueue>			queues;				/**< one queue per worker */
+
+	atomic<int>				lb;					/**< incumbent value */
+	atomic<long>			pending;			/**< subproblems queued or being solved */
+	atomic<long>			explored;			/**< subproblems taken from the queues */
+	atomic<long>			pruned;				/**< subproblems discarded by bound */
+	atomic<bool>			stop;				/**< if a limit was reached */
+
+	BBClock::time_point		start;
+	BBClock::time_point		last_report;
+
+	BBSearch(BranchAndBoundParams* _params, int n_workers)
+		: params(_params), queues(n_workers), lb(0), pending(0), explored(0), pruned(0), stop(false)
+	{
+		start = BBClock::now();
+		last_report = start;
+	}
+
+	double elapsed() {
+		return chrono::duration<double>(BBClock::now() - start).count();
+	}
+};
+
+
+/**
+ * Raise the incumbent value
+ */
+static void update_lower_bound(BBSearch &search, int value) {
+	int current = search.lb.load();
+	while( value > current && !search.lb.compare_exchange_weak(current, value) ) { }
+}
+
+
+/**
+ * Add subproblem to the queue of a worker
+ */
+static void push_subproblem(BBSearch &search, int worker, Node* node) {
+	lock_guard<mutex> guard(search.queues[worker].lock);
+	search.queues[worker].nodes.push(node);
+}
+
+
+/**
+ * Take the best subproblem of the worker queue, or steal one from another worker
+ */
+static Node* take_subproblem(BBSearch &search, int worker) {
+	int n_workers = search.queues.size();
+	for( int k = 0; k < n_workers; k++ ) {
+		BBQueue &queue = search.queues[(worker + k) % n_workers];
+		lock_guard<mutex> guard(queue.lock);
+		if( !queue.nodes.empty() ) {
+			Node* node = queue.nodes.top();
+			queue.nodes.pop();
+			return node;
+		}
+	}
+	return NULL;
+}
+
+
+/**
+ * Best upper bound of the queued subproblems (INF if none is queued)
+ */
+static int queued_upper_bound(BBSearch &search) {
+	int ub = -INF;
+	for( int w = 0; w < (int)search.queues.size(); w++ ) {
+		lock_guard<mutex> guard(search.queues[w].lock);
+		if( !search.queues[w].nodes.empty() ) {
+			ub = MAX(ub, search.queues[w].nodes.top()->relax_ub);
+		}
+	}
+	return ub;
+}
+
+
+/**
+ * Print a progress line
+ */
+static void report_progress(BBSearch &search) {
+	int lb = search.lb;
+	int ub = MAX(lb, queued_upper_bound(search));
+	cout << "[b&b] time: " << search.elapsed() << "s";
+	cout << " - explored: " << search.explored;
+	cout << " - pruned: " << search.pruned;
+	cout << " - open: " << search.pending;
+	cout << " - lb: " << lb << " - ub: " << ub << endl;
+}
+
+
+/**
+ * Solve a subproblem, queueing the subproblems of its exact cutset
+ */
+static void solve_subproblem(BBSearch &search, int worker, IndepSetSolver* solver, Node* node) {
+
+	if( node->relax_ub <= search.lb ) {
+		search.pruned++;
+		return;
+	}
+
+	bool prune = search.params->prune_nodes;
+
+	// lower bound
+	if( prune ) {
+		solver->prune_lb = search.lb;
+	}
+	int lower = solver->generate_restriction_with_ordering(node->state, node->longest_path);
+	update_lower_bound(search, lower);
+	if( solver->exact ) {
+		return;
+	}
+
+	// upper bound
+	if( prune ) {
+		solver->prune_lb = search.lb;
+	}
+	solver->collect_cutset = true;
+	int upper = solver->generate_relaxation(node->state, node->longest_path);
+	solver->collect_cutset = false;
+
+	vector<Node*> children;
+	children.swap(solver->exact_cutset);
+
+	if( solver->exact ) {
+		update_lower_bound(search, upper);
+	}
+
+	for( vector<Node*>::iterator child = children.begin(); child != children.end(); ++child ) {
+		if( upper <= search.lb ) {
+			delete (*child);
+
+		} else if( (*child)->state.get_size() == 0 ) {
+			// nothing left to decide
+			update_lower_bound(search, (*child)->longest_path);
+			delete (*child);
+
+		} else {
+			(*child)->relax_ub = upper;
+			if( prune ) {
+				(*child)->relax_ub = MIN(upper, (*child)->longest_path + solver->completion_bound((*child)->state));
+			}
+			search.pending++;
+			push_subproblem(search, worker, *child);
+		}
+	}
+
+	if( upper <= search.lb ) {
+		search.pruned++;
+	}
+}
+
+
+/**
+ * Worker loop
+ */
+static void run_worker(BBSearch &search, int worker, IndepSetSolver* solver) {
+
+	BranchAndBoundParams &params = *search.params;
+
+	while( !search.stop ) {
+
+		Node* node = take_subproblem(search, worker);
+		if( node == NULL ) {
+			if( search.pending == 0 ) {
+				break;
+			}
+			this_thread::yield();
+			continue;
+		}
+
+		long explored = ++search.explored;
+		solve_subproblem(search, worker, solver, node);
+		delete node;
+		search.pending--;
+
+		// limits
+		if( params.node_limit >= 0 && explored >= params.node_limit ) {
+			search.stop = true;
+		}
+		if( params.time_limit >= 0 && search.elapsed() >= params.time_limit ) {
+			search.stop = true;
+		}
+
+		// progress
+		if( worker == 0 && params.report_interval >= 0
+				&& chrono::duration<double>(BBClock::now() - search.last_report).count() >= params.report_interval ) {
+			search.last_report = BBClock::now();
+			report_progress(search);
+		}
+	}
+}
+
+
+/**
+ * Branch and bound. The first worker uses this solver (with its ordering and
+ * merger); other workers get their own solver, ordering and merger from the
+ * factories in bb_params.
+ */
+Bounds IndepSetSolver::branch_and_bound() {
+
+	assert( ordering != NULL && merger != NULL );
+
+	int n_workers = MAX(1, bb_params.n_threads);
+	if( n_workers > 1 && (!bb_params.make_ordering || !bb_params.make_merger) ) {
+		cerr << "Warning: branch and bound needs ordering and merger factories to use more than one thread" << endl;
+		n_workers = 1;
+	}
+
+	vector<IndepSetSolver*> solvers(n_workers);
+	solvers[0] = this;
+	for( int w = 1; w < n_workers; w++ ) {
+		solvers[w] = new IndepSetSolver(inst, width);
+		solvers[w]->ordering = bb_params.make_ordering(inst);
+		solvers[w]->merger = bb_params.make_merger(inst, width);
+	}
+
+	// shared by the workers, so it is built before they start
+	if( bb_params.prune_nodes ) {
+		inst->build_clique_cover();
+	}
+
+	BBSearch search(&bb_params, n_workers);
+
+	// root subproblem
+	IntSet root_state(0, inst->graph->n_vertices-1, true);
+	Node* root = new Node(root_state, 0);
+	root->relax_ub = INF;
+	search.pending = 1;
+	push_subproblem(search, 0, root);
+
+	vector<thread> threads;
+	for( int w = 1; w < n_workers; w++ ) {
+		threads.push_back(thread(run_worker, ref(search), w, solvers[w]));
+	}
+	run_worker(search, 0, this);
+	for( int t = 0; t < (int)threads.size(); t++ ) {
+		threads[t].join();
+	}
+
+	// bounds: open subproblems are left only if a limit was reached
+	Bounds bounds;
+	bounds.lb = search.lb;
+	bounds.ub = MAX(bounds.lb, queued_upper_bound(search));
+
+	for( int w = 0; w < n_workers; w++ ) {
+		while( !search.queues[w].nodes.empty() ) {
+			delete search.queues[w].nodes.top();
+			search.queues[w].nodes.pop();
+		}
+	}
+	for( int w = 1; w < n_workers; w++ ) {
+		delete solvers[w]->ordering;
+		delete solvers[w]->merger;
+		delete solvers[w];
+	}
+
+	prune_lb = -INF;
+
+	global_LB = bounds.lb;
+	global_UB = bounds.ub;
+	bb_explored = search.explored;
+
+	if( bb_params.report_interval >= 0 ) {
+		report_progress(search);
+	}
+
+	return bounds;
+}
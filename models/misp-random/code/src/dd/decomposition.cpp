@@ -0,0 +1,257 @@
+/*
+ * --------------------------------------------------------
+ * Component decomposition of relaxations - implementation
+ *
+ * Once the vertices branched on separate the graph, the
+ * vertices left in the states of the pool split into
+ * connected components, and the problem left at every
+ * pool node is the sum of independent problems, one per
+ * component. Each distinct projection of the pool states
+ * on a component is relaxed by its own (smaller) diagram,
+ * and the bound of a pool node is its longest path plus
+ * the bounds of its projections.
+ *
+ * Components whose projections are too many get a single
+ * diagram from the union of their projections, which
+ * bounds all of them since adding vertices to a state can
+ * only increase its value. Diagrams of projections are
+ * decomposed again, with a single root per component so
+ * that nested decompositions do not multiply the work.
+ * --------------------------------------------------------
+ */
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#include "indepset_solver.hpp"
+
+using namespace std;
+
+
+/**
+ * Split the vertices left in the states of the pool into connected components
+ * (returns if there is more than one)
+ */
+bool IndepSetSolver::find_components() {
+
+	int n_vertices = inst->graph->n_vertices;
+
+	cutset_aux.clear();
+	node_list.get_nodes(cutset_aux);
+	if( cutset_aux.empty() ) {
+		return false;
+	}
+
+	remaining.resize(0, n_vertices-1, false);
+	for( vector<Node*>::iterator it = cutset_aux.begin(); it != cutset_aux.end(); ++it ) {
+		remaining.union_with((*it)->state);
+	}
+	if( remaining.get_size() < 2 ) {
+		return false;
+	}
+
+	// depth first search restricted to the vertices left
+	component_of.assign(n_vertices, -1);
+	n_components = 0;
+	for( int v = remaining.get_first(); v != remaining.get_end(); v = remaining.get_next(v) ) {
+		if( component_of[v] != -1 ) {
+			continue;
+		}
+
+		component_of[v] = n_components;
+		component_stack.push_back(v);
+		while( !component_stack.empty() ) {
+			int u = component_stack.back();
+			component_stack.pop_back();
+
+			for( const int* w = inst->graph->neighbors_begin(u); w != inst->graph->neighbors_end(u); ++w ) {
+				if( component_of[*w] == -1 && remaining.contains(*w) ) {
+					component_of[*w] = n_components;
+					component_stack.push_back(*w);
+				}
+			}
+		}
+		n_components++;
+	}
+
+	return ( n_components > 1 );
+}
+
+
+/**
+ * Bound of the pool from the relaxations of the projections of its states on
+ * each component (see find_components). Pool nodes are destroyed.
+ */
+int IndepSetSolver::relax_components() {
+
+	int n_vertices = inst->graph->n_vertices;
+	int n_comps = n_components;
+
+	cutset_aux.clear();
+	node_list.get_nodes(cutset_aux);
+	int n_nodes = cutset_aux.size();
+
+	// distinct projections of the pool states on each component
+	vector<IntSet> roots;
+	vector<int> node_root(n_nodes * n_comps);
+	vector< unordered_multimap<uint64_t, int> > root_index(n_comps);
+
+	vector<IntSet> projections(n_comps);
+	for( int c = 0; c < n_comps; c++ ) {
+		projections[c].resize(0, n_vertices-1, false);
+	}
+
+	for( int i = 0; i < n_nodes; i++ ) {
+		IntSet &state = cutset_aux[i]->state;
+		for( int v = state.get_first(); v != state.get_end(); v = state.get_next(v) ) {
+			projections[component_of[v]].add(v);
+		}
+
+		for( int c = 0; c < n_comps; c++ ) {
+			uint64_t hash = projections[c].get_hash();
+			int root = -1;
+			auto range = root_index[c].equal_range(hash);
+			for( auto it = range.first; it != range.second && root == -1; ++it ) {
+				if( roots[it->second].equals_to(projections[c]) ) {
+					root = it->second;
+				}
+			}
+			if( root == -1 ) {
+				root = roots.size();
+				roots.push_back(projections[c]);
+				root_index[c].insert(make_pair(hash, root));
+			}
+			node_root[i*n_comps + c] = root;
+			projections[c].clear();
+		}
+	}
+
+	// components with too many projections: one root from their union (never in exact diagrams)
+	bool merged = false;
+	if( width != EXACT_BDD ) {
+		vector<int> merged_root(n_comps, -1);
+		for( int c = 0; c < n_comps; c++ ) {
+			if( (int)root_index[c].size() > decompose_max_roots ) {
+				merged_root[c] = roots.size();
+				roots.push_back(IntSet(0, n_vertices-1, false));
+				for( auto it = root_index[c].begin(); it != root_index[c].end(); ++it ) {
+					roots.back().union_with(roots[it->second]);
+				}
+				merged = true;
+			}
+		}
+		if( merged ) {
+			for( int i = 0; i < n_nodes; i++ ) {
+				for( int c = 0; c < n_comps; c++ ) {
+					if( merged_root[c] != -1 ) {
+						node_root[i*n_comps + c] = merged_root[c];
+					}
+				}
+			}
+		}
+	}
+
+	// relax the roots in use: a root with at most one vertex needs no diagram
+	vector<char> in_use(roots.size(), 0);
+	for( int i = 0; i < n_nodes * n_comps; i++ ) {
+		in_use[node_root[i]] = 1;
+	}
+	vector<int> root_bound(roots.size(), 0);
+	vector<char> root_exact(roots.size(), 1);
+	vector<int> root_width(roots.size(), 0);
+	vector<int> to_relax;
+	for( int r = 0; r < (int)roots.size(); r++ ) {
+		if( !in_use[r] || roots[r].get_size() == 0 ) {
+			continue;
+		}
+		if( roots[r].get_size() == 1 ) {
+			root_bound[r] = inst->weights[roots[r].get_first()];
+			root_width[r] = 1;
+		} else {
+			to_relax.push_back(r);
+		}
+	}
+
+	// solvers of the projections (those without factories share ordering and merger while they run)
+	bool factories = ( bb_params.make_ordering && bb_params.make_merger );
+	int n_workers = factories ? MAX(1, MIN(n_threads, (int)to_relax.size())) : 1;
+	while( (int)component_solvers.size() < n_workers ) {
+		IndepSetSolver* solver = new IndepSetSolver(inst, width);
+		solver->decompose = true;
+		component_solvers.push_back(solver);
+	}
+	for( int t = 0; t < n_workers; t++ ) {
+		IndepSetSolver* solver = component_solvers[t];
+		if( solver->inst != inst ) {
+			solver->reset(inst);
+			delete solver->ordering;
+			delete solver->merger;
+			solver->ordering = NULL;
+			solver->merger = NULL;
+		}
+		if( solver->ordering == NULL ) {
+			solver->ordering = factories ? bb_params.make_ordering(inst) : ordering;
+			solver->merger = factories ? bb_params.make_merger(inst, width) : merger;
+		}
+		solver->width = width;
+		solver->merger->width = width;
+		solver->decompose_max_roots = 1;
+		solver->dominance = dominance;
+	}
+
+	atomic<int> next_root(0);
+	auto relax_roots = [&](int t) {
+		IndepSetSolver* solver = component_solvers[t];
+		for( int k = next_root++; k < (int)to_relax.size(); k = next_root++ ) {
+			int r = to_relax[k];
+			root_bound[r] = solver->generate_relaxation(roots[r], 0);
+			root_exact[r] = solver->exact;
+			root_width[r] = solver->final_width;
+		}
+	};
+	vector<thread> threads;
+	for( int t = 1; t < n_workers; t++ ) {
+		threads.push_back(thread(relax_roots, t));
+	}
+	relax_roots(0);
+	for( int t = 0; t < (int)threads.size(); t++ ) {
+		threads[t].join();
+	}
+	for( int t = 0; t < n_workers; t++ ) {
+		if( component_solvers[t]->ordering == ordering ) {
+			component_solvers[t]->ordering = NULL;
+			component_solvers[t]->merger = NULL;
+		}
+	}
+
+	// combine
+	int bound = -INF;
+	for( int i = 0; i < n_nodes; i++ ) {
+		int value = cutset_aux[i]->longest_path;
+		for( int c = 0; c < n_comps; c++ ) {
+			value += root_bound[node_root[i*n_comps + c]];
+		}
+		bound = MAX(bound, value);
+	}
+	for( int r = 0; r < (int)roots.size(); r++ ) {
+		if( in_use[r] ) {
+			exact = exact && root_exact[r];
+			final_width = MAX(final_width, root_width[r]);
+		}
+	}
+	exact = exact && !merged;
+	decomposed_layer = layer;
+
+	for( int i = 0; i < n_nodes; i++ ) {
+		if( !node_list.is_shared(cutset_aux[i]) ) {
+			arena.destroy(cutset_aux[i]);
+		}
+	}
+	node_list.clear();
+
+	if( n_pruned > 0 ) {
+		bound = MAX(bound, prune_lb);
+	}
+	return bound;
+}
@@ -0,0 +1,115 @@
+/*
+ * --------------------------------------------------------
+ * Dominance filter of layers - implementation
+ *
+ * Node A of a layer is dominated by node B if state(A) is
+ * a subset of state(B) and longest_path(A) <= that of B:
+ * every completion of A is a completion of B, so A can be
+ * discarded without changing the relaxation bound (B's
+ * completions are relaxed anyway) or making the
+ * restriction infeasible. Distinct states of a layer are
+ * never equal, so dominators have more vertices.
+ *
+ * Nodes are taken by decreasing state size (popcount
+ * buckets) and checked only against the nodes kept so far
+ * in larger buckets: dominance is transitive, so a node
+ * dominated by a discarded one is dominated by a kept one.
+ * Before the subset test, candidates are filtered by
+ * longest path and by two word signatures of the states.
+ * --------------------------------------------------------
+ */
+
+#include <algorithm>
+
+#include "indepset_solver.hpp"
+
+using namespace std;
+
+
+/**
+ * Discard the layer nodes dominated by another layer node. The nodes kept stay in
+ * the order of the layer.
+ */
+void IndepSetSolver::remove_dominated() {
+
+	int n_nodes = nodes_layer.size();
+	dominance_keys.resize(n_nodes);
+	dominance_order.resize(n_nodes);
+	for( int i = 0; i < n_nodes; i++ ) {
+		DominanceKey &key = dominance_keys[i];
+		IntSet &state = nodes_layer[i]->state;
+		key.size = state.get_size();
+		key.folded = 0;
+		key.word_mask = 0;
+		for( int w = state.first_word; w < state.n_words; w++ ) {
+			if( state.words[w] != 0 ) {
+				key.folded |= state.words[w];
+				key.word_mask |= (uint64_t)1 << (w & 63);
+			}
+		}
+		key.dominated = false;
+		dominance_order[i] = i;
+	}
+
+	// larger states first, and longer paths first within a size
+	sort(dominance_order.begin(), dominance_order.end(), [this](int a, int b) {
+		if( dominance_keys[a].size != dominance_keys[b].size ) {
+			return dominance_keys[a].size > dominance_keys[b].size;
+		}
+		if( nodes_layer[a]->longest_path != nodes_layer[b]->longest_path ) {
+			return nodes_layer[a]->longest_path > nodes_layer[b]->longest_path;
+		}
+		return a < b;
+	});
+
+	// kept nodes of larger buckets are dominance_kept[0 .. n_larger-1]
+	dominance_kept.clear();
+	int n_larger = 0;
+	int n_removed = 0;
+	for( int k = 0; k < n_nodes; k++ ) {
+		int i = dominance_order[k];
+		DominanceKey &key = dominance_keys[i];
+		if( k > 0 && key.size != dominance_keys[dominance_order[k-1]].size ) {
+			n_larger = dominance_kept.size();
+		}
+
+		Node* node = nodes_layer[i];
+		for( int j = 0; j < n_larger && !key.dominated; j++ ) {
+			DominanceKey &other = dominance_keys[dominance_kept[j]];
+			Node* other_node = nodes_layer[dominance_kept[j]];
+			key.dominated = other_node->longest_path >= node->longest_path
+					&& (key.folded & ~other.folded) == 0
+					&& (key.word_mask & ~other.word_mask) == 0
+					&& node->state.is_subset(other_node->state);
+		}
+
+		if( key.dominated ) {
+			n_removed++;
+		} else {
+			dominance_kept.push_back(i);
+		}
+	}
+
+	if( n_removed == 0 ) {
+		return;
+	}
+
+	int n_kept = 0;
+	for( int i = 0; i < n_nodes; i++ ) {
+		if( dominance_keys[i].dominated ) {
+			if( materialize ) {
+				dd_builder.remove(nodes_layer[i]);
+			}
+			arena.destroy(nodes_layer[i]);
+		} else {
+			nodes_layer[n_kept++] = nodes_layer[i];
+		}
+	}
+	nodes_layer.resize(n_kept);
+
+	n_dominated += n_removed;
+	if( (int)dominated_in_layer.size() <= layer ) {
+		dominated_in_layer.resize(layer+1, 0);
+	}
+	dominated_in_layer[layer] += n_removed;
+}
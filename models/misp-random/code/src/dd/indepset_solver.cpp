@@ -6,10 +6,29 @@
 */
 
 #include <cassert>
+#include <climits>
+#include <thread>
+#include <sys/resource.h>
 #include "indepset_solver.hpp"
 #include "util.hpp"
 
 
+/**
+ * Run f(0), ..., f(n_threads-1) concurrently
+ */
+template<class F>
+static void run_threads(int n_threads, F f) {
+	vector<thread> threads;
+	for( int t = 1; t < n_threads; t++ ) {
+		threads.push_back(thread(f, t));
+	}
+	f(0);
+	for( int t = 0; t < (int)threads.size(); t++ ) {
+		threads[t].join();
+	}
+}
+
+
 void IndepSetSolver::initialize(IntSet &initial_state, int initial_longest_path) {
 
 	final_width = -1;
@@ -17,7 +36,7 @@ void IndepSetSolver::initialize(IntSet &initial_state, int initial_longest_path)
 	// reset active list/map
 	active_vertices.clear();
 
-	memset( in_state_counter, 0, sizeof(int)*inst->graph->n_vertices );
+	in_state.reset(initial_state);
 
 	// get nodes that are active in the initial state
 	eligible_vertex = initial_state.get_first();
@@ -27,238 +46,44 @@ void IndepSetSolver::initialize(IntSet &initial_state, int initial_longest_path)
 		active_vertex_map[eligible_vertex] = active_vertices.size();
 		active_vertices.push_back(eligible_vertex);
 
-		// update in state counter
-		in_state_counter[eligible_vertex] = 1;
-
 		eligible_vertex = initial_state.get_next(eligible_vertex);
 	}
 
-	initial_node = new Node(initial_state, initial_longest_path);
-	node_list.clear();
-	node_list[&(initial_state)] = initial_node;
+	initial_node = create_root(initial_state, initial_longest_path);
 
 	current_vertex = -1;
 
 	// reset layer
 	layer = 0;
-}
-
-int IndepSetSolver::generate_next_step_restriction(int next_vertex) {
-
-
-    if( ordering->order_type == MinState ) {
-        current_vertex = choose_next_vertex_min_size_next_layer();
-
-    } else if( ordering->order_type == RandMinState ) {
-        current_vertex = choose_next_vertex_min_size_next_layer_random();
-
-    } else {
-        current_vertex = next_vertex;
-    }
-
-    assert( current_vertex != -1 );
-    vertex_in_layer[layer] = current_vertex;
-
-    /*
-     * ===============================================================================
-     * 1. Take nodes that have the current vertex in their state
-     * ===============================================================================
-     */
-
-    nodes_layer.clear();
-
-    node_it = node_list.begin();
-    while( node_it != node_list.end() )	{
-        if( node_it->second->state.contains(current_vertex) ) {
-
-            if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-                // decrement active state counter
-                eligible_vertex = node_it->first->get_first();
-                while( eligible_vertex != node_it->first->get_end() ) {
-                    in_state_counter[ eligible_vertex]--;
-                    eligible_vertex = node_it->first->get_next(eligible_vertex);
-                }
-            }
-
-            assert( layer >= 0 );
-            //assert( (int)final_bdd.size() > layer );
-
-            // add node to current layer list
-            nodes_layer.push_back(node_it->second);
-
-            // erase element from the list
-            node_list.erase(node_it++);
-
-        } else {
-            ++node_it;
-        }
-    }
-
-
-
-    // // PRINT LAYER
-    // cout << "Layer " << layer << " - current vertex: " << current_vertex;
-    // cout << " - pool size: " << node_list.size();
-    // cout << " - before merge: " << nodes_layer.size();
-    // cout << " - total: " << node_list.size() + nodes_layer.size();
-    // cout << endl;
-
-
-    /*
-     * ===============================================================================
-     * 2. Merging
-     * ===============================================================================
-     */
-
-
-
-    int nodes_before = (int) nodes_layer.size();
-
-    if( width != EXACT_BDD && (int)nodes_layer.size() > width ) {
-        restrict_layer_shortestpath();
-    }
-
-    final_width = MAX(final_width, (int)nodes_layer.size());
-
-    cur_nodes_merged = nodes_before - (int)nodes_layer.size();
-
-    /*
-     * ===============================================================================
-     * 3. Branching
-     * ===============================================================================
-     */
-    Node* branch_node;
-    for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
-
-        branch_node = (*it);
-
-        // remove current vertex
-        branch_node->state.remove(current_vertex);
-
-        // **** one arc ****
-
-
-        node = new Node(branch_node->state, branch_node->longest_path+inst->weights[current_vertex]);
-
-        // we assume a node is adjacent to itself
-        node->state.set &= inst->adj_mask_compl[current_vertex].set;
-
-
-        existing_node_it = node_list.find(&(node->state));
-        if( existing_node_it != node_list.end() ) {
-
-            // node already exists !!!
-
-            update_node_match(existing_node_it->second, node);
-
-            delete node;
-
-        } else {
-            node_list[&(node->state)] = node;
-
-
-            // update active state counter
-            if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-                eligible_vertex = node->state.get_first();
-                while( eligible_vertex != node->state.get_end() ) {
-                    in_state_counter[ eligible_vertex] ++;
-                    eligible_vertex = node->state.get_next(eligible_vertex);
-                }
-            }
-        }
-
-        // **** zero arc ****
-        existing_node_it = node_list.find(&(branch_node->state));
-        if( existing_node_it != node_list.end() ) {
-
-            // node exists
-
-            update_node_match(existing_node_it->second, branch_node);
-
-
-            delete branch_node;
-
-        } else {
-
-            // node does not exist
-
-            // put branch node back to pool
-            node_list[&(branch_node->state)] = branch_node;
-
-            // update eligibility list
-            if( ordering->order_type == MinState || ordering->order_type == RandMinState) {
-                eligible_vertex = branch_node->state.get_first();
-                while( eligible_vertex != branch_node->state.get_end() ) {
-                    in_state_counter[ eligible_vertex] ++;
-                    eligible_vertex = branch_node->state.get_next(eligible_vertex);
-                }
-            }
-
-
-        }
-
-    }
-
-    // go to next layer
-    layer++;
-
-    return final_width;
-
 
+	// combined bounds: the restriction forks again at the first overflow
+	split = false;
+	if( restriction != NULL ) {
+		restriction->reset(inst);
+	}
 }
 
+/**
+ * Vertex of the next layer: chosen from the state counters by min state orderings,
+ * otherwise next_vertex
+ */
+int IndepSetSolver::select_vertex(int next_vertex) {
 
-int IndepSetSolver::generate_next_step_relaxation(int next_vertex) {
-
-    if( ordering->order_type == MinState ) {
-		current_vertex = choose_next_vertex_min_size_next_layer();
+	if( ordering->order_type == MinState ) {
+		return choose_next_vertex_min_size_next_layer();
 
 	} else if( ordering->order_type == RandMinState ) {
-		current_vertex = choose_next_vertex_min_size_next_layer_random();
-
-	} else {
-		current_vertex = next_vertex;
-	}
-
-	assert( current_vertex != -1 );
-	vertex_in_layer[layer] = current_vertex;
-
-	/*
-     * ===============================================================================
-     * 1. Take nodes that have the current vertex in their state
-     * ===============================================================================
-     */
-
-	nodes_layer.clear();
-
-	node_it = node_list.begin();
-	while( node_it != node_list.end() )	{
-		if( node_it->second->state.contains(current_vertex) ) {
-
-			if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-				// decrement active state counter
-				eligible_vertex = node_it->first->get_first();
-				while( eligible_vertex != node_it->first->get_end() ) {
-					in_state_counter[ eligible_vertex]--;
-					eligible_vertex = node_it->first->get_next(eligible_vertex);
-				}
-			}
-
-			assert( layer >= 0 );
-			//assert( (int)final_bdd.size() > layer );
-
-			// add node to current layer list
-			nodes_layer.push_back(node_it->second);
-
-			// erase element from the list
-			node_list.erase(node_it++);
-
-		} else {
-			++node_it;
-		}
+		return choose_next_vertex_min_size_next_layer_random();
 	}
+	return next_vertex;
+}
 
 
+/**
+ * Merge (relaxed) or remove (restricted) nodes of the extracted layer to meet the
+ * maximum width, then branch on the current vertex and go to the next layer
+ */
+int IndepSetSolver::process_layer(bool relaxed) {
 
 	// // PRINT LAYER
 	// cout << "Layer " << layer << " - current vertex: " << current_vertex;
@@ -267,116 +92,123 @@ int IndepSetSolver::generate_next_step_relaxation(int next_vertex) {
 	// cout << " - total: " << node_list.size() + nodes_layer.size();
 	// cout << endl;
 
-
-	/*
-     * ===============================================================================
-     * 2. Merging
-     * ===============================================================================
-     */
-
-
-
-    int nodes_before = (int) nodes_layer.size();
+	int nodes_before = (int) nodes_layer.size();
 
 	if( width != EXACT_BDD && (int)nodes_layer.size() > width ) {
-		//relax_layer_shortestpath();
-		merger->merge_layer(layer, nodes_layer);
-
+		if( relaxed ) {
+			exact = false;
+			DD_STAT( long start = stats_clock_ns() );
+			merger->arena = &arena;
+			merger->merge_layer(layer, nodes_layer);
+			DD_STAT( layer_stats.at(layer).nodes_merged += nodes_before - nodes_layer.size() );
+			DD_STAT( layer_stats.at(layer).ns_merge += stats_clock_ns() - start );
+		} else {
+			restrict_layer_shortestpath();
+		}
 	}
 
 	final_width = MAX(final_width, (int)nodes_layer.size());
 
-    cur_nodes_merged = nodes_before - (int)nodes_layer.size();
+	cur_nodes_merged = nodes_before - (int)nodes_layer.size();
 
-	/*
-     * ===============================================================================
-     * 3. Branching
-     * ===============================================================================
-     */
-	Node* branch_node;
-	for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
-
-		branch_node = (*it);
-
-		// remove current vertex
-		branch_node->state.remove(current_vertex);
-
-		// **** one arc ****
+	branch_layer(tracks_in_state());
 
+	// go to next layer
+	layer++;
 
-		node = new Node(branch_node->state, branch_node->longest_path+inst->weights[current_vertex]);
+	return final_width;
+}
 
-		// we assume a node is adjacent to itself
-		node->state.set &= inst->adj_mask_compl[current_vertex].set;
 
+int IndepSetSolver::generate_next_step_restriction(int next_vertex) {
 
-		existing_node_it = node_list.find(&(node->state));
-		if( existing_node_it != node_list.end() ) {
+	current_vertex = select_vertex(next_vertex);
+	assert( current_vertex != -1 );
+	vertex_in_layer[layer] = current_vertex;
 
-			// node already exists !!!
+	extract_layer(tracks_in_state());
+	return process_layer(false);
+}
 
-			update_node_match(existing_node_it->second, node);
 
-			delete node;
+int IndepSetSolver::generate_next_step_relaxation(int next_vertex) {
 
-		} else {
-			node_list[&(node->state)] = node;
+	current_vertex = select_vertex(next_vertex);
+	assert( current_vertex != -1 );
+	vertex_in_layer[layer] = current_vertex;
 
+	extract_layer(tracks_in_state());
+	return process_layer(true);
+}
 
-			// update active state counter
-			if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-				eligible_vertex = node->state.get_first();
-				while( eligible_vertex != node->state.get_end() ) {
-					in_state_counter[ eligible_vertex] ++;
-					eligible_vertex = node->state.get_next(eligible_vertex);
-				}
-			}
-		}
 
-		// **** zero arc ****
-		existing_node_it = node_list.find(&(branch_node->state));
-		if( existing_node_it != node_list.end() ) {
+/**
+ * Step of a relaxation and a restriction built together. Both share this diagram
+ * while it is exact; at the first layer wider than the maximum width, the
+ * restriction forks from it (see fork) and both are built side by side from then on.
+ * The restriction branches on the vertices chosen for the relaxation, so with min
+ * state orderings it may differ from a restriction built alone. Returns the width
+ * of the relaxation.
+ */
+int IndepSetSolver::generate_next_step_bounds(int next_vertex) {
 
-			// node exists
+	current_vertex = select_vertex(next_vertex);
+	assert( current_vertex != -1 );
+	vertex_in_layer[layer] = current_vertex;
 
-			update_node_match(existing_node_it->second, branch_node);
+	extract_layer(tracks_in_state());
 
+	if( !split && width != EXACT_BDD && (int)nodes_layer.size() > width ) {
 
-			delete branch_node;
+		// layer nodes go back to the pool, so that both solvers extract them
+		DD_STAT( layer_stats.at(layer).layer_size -= nodes_layer.size() );
+		for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
+			node_list.insert(*it);
+			if( tracks_in_state() ) {
+				add_to_in_state((*it)->state, 1);
+			}
+		}
+		nodes_layer.clear();
 
+		if( restriction == NULL ) {
+			restriction = fork();
 		} else {
-
-			// node does not exist
-
-			// put branch node back to pool
-			node_list[&(branch_node->state)] = branch_node;
-
-			// update eligibility list
-			if( ordering->order_type == MinState || ordering->order_type == RandMinState) {
-				eligible_vertex = branch_node->state.get_first();
-				while( eligible_vertex != branch_node->state.get_end() ) {
-					in_state_counter[ eligible_vertex] ++;
-					eligible_vertex = branch_node->state.get_next(eligible_vertex);
-				}
-			}
+			node_list.share(arena);
+			restriction->share_frontier(*this);
 		}
+		split = true;
+
+		extract_layer(tracks_in_state());
 	}
 
-	// go to next layer
-	layer++;
+	if( split ) {
+		restriction->current_vertex = current_vertex;
+		restriction->vertex_in_layer[layer] = current_vertex;
+		restriction->extract_layer(restriction->tracks_in_state());
+		restriction->process_layer(false);
+	}
 
-	return final_width;
+	return process_layer(true);
 }
 
+
 int IndepSetSolver::get_bound() {
 
-	int bound = node_list.begin()->second->longest_path;
+	int bound = node_list.first_lex()->longest_path;
 	//delete node_list.begin()->second;
 
 	return bound;
 }
 
 
+/**
+ * Bound of the restriction built by generate_next_step_bounds
+ */
+int IndepSetSolver::get_restriction_bound() {
+	return split ? restriction->get_bound() : get_bound();
+}
+
+
 int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longest_path) {
 
 	// ---------------------------------------
@@ -388,7 +220,7 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 	// reset active list/map
 	active_vertices.clear();
 
-	memset( in_state_counter, 0, sizeof(int)*inst->graph->n_vertices );
+	in_state.reset(initial_state);
 
 	// get nodes that are active in the initial state
 	int eligible_vertex = initial_state.get_first();
@@ -398,9 +230,6 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 		active_vertex_map[eligible_vertex] = active_vertices.size();
 		active_vertices.push_back(eligible_vertex);
 
-		// update in state counter
-		in_state_counter[eligible_vertex] = 1;
-
 		eligible_vertex = initial_state.get_next(eligible_vertex);
 	}
 
@@ -409,21 +238,31 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 	// ---------------------------------------
 
 	//Node* initial_node = new Node(initial_state, initial_longest_path, true); // b&b
-	Node* initial_node = new Node(initial_state, initial_longest_path);
-	node_list.clear();
-	node_list[&(initial_state)] = initial_node;
-
-	NodeMap::iterator node_it, existing_node_it;
-	Node* node;
+	create_root(initial_state, initial_longest_path);
 
-	int current_vertex = -1;
+	current_vertex = -1;
 
 	// reset layer
 	layer = 0;
+	decomposed_layer = -1;
+
+	return relax_layers();
+}
+
+
+/**
+ * Build the layers of a relaxation from the current layer on, returning its bound
+ */
+int IndepSetSolver::relax_layers() {
 
 	while ( layer < inst->graph->n_vertices ) {
 		//while ( current_vertex < inst->graph->n_vertices ) {
 
+		// the problem left may have split into independent components
+		if( decompose && !materialize && !spills() && !collect_cutset && find_components() ) {
+			return relax_components();
+		}
+
 		// select next vertex
 		if( ordering->order_type == MinState ) {
 			current_vertex = choose_next_vertex_min_size_next_layer();
@@ -435,9 +274,19 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 			current_vertex = ordering->vertex_in_layer(NULL, layer);
 		}
 
-		assert( current_vertex != -1 );
+		// no vertex left in any state (diagram of a subproblem is complete)
+		if( current_vertex == -1 ) {
+			break;
+		}
 		vertex_in_layer[layer] = current_vertex;
 
+		// exact diagram within memory budget
+		if( spills() ) {
+			branch_spilled_layer();
+			layer++;
+			continue;
+		}
+
 //		cout << "\n\n\n\n ====================================================== \n\n";
 //		cout << "Layer " << layer << " - current vertex: " << current_vertex << endl;
 
@@ -461,34 +310,7 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 		 * 1. Take nodes that have the current vertex in their state
 		 * ===============================================================================
 		 */
-		nodes_layer.clear();
-
-		node_it = node_list.begin();
-		while( node_it != node_list.end() )	{
-			if( node_it->second->state.contains(current_vertex) ) {
-
-				if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-					// decrement active state counter
-					eligible_vertex = node_it->first->get_first();
-					while( eligible_vertex != node_it->first->get_end() ) {
-						in_state_counter[ eligible_vertex]--;
-						eligible_vertex = node_it->first->get_next(eligible_vertex);
-					}
-				}
-
-				assert( layer >= 0 );
-				//assert( (int)final_bdd.size() > layer );
-
-				// add node to current layer list
-				nodes_layer.push_back(node_it->second);
-
-				// erase element from the list
-				node_list.erase(node_it++);
-
-			} else {
-				++node_it;
-			}
-		}
+		extract_layer(tracks_in_state());
 
 //		cout << "\nBefore merging: " << endl;
 //		for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
@@ -512,8 +334,21 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 		 * ===============================================================================
 		 */
 		if( width != EXACT_BDD && (int)nodes_layer.size() > width ) {
+			// nodes so far are exact: keep them as subproblems (b&b)
+			if( collect_cutset && exact ) {
+				save_exact_cutset();
+			}
+			exact = false;
+
+			DD_STAT( long start = stats_clock_ns() );
+			DD_STAT( long nodes_before = nodes_layer.size() );
+
 			//relax_layer_shortestpath();
+			merger->arena = &arena;
 			merger->merge_layer(layer, nodes_layer);
+
+			DD_STAT( layer_stats.at(layer).nodes_merged += nodes_before - nodes_layer.size() );
+			DD_STAT( layer_stats.at(layer).ns_merge += stats_clock_ns() - start );
 		}
 
 		final_width = MAX(final_width, (int)nodes_layer.size());
@@ -534,110 +369,8 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 		 * 3. Branching
 		 * ===============================================================================
 		 */
-		Node* branch_node;
-		for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
-
-			branch_node = (*it);
-
-			// add node to final BDD representation (bdd-save)
-			//branch_node->layer = layer;
-			//final_bdd[layer].push_back(branch_node);
-			//cout << "\n\nSET " << node_it->second->state << " --> layer " << layer << endl;
-
-
-			// remove current vertex
-			branch_node->state.remove(current_vertex);
-
-			// **** one arc ****
-			//node = new Node(branch_node->state, branch_node->longest_path+1, branch_node->exact);
-
-			node = new Node(branch_node->state, branch_node->longest_path+inst->weights[current_vertex]);
-
-			// we assume a node is adjacent to itself
-			node->state.set &= inst->adj_mask_compl[current_vertex].set;
-//			for( vector<int>::iterator v = inst->graph->adj_list[current_vertex].begin();
-//					v != inst->graph->adj_list[current_vertex].end();
-//					v++ )
-//			{
-//				node->state.remove(*v);
-//			}
-
-			existing_node_it = node_list.find(&(node->state));
-			if( existing_node_it != node_list.end() ) {
-
-				// node already exists !!!
-
-				update_node_match(existing_node_it->second, node);
-
-//				// update node links (bdd-save)
-//				assert( branch_node->one_arc == NULL );
-//				branch_node->one_arc = existing_node_it->second;
-//				existing_node_it->second->one_ancestors.push_back(branch_node);
-
-				delete node;
-
-			} else {
-				node_list[&(node->state)] = node;
-
-				// update node links (bdd-save)
-				//branch_node->one_arc = node;
-				//node->one_ancestors.push_back(branch_node);
-
-				// update active state counter
-				if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-					eligible_vertex = node->state.get_first();
-					while( eligible_vertex != node->state.get_end() ) {
-						in_state_counter[ eligible_vertex] ++;
-						eligible_vertex = node->state.get_next(eligible_vertex);
-					}
-				}
-			}
-
-			// **** zero arc ****
-			existing_node_it = node_list.find(&(branch_node->state));
-			if( existing_node_it != node_list.end() ) {
-
-				// node exists
-
-				update_node_match(existing_node_it->second, branch_node);
-
-				// update node links (bdd-save)
-				//branch_node->zero_arc = existing_node_it->second;
-				//existing_node_it->second->zero_ancestors.push_back(branch_node);
-
-				delete branch_node;
-
-			} else {
-
-				// node does not exist
-
-				// put branch node back to pool
-				node_list[&(branch_node->state)] = branch_node;
-
-				// update eligibility list
-				if( ordering->order_type == MinState || ordering->order_type == RandMinState) {
-					eligible_vertex = branch_node->state.get_first();
-					while( eligible_vertex != branch_node->state.get_end() ) {
-						in_state_counter[ eligible_vertex] ++;
-						eligible_vertex = branch_node->state.get_next(eligible_vertex);
-					}
-				}
-
-				// update node links (bdd-save)
-				//node = new Node(branch_node->state, branch_node->longest_path);
-				//node_list[&(node->state)] = node;
-				//branch_node->zero_arc = node;
-				//node->zero_ancestors.push_back(branch_node);
-
-				// update active state counter
-//				eligible_vertex = node->state.get_first();
-//				while( eligible_vertex != node->state.get_end() ) {
-//					in_state_counter[ eligible_vertex] ++;
-//					eligible_vertex = node->state.get_next(eligible_vertex);
-//				}
-			}
-
-		}
+		branch_layer(tracks_in_state());
+		bound_memory();
 
 
 //		// iterate through the nodes in the node list
@@ -656,8 +389,8 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 
 //		cout << endl << "state counter: " << endl;
 //		for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-//			if( in_state_counter[i] > 0 ) {
-//				cout << "\tvertex " << i << ": " << in_state_counter[i] << endl;
+//			if( in_state.count[i] > 0 ) {
+//				cout << "\tvertex " << i << ": " << in_state.count[i] << endl;
 //			}
 //		}
 //		cout << endl;
@@ -695,37 +428,211 @@ int IndepSetSolver::generate_relaxation(IntSet &initial_state, int initial_longe
 
 	//cout << endl;
 
-	// take bound and delete last node
-	int bound = node_list.begin()->second->longest_path;
-	delete node_list.begin()->second;
+	if( materialize ) {
+		finish_compact_dd();
+	}
+	assert( spill.empty() );
+
+	// take bound and delete last node (paths of pruned nodes are worth at most prune_lb)
+	int bound = final_value(true);
+	if( n_pruned > 0 ) {
+		bound = MAX(bound, prune_lb);
+	}
 
 	return bound;
 }
 
-int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, int initial_longest_path) {
+/**
+ * Relaxations of several widths sharing the exact layers they have in common. The diagram
+ * is built exactly, and when a layer first exceeds a width, a solver of that width forks
+ * from it (see fork) and completes the relaxation. Diagrams are neither materialized nor
+ * spilled. Bounds are returned in the order of widths.
+ */
+vector<int> IndepSetSolver::generate_relaxations(IntSet &initial_state, int initial_longest_path, const vector<int> &widths) {
 
-    // ---------------------------------------
-    // 1. Initialize
-    // ---------------------------------------
+	// widths in increasing order, exact diagram last
+	vector<int> order(widths.size());
+	for( int i = 0; i < (int)widths.size(); i++ ) {
+		order[i] = i;
+	}
+	sort(order.begin(), order.end(), [&widths](int a, int b) {
+		return ( widths[a] == EXACT_BDD ? INF : widths[a] ) < ( widths[b] == EXACT_BDD ? INF : widths[b] );
+	});
+	vector<int> bounds(widths.size());
 
-    final_width = -1;
+	int saved_width = width;
+	bool saved_materialize = materialize;
+	long saved_memory_budget = memory_budget;
+	int merger_width = merger->width;
+	width = EXACT_BDD;
+	materialize = false;
+	memory_budget = -1;
 
-    // reset active list/map
-    active_vertices.clear();
+	initialize(initial_state, initial_longest_path);
 
-    memset( in_state_counter, 0, sizeof(int)*inst->graph->n_vertices );
+	IndepSetSolver* fork = NULL;
+	int next = 0;
+	while ( layer < inst->graph->n_vertices && next < (int)order.size() ) {
 
-    // get nodes that are active in the initial state
-    int eligible_vertex = initial_state.get_first();
-    while( eligible_vertex != initial_state.get_end() ) {
+		// select next vertex
+		if( ordering->order_type == MinState ) {
+			current_vertex = choose_next_vertex_min_size_next_layer();
+
+		} else if( ordering->order_type == RandMinState ) {
+			current_vertex = choose_next_vertex_min_size_next_layer_random();
+
+		} else {
+			current_vertex = ordering->vertex_in_layer(NULL, layer);
+		}
+
+		if( current_vertex == -1 ) {
+			break;
+		}
+		vertex_in_layer[layer] = current_vertex;
+
+		extract_layer(tracks_in_state());
+
+		// relaxations of the widths this layer exceeds diverge here
+		if( next < (int)order.size() && widths[order[next]] != EXACT_BDD
+				&& (int)nodes_layer.size() > widths[order[next]] )
+		{
+			// layer nodes go back to the pool, so that forks extract them
+			int layer_width = nodes_layer.size();
+			DD_STAT( layer_stats.at(layer).layer_size -= nodes_layer.size() );
+			for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
+				node_list.insert(*it);
+				if( tracks_in_state() ) {
+					add_to_in_state((*it)->state, 1);
+				}
+			}
+			nodes_layer.clear();
+			node_list.share(arena);
+
+			while( next < (int)order.size() && widths[order[next]] != EXACT_BDD
+					&& layer_width > widths[order[next]] )
+			{
+				if( fork == NULL ) {
+					fork = new IndepSetSolver(inst, widths[order[next]]);
+				}
+				fork->share_frontier(*this);
+				fork->width = widths[order[next]];
+				merger->width = fork->width;
+				bounds[order[next]] = fork->relax_layers();
+				next++;
+			}
+
+			if( next < (int)order.size() ) {
+				extract_layer(tracks_in_state());
+			}
+		}
+
+		if( next < (int)order.size() ) {
+			final_width = MAX(final_width, (int)nodes_layer.size());
+			branch_layer(tracks_in_state());
+			layer++;
+		}
+	}
+
+	// widths never exceeded have the bound of the exact diagram
+	if( next < (int)order.size() ) {
+		int bound = final_value(true);
+		if( n_pruned > 0 ) {
+			bound = MAX(bound, prune_lb);
+		}
+		for( ; next < (int)order.size(); next++ ) {
+			bounds[order[next]] = bound;
+		}
+	}
+
+	if( fork != NULL ) {
+		delete fork;
+	}
+	merger->width = merger_width;
+	merger->arena = &arena;
+	width = saved_width;
+	materialize = saved_materialize;
+	memory_budget = saved_memory_budget;
+
+	return bounds;
+}
+
+
+/**
+ * New solver continuing the diagram of this one from the current layer, to be called
+ * between two steps. Pool nodes are not copied: they are frozen into a level shared by
+ * both pools, and each solver copies a shared node only when it branches on it or
+ * raises its longest path. Forking takes O(pool nodes) bytes, independently of the
+ * size of the states. Ordering and merger are shared with the new solver.
+ */
+IndepSetSolver* IndepSetSolver::fork() {
+
+	node_list.share(arena);
+
+	IndepSetSolver* child = new IndepSetSolver(inst, width);
+	child->share_frontier(*this);
+	return child;
+}
+
+
+/**
+ * Continue the diagram of another solver, whose pool nodes were just frozen by share.
+ * Buffers of this solver are kept, so that a solver can be forked into repeatedly.
+ */
+void IndepSetSolver::share_frontier(IndepSetSolver &from) {
+
+	if( from.materialize || from.spills() ) {
+		cout << "ERROR - materialized or memory-bounded diagrams cannot be forked" << endl;
+		exit(1);
+	}
+
+	width = from.width;
+	reset(from.inst);
+	ordering = from.ordering;
+	merger = from.merger;
+	relax = from.relax;
+	n_threads = from.n_threads;
+	dominance = from.dominance;
+
+	node_list.share_with(from.node_list);
+	exact = from.exact;
+	n_pruned = from.n_pruned;
+	prune_lb = from.prune_lb;
+	n_dominated = from.n_dominated;
+	dominated_in_layer = from.dominated_in_layer;
+	final_width = from.final_width;
+	cur_nodes_merged = from.cur_nodes_merged;
+	layer = from.layer;
+	current_vertex = from.current_vertex;
+	for( int l = 0; l < layer; l++ ) {
+		vertex_in_layer[l] = from.vertex_in_layer[l];
+	}
+	active_vertices = from.active_vertices;
+	active_vertex_map = from.active_vertex_map;
+	in_state = from.in_state;
+}
+
+
+int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, int initial_longest_path) {
+
+    // ---------------------------------------
+    // 1. Initialize
+    // ---------------------------------------
+
+    final_width = -1;
+
+    // reset active list/map
+    active_vertices.clear();
+
+    in_state.reset(initial_state);
+
+    // get nodes that are active in the initial state
+    int eligible_vertex = initial_state.get_first();
+    while( eligible_vertex != initial_state.get_end() ) {
 
         // obtain active vertex and store it in map
         active_vertex_map[eligible_vertex] = active_vertices.size();
         active_vertices.push_back(eligible_vertex);
 
-        // update in state counter
-        in_state_counter[eligible_vertex] = 1;
-
         eligible_vertex = initial_state.get_next(eligible_vertex);
     }
 
@@ -734,14 +641,9 @@ int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, in
     // ---------------------------------------
 
     //Node* initial_node = new Node(initial_state, initial_longest_path, true); // b&b
-    Node* initial_node = new Node(initial_state, initial_longest_path);
-    node_list.clear();
-    node_list[&(initial_state)] = initial_node;
-
-    NodeMap::iterator node_it, existing_node_it;
-    Node* node;
+    create_root(initial_state, initial_longest_path);
 
-    int current_vertex = -1;
+    current_vertex = -1;
 
     // reset layer
     layer = 0;
@@ -760,9 +662,19 @@ int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, in
             current_vertex = ordering->vertex_in_layer(NULL, layer);
         }
 
-        assert( current_vertex != -1 );
+        // no vertex left in any state (diagram of a subproblem is complete)
+        if( current_vertex == -1 ) {
+            break;
+        }
         vertex_in_layer[layer] = current_vertex;
 
+        // exact diagram within memory budget
+        if( spills() ) {
+            branch_spilled_layer();
+            layer++;
+            continue;
+        }
+
 //		cout << "\n\n\n\n ====================================================== \n\n";
 //		cout << "Layer " << layer << " - current vertex: " << current_vertex << endl;
 
@@ -786,34 +698,7 @@ int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, in
          * 1. Take nodes that have the current vertex in their state
          * ===============================================================================
          */
-        nodes_layer.clear();
-
-        node_it = node_list.begin();
-        while( node_it != node_list.end() )	{
-            if( node_it->second->state.contains(current_vertex) ) {
-
-                if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-                    // decrement active state counter
-                    eligible_vertex = node_it->first->get_first();
-                    while( eligible_vertex != node_it->first->get_end() ) {
-                        in_state_counter[ eligible_vertex]--;
-                        eligible_vertex = node_it->first->get_next(eligible_vertex);
-                    }
-                }
-
-                assert( layer >= 0 );
-                //assert( (int)final_bdd.size() > layer );
-
-                // add node to current layer list
-                nodes_layer.push_back(node_it->second);
-
-                // erase element from the list
-                node_list.erase(node_it++);
-
-            } else {
-                ++node_it;
-            }
-        }
+        extract_layer(tracks_in_state());
 
 //		cout << "\nBefore merging: " << endl;
 //		for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
@@ -842,110 +727,8 @@ int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, in
          * 3. Branching
          * ===============================================================================
          */
-        Node* branch_node;
-        for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
-
-            branch_node = (*it);
-
-            // add node to final BDD representation (bdd-save)
-            //branch_node->layer = layer;
-            //final_bdd[layer].push_back(branch_node);
-            //cout << "\n\nSET " << node_it->second->state << " --> layer " << layer << endl;
-
-
-            // remove current vertex
-            branch_node->state.remove(current_vertex);
-
-            // **** one arc ****
-            //node = new Node(branch_node->state, branch_node->longest_path+1, branch_node->exact);
-
-            node = new Node(branch_node->state, branch_node->longest_path+inst->weights[current_vertex]);
-
-            // we assume a node is adjacent to itself
-            node->state.set &= inst->adj_mask_compl[current_vertex].set;
-//			for( vector<int>::iterator v = inst->graph->adj_list[current_vertex].begin();
-//					v != inst->graph->adj_list[current_vertex].end();
-//					v++ )
-//			{
-//				node->state.remove(*v);
-//			}
-
-            existing_node_it = node_list.find(&(node->state));
-            if( existing_node_it != node_list.end() ) {
-
-                // node already exists !!!
-
-                update_node_match(existing_node_it->second, node);
-
-//				// update node links (bdd-save)
-//				assert( branch_node->one_arc == NULL );
-//				branch_node->one_arc = existing_node_it->second;
-//				existing_node_it->second->one_ancestors.push_back(branch_node);
-
-                delete node;
-
-            } else {
-                node_list[&(node->state)] = node;
-
-                // update node links (bdd-save)
-                //branch_node->one_arc = node;
-                //node->one_ancestors.push_back(branch_node);
-
-                // update active state counter
-                if( ordering->order_type == MinState || ordering->order_type == RandMinState ) {
-                    eligible_vertex = node->state.get_first();
-                    while( eligible_vertex != node->state.get_end() ) {
-                        in_state_counter[ eligible_vertex] ++;
-                        eligible_vertex = node->state.get_next(eligible_vertex);
-                    }
-                }
-            }
-
-            // **** zero arc ****
-            existing_node_it = node_list.find(&(branch_node->state));
-            if( existing_node_it != node_list.end() ) {
-
-                // node exists
-
-                update_node_match(existing_node_it->second, branch_node);
-
-                // update node links (bdd-save)
-                //branch_node->zero_arc = existing_node_it->second;
-                //existing_node_it->second->zero_ancestors.push_back(branch_node);
-
-                delete branch_node;
-
-            } else {
-
-                // node does not exist
-
-                // put branch node back to pool
-                node_list[&(branch_node->state)] = branch_node;
-
-                // update eligibility list
-                if( ordering->order_type == MinState || ordering->order_type == RandMinState) {
-                    eligible_vertex = branch_node->state.get_first();
-                    while( eligible_vertex != branch_node->state.get_end() ) {
-                        in_state_counter[ eligible_vertex] ++;
-                        eligible_vertex = branch_node->state.get_next(eligible_vertex);
-                    }
-                }
-
-                // update node links (bdd-save)
-                //node = new Node(branch_node->state, branch_node->longest_path);
-                //node_list[&(node->state)] = node;
-                //branch_node->zero_arc = node;
-                //node->zero_ancestors.push_back(branch_node);
-
-                // update active state counter
-//				eligible_vertex = node->state.get_first();
-//				while( eligible_vertex != node->state.get_end() ) {
-//					in_state_counter[ eligible_vertex] ++;
-//					eligible_vertex = node->state.get_next(eligible_vertex);
-//				}
-            }
-
-        }
+        branch_layer(tracks_in_state());
+        bound_memory();
 
 
 //		// iterate through the nodes in the node list
@@ -964,8 +747,8 @@ int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, in
 
 //		cout << endl << "state counter: " << endl;
 //		for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-//			if( in_state_counter[i] > 0 ) {
-//				cout << "\tvertex " << i << ": " << in_state_counter[i] << endl;
+//			if( in_state.count[i] > 0 ) {
+//				cout << "\tvertex " << i << ": " << in_state.count[i] << endl;
 //			}
 //		}
 //		cout << endl;
@@ -1003,9 +786,16 @@ int IndepSetSolver::generate_restriction_with_ordering(IntSet &initial_state, in
 
     //cout << endl;
 
+    if( materialize ) {
+        finish_compact_dd();
+    }
+    assert( spill.empty() );
+
     // take bound and delete last node
-    int bound = node_list.begin()->second->longest_path;
-    delete node_list.begin()->second;
+    int bound = final_value(true);
+    if( prune_lb != -INF ) {
+        prune_lb = MAX(prune_lb, bound);
+    }
 
     return bound;
 }
@@ -1022,7 +812,7 @@ int IndepSetSolver::generate_restriction(IntSet &initial_state, int initial_long
 	active_vertices.clear();
 	layer = 0;
 
-	memset( in_state_counter, 0, sizeof(int)*inst->graph->n_vertices );
+	in_state.reset(initial_state);
 
 	// get nodes that are active in the initial state
 	int eligible_vertex = initial_state.get_first();
@@ -1032,9 +822,6 @@ int IndepSetSolver::generate_restriction(IntSet &initial_state, int initial_long
 		active_vertex_map[eligible_vertex] = active_vertices.size();
 		active_vertices.push_back(eligible_vertex);
 
-		// update counter
-		in_state_counter[eligible_vertex] = 1;
-
 		eligible_vertex = initial_state.get_next(eligible_vertex);
 	}
 
@@ -1043,16 +830,11 @@ int IndepSetSolver::generate_restriction(IntSet &initial_state, int initial_long
 	// ---------------------------------------
 
 	//Node* initial_node = new Node(initial_state, initial_longest_path, true); // b&b
-	Node* initial_node = new Node(initial_state, initial_longest_path);
-	node_list.clear();
-	node_list[&(initial_state)] = initial_node;
-
-	NodeMap::iterator node_it, existing_node_it;
-	Node* node;
+	create_root(initial_state, initial_longest_path);
 
 	layer = 1;
 
-	int current_vertex = choose_next_vertex_min_size_next_layer();
+	current_vertex = choose_next_vertex_min_size_next_layer();
 	while ( current_vertex != -1 ) {
 	//while ( current_vertex < inst->graph->n_vertices ) {
 
@@ -1078,29 +860,7 @@ int IndepSetSolver::generate_restriction(IntSet &initial_state, int initial_long
 		/*
 		 * 1. Take the nodes that have the current vertex in their state
 		 */
-		nodes_layer.clear();
-
-		node_it = node_list.begin();
-		while( node_it != node_list.end() )	{
-			if( node_it->second->state.contains(current_vertex) ) {
-
-				// decrement active state counter
-				eligible_vertex = node_it->first->get_first();
-				while( eligible_vertex != node_it->first->get_end() ) {
-					in_state_counter[ eligible_vertex]--;
-					eligible_vertex = node_it->first->get_next(eligible_vertex);
-				}
-
-				// add node to current layer list
-				nodes_layer.push_back(node_it->second);
-
-				// erase element from the list
-				node_list.erase(node_it++);
-
-			} else {
-				++node_it;
-			}
-		}
+		extract_layer(true);
 
 //		cout << "\nBefore merging: " << endl;
 //		for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
@@ -1135,63 +895,86 @@ int IndepSetSolver::generate_restriction(IntSet &initial_state, int initial_long
 		/*
 		 * 3. Branching
 		 */
+		if( materialize ) {
+			dd_builder.begin_layer(current_vertex);
+		}
+
 		Node* branch_node;
+		Node* one_child;
+		Node* zero_child;
 		for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
 
 			branch_node = (*it);
+			int dd_node = materialize ? dd_builder.branch(branch_node, 1) : -1;
 
 			// remove current vertex
 			branch_node->state.remove(current_vertex);
+			branch_node->state.trim();
 
 			// **** one arc ****
-			//node = new Node(branch_node->state, branch_node->longest_path+1, branch_node->exact); (b&b)
-			node = new Node(branch_node->state, branch_node->longest_path+1);
-			for( vector<int>::iterator v = inst->graph->adj_list[current_vertex].begin();
-					v != inst->graph->adj_list[current_vertex].end();
+			//node = arena.create(branch_node->state, branch_node->longest_path+1, branch_node->exact); (b&b)
+			node = arena.create(branch_node->state, branch_node->longest_path+1);
+			for( const int* v = inst->graph->neighbors_begin(current_vertex);
+					v != inst->graph->neighbors_end(current_vertex);
 					v++ )
 			{
 				node->state.remove(*v);
 			}
 
-			existing_node_it = node_list.find(&(node->state));
-			if( existing_node_it != node_list.end() ) {
+			existing_node = node_list.find(node->state);
+			if( existing_node != NULL ) {
 
-				existing_node_it->second->longest_path = MAX(existing_node_it->second->longest_path, node->longest_path);
-				delete node;
+				update_node_match(existing_node, node->longest_path);
+				arena.destroy(node);
+				one_child = existing_node;
 
 			} else {
-				node_list[&(node->state)] = node;
+				node_list.insert(node);
+				one_child = node;
+				if( materialize ) {
+					dd_builder.add(node);
+				}
 
 				// update active state counter
-				eligible_vertex = node->state.get_first();
-				while( eligible_vertex != node->state.get_end() ) {
-					in_state_counter[ eligible_vertex] ++;
-					eligible_vertex = node->state.get_next(eligible_vertex);
-				}
+				add_to_in_state(node->state, 1);
 			}
 
 			// **** zero arc ****
-			existing_node_it = node_list.find(&(branch_node->state));
-			if( existing_node_it != node_list.end() ) {
+			existing_node = node_list.find(branch_node->state);
+			if( existing_node != NULL ) {
 
-				existing_node_it->second->longest_path = MAX(existing_node_it->second->longest_path, branch_node->longest_path);
-				delete branch_node;
+				update_node_match(existing_node, branch_node->longest_path);
+				arena.destroy(branch_node);
+				zero_child = existing_node;
 
 			} else {
-				node_list[&(branch_node->state)] = branch_node;
+				node_list.insert(branch_node);
+				zero_child = branch_node;
+				if( materialize ) {
+					dd_builder.add(branch_node);
+				}
 
 				// update active state counter
-				eligible_vertex = branch_node->state.get_first();
-				while( eligible_vertex != branch_node->state.get_end() ) {
-					in_state_counter[ eligible_vertex] ++;
-					eligible_vertex = branch_node->state.get_next(eligible_vertex);
-				}
+				add_to_in_state(branch_node->state, 1);
+			}
+
+			if( materialize ) {
+				dd_builder.set_arcs(dd_node, zero_child, one_child);
 			}
 		}
 		current_vertex = choose_next_vertex_min_size_next_layer();
 	}
 
-	return node_list.begin()->second->longest_path;
+	if( materialize ) {
+		finish_compact_dd();
+	}
+
+	int bound = final_value(false);
+	if( prune_lb != -INF ) {
+		prune_lb = MAX(prune_lb, bound);
+	}
+
+	return bound;
 }
 
 /**
@@ -1199,13 +982,572 @@ int IndepSetSolver::generate_restriction(IntSet &initial_state, int initial_long
  */
 void IndepSetSolver::restrict_layer_shortestpath() {
 
+	DD_STAT( long start = stats_clock_ns() );
+	DD_STAT( LayerStats &stats = layer_stats.at(layer) );
+	DD_STAT( stats.nodes_merged += nodes_layer.size() - width );
+
+	exact = false;
+
 	sort(nodes_layer.begin(), nodes_layer.end(), CompareNodesLongestPath());
 
 	/**
 	 * 1. Merge nodes
 	 */
 	for( vector<Node*>::iterator node = nodes_layer.begin()+width; node != nodes_layer.end(); ++node) {
-		delete (*node);
+		if( materialize ) {
+			dd_builder.remove(*node);
+		}
+		arena.destroy(*node);
 	}
 	nodes_layer.resize(width);
+
+	DD_STAT( stats.ns_merge += stats_clock_ns() - start );
+}
+
+
+/**
+ * Discard all nodes and start a new diagram with a single root node.
+ * The initial state must not belong to a node of this solver.
+ */
+Node* IndepSetSolver::create_root(IntSet &initial_state, int initial_longest_path) {
+
+	node_list.clear();
+	arena.reset();
+	if( merger != NULL ) {
+		merger->arena = &arena;
+	}
+
+	exact = true;
+	n_pruned = 0;
+	n_dominated = 0;
+	dominated_in_layer.clear();
+	layer_stats.clear();
+	for( vector<Node*>::iterator it = exact_cutset.begin(); it != exact_cutset.end(); ++it ) {
+		delete (*it);
+	}
+	exact_cutset.clear();
+
+	Node* root = arena.create(initial_state, initial_longest_path);
+	node_list.insert(root);
+
+	peak_bytes = memory_in_use();
+	if( spills() ) {
+		if( spill.n_vertices != inst->graph->n_vertices ) {
+			spill.resize(inst->graph->n_vertices, spill_dir.c_str());
+		}
+
+		// with a static ordering, buckets follow the layers
+		if( ordering != NULL && !tracks_in_state() ) {
+			vector<int> rank(inst->graph->n_vertices, -1);
+			for( int l = 0; l < inst->graph->n_vertices; l++ ) {
+				int v = ordering->vertex_in_layer(NULL, l);
+				if( v >= 0 && v < inst->graph->n_vertices && rank[v] == -1 ) {
+					rank[v] = l;
+				}
+			}
+			for( int v = 0; v < inst->graph->n_vertices; v++ ) {
+				if( rank[v] == -1 ) {
+					rank[v] = inst->graph->n_vertices + v;
+				}
+			}
+			spill.clear(rank);
+		} else {
+			spill.clear();
+		}
+	}
+
+	if( materialize ) {
+		dd_builder.start(&compact_dd, root);
+	}
+	if( merger != NULL ) {
+		merger->dd_builder = materialize ? &dd_builder : NULL;
+	}
+	return root;
+}
+
+
+/**
+ * Copy the nodes of the current layer and of the pool. All of them are
+ * exact and every path of the diagram goes through exactly one of them.
+ */
+void IndepSetSolver::save_exact_cutset() {
+
+	cutset_aux.clear();
+	node_list.get_nodes(cutset_aux);
+	cutset_aux.insert(cutset_aux.end(), nodes_layer.begin(), nodes_layer.end());
+
+	for( vector<Node*>::iterator it = cutset_aux.begin(); it != cutset_aux.end(); ++it ) {
+		exact_cutset.push_back(new Node((*it)->state, (*it)->longest_path));
+	}
+}
+
+
+/**
+ * Take nodes that have the current vertex in their state out of the pool.
+ */
+void IndepSetSolver::extract_layer(bool update_in_state) {
+
+	DD_STAT( long start = stats_clock_ns() );
+	DD_STAT( LayerStats &stats = layer_stats.at(layer) );
+	DD_STAT( stats.pool_size = MAX(stats.pool_size, (long)node_list.size()) );
+	DD_STAT( stats_slab_bytes = arena.stats.slab_bytes );
+
+	nodes_layer.clear();
+	node_list.extract(current_vertex, nodes_layer);
+
+	// layer nodes are modified: nodes shared with forks are copied
+	if( !node_list.shared.empty() ) {
+		for( int i = 0; i < (int)nodes_layer.size(); i++ ) {
+			if( node_list.is_shared(nodes_layer[i]) ) {
+				nodes_layer[i] = arena.create(nodes_layer[i]->state, nodes_layer[i]->longest_path);
+			}
+		}
+	}
+
+	if( update_in_state ) {
+		// decrement active state counters
+		for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
+			add_to_in_state((*it)->state, -1);
+		}
+	}
+
+	if( prune_lb != -INF ) {
+		prune_layer();
+	}
+
+	if( dominance && width != EXACT_BDD && (int)nodes_layer.size() > width ) {
+		remove_dominated();
+	}
+
+	// merging and restriction break ties according to the layer order, which
+	// must not depend on the position of nodes in the pool
+	if( width != EXACT_BDD && (int)nodes_layer.size() > width ) {
+		sort(nodes_layer.begin(), nodes_layer.end(), CompareNodesStateLex());
+	}
+
+	DD_STAT( stats.layer_size += nodes_layer.size() );
+	DD_STAT( stats.ns_extract += stats_clock_ns() - start );
+}
+
+
+/**
+ * Set the completion bound of the layer nodes and discard those that cannot lead
+ * to a solution better than prune_lb.
+ */
+void IndepSetSolver::prune_layer() {
+
+	if( (int)inst->clique_of.size() != inst->graph->n_vertices ) {
+		inst->build_clique_cover();
+	}
+
+	int n_kept = 0;
+	for( int i = 0; i < (int)nodes_layer.size(); i++ ) {
+		Node* layer_node = nodes_layer[i];
+		layer_node->relax_ub = layer_node->longest_path + completion_bound(layer_node->state);
+
+		if( layer_node->relax_ub <= prune_lb ) {
+			if( materialize ) {
+				dd_builder.remove(layer_node);
+			}
+			arena.destroy(layer_node);
+			n_pruned++;
+		} else {
+			nodes_layer[n_kept++] = layer_node;
+		}
+	}
+	nodes_layer.resize(n_kept);
+}
+
+
+/**
+ * Value of the last diagram: longest path of the terminal node, or prune_lb
+ * if all nodes were pruned
+ */
+int IndepSetSolver::final_value(bool destroy_terminal) {
+
+	Node* terminal = node_list.first_lex();
+	if( terminal == NULL ) {
+		return prune_lb;
+	}
+
+	int value = terminal->longest_path;
+	if( destroy_terminal && !node_list.is_shared(terminal) ) {
+		arena.destroy(terminal);
+	}
+	return value;
+}
+
+
+/**
+ * Create zero and one arcs of all nodes in the layer, adding new nodes to the pool.
+ */
+void IndepSetSolver::branch_layer(bool update_in_state) {
+
+	DD_STAT( long start = stats_clock_ns() );
+	DD_STAT( LayerStats &stats = layer_stats.at(layer) );
+	DD_STAT( stats.nodes_created += 2*nodes_layer.size() );
+
+	// the parallel version does not record arcs, nor copies nodes shared with forks
+	if( n_threads > 1 && !materialize && node_list.shared.empty() && (int)nodes_layer.size() >= BRANCH_PARALLEL_MIN_NODES ) {
+		branch_layer_parallel(update_in_state);
+		DD_STAT( stats.bytes_allocated += arena.stats.slab_bytes - stats_slab_bytes );
+		DD_STAT( stats.ns_branch += stats_clock_ns() - start );
+		return;
+	}
+
+	if( materialize ) {
+		dd_builder.begin_layer(current_vertex);
+	}
+
+	Node* branch_node;
+	int dd_node = -1;
+	for( vector<Node*>::iterator it = nodes_layer.begin(); it != nodes_layer.end(); ++it ) {
+
+		branch_node = (*it);
+
+		// add node to materialized diagram
+		if( materialize ) {
+			dd_node = dd_builder.branch(branch_node, inst->weights[current_vertex]);
+		}
+
+		// remove current vertex (words left empty are skipped from now on)
+		branch_node->state.remove(current_vertex);
+		branch_node->state.trim();
+
+		// **** one arc ****
+
+		// the child state is looked up first: a node is made only for a new state
+		// (we assume a node is adjacent to itself)
+		one_arc_state = branch_node->state;
+		one_arc_state.intersect_with(inst->adj_mask_compl[current_vertex]);
+		uint64_t hash = one_arc_state.get_hash();
+		int longest_path = branch_node->longest_path+inst->weights[current_vertex];
+
+		existing_node = node_list.find(one_arc_state, hash);
+		if( existing_node != NULL ) {
+
+			// node already exists !!!
+
+			DD_STAT( stats.dedup_hits++ );
+			DD_STAT( stats.nodes_created-- );
+			update_node_match(existing_node, longest_path);
+			node = existing_node;
+
+		} else {
+			node = arena.create(one_arc_state, longest_path);
+			node_list.insert(node, hash);
+			if( materialize ) {
+				dd_builder.add(node);
+			}
+
+			// update active state counter
+			if( update_in_state ) {
+				add_to_in_state(node->state, 1);
+			}
+		}
+
+		// **** zero arc ****
+		hash = branch_node->state.get_hash();
+		existing_node = node_list.find(branch_node->state, hash);
+		if( existing_node != NULL ) {
+
+			// node exists
+
+			DD_STAT( stats.dedup_hits++ );
+			DD_STAT( stats.nodes_created-- );
+			update_node_match(existing_node, branch_node->longest_path);
+			arena.destroy(branch_node);
+			branch_node = existing_node;
+
+		} else {
+
+			// node does not exist
+
+			// put branch node back to pool
+			node_list.insert(branch_node, hash);
+			if( materialize ) {
+				dd_builder.add(branch_node);
+			}
+
+			// update eligibility list
+			if( update_in_state ) {
+				add_to_in_state(branch_node->state, 1);
+			}
+		}
+
+		// arcs of materialized diagram
+		if( materialize ) {
+			dd_builder.set_arcs(dd_node, branch_node, node);
+		}
+	}
+
+	DD_STAT( stats.bytes_allocated += arena.stats.slab_bytes - stats_slab_bytes );
+	DD_STAT( stats.ns_branch += stats_clock_ns() - start );
+}
+
+
+/**
+ * Branch on the current vertex in an exact diagram within the memory budget.
+ * Spilled nodes of the layer are brought back to the pool in chunks, and each
+ * chunk is branched with the pool nodes of the layer before the next one is
+ * read. A spilled state may have been created again meanwhile: both copies are
+ * in the state counters, so a copy merged into a pool node is removed from them.
+ */
+void IndepSetSolver::branch_spilled_layer() {
+
+	bool update_in_state = tracks_in_state();
+
+	// a chunk and its children take about half of the budget
+	long node_bytes = arena.slot_bytes + sizeof(NodeTable::Slot) + sizeof(Node*);
+	int chunk_nodes = MAX(1, (int)MIN((long)INT_MAX, memory_budget / (6*node_bytes)));
+
+	spill.take_layer(current_vertex);
+	int layer_width = 0;
+	do {
+		spill.read_layer(chunk_nodes, [&](IntSet &state, int longest_path) {
+			uint64_t hash = state.get_hash();
+			existing_node = node_list.find(state, hash);
+			if( existing_node != NULL ) {
+				existing_node->longest_path = MAX(existing_node->longest_path, longest_path);
+				if( update_in_state ) {
+					add_to_in_state(state, -1);
+				}
+			} else {
+				node_list.insert(arena.create(state, longest_path), hash);
+			}
+		});
+
+		extract_layer(update_in_state);
+		layer_width += nodes_layer.size();
+		peak_bytes = MAX(peak_bytes, memory_in_use());
+
+		branch_layer(update_in_state);
+		bound_memory();
+
+	} while( spill.layer_nodes > 0 );
+
+	final_width = MAX(final_width, layer_width);
+}
+
+
+/**
+ * Track peak memory and, if the budget is exceeded, spill the pool nodes
+ * needed last (largest bucket rank) until half of the budget is used.
+ * Nodes stay in the state counters, so orderings see the whole pool.
+ */
+void IndepSetSolver::bound_memory() {
+
+	long in_use = memory_in_use();
+	peak_bytes = MAX(peak_bytes, in_use);
+	if( !spills() || in_use <= memory_budget ) {
+		return;
+	}
+
+	cutset_aux.clear();
+	node_list.get_nodes(cutset_aux);
+
+	// (rank of bucket, position) of nodes that can be spilled, needed last first
+	vector< pair<int,int> > candidates;
+	vector<int> buckets(cutset_aux.size());
+	for( int i = 0; i < (int)cutset_aux.size(); i++ ) {
+		// the terminal node stays in memory
+		if( cutset_aux[i]->state.get_size() > 0 ) {
+			buckets[i] = spill.bucket_of(cutset_aux[i]->state);
+			candidates.push_back(pair<int,int>(-spill.rank[buckets[i]], i));
+		}
+	}
+	sort(candidates.begin(), candidates.end());
+
+	long to_free = in_use - memory_budget/2;
+	int n_spilled = 0;
+	while( n_spilled < (int)candidates.size() && to_free > 0 ) {
+		Node* node = cutset_aux[candidates[n_spilled].second];
+		to_free -= arena.slot_bytes + node->state.get_size() * sizeof(int);
+		n_spilled++;
+	}
+
+	// write nodes of each bucket together
+	vector<Node*> bucket_nodes;
+	for( int i = 0; i < n_spilled; ) {
+		int bucket = buckets[candidates[i].second];
+		bucket_nodes.clear();
+		for( ; i < n_spilled && buckets[candidates[i].second] == bucket; i++ ) {
+			bucket_nodes.push_back(cutset_aux[candidates[i].second]);
+		}
+		spill.write(bucket, bucket_nodes.begin(), bucket_nodes.end());
+		for( vector<Node*>::iterator node = bucket_nodes.begin(); node != bucket_nodes.end(); ++node ) {
+			node_list.erase(*node);
+			arena.destroy(*node);
+		}
+	}
+}
+
+
+/**
+ * Peak resident memory of the process in bytes (0 if unknown)
+ */
+static long peak_resident_bytes() {
+	struct rusage usage;
+	if( getrusage(RUSAGE_SELF, &usage) != 0 ) {
+		return 0;
+	}
+	return usage.ru_maxrss * 1024L;
+}
+
+
+/**
+ * Print memory used by the last diagram and spill counters
+ */
+void IndepSetSolver::print_memory_stats(ostream &os) {
+	os << "	peak bytes of nodes: " << peak_bytes << endl;
+	os << "	peak resident bytes: " << peak_resident_bytes() << endl;
+	os << "	memory budget: " << memory_budget << endl;
+	spill.print_stats(os);
+}
+
+
+/**
+ * Complete the materialized diagram with the nodes left in the pool.
+ */
+void IndepSetSolver::finish_compact_dd() {
+	cutset_aux.clear();
+	node_list.get_nodes(cutset_aux);
+	dd_builder.finish(cutset_aux);
+}
+
+
+/**
+ * Same as branch_layer, with the work split among threads.
+ *
+ * Threads first compute the child states of disjoint slices of the layer.
+ * Children are then split into shards by hash, and each shard is checked
+ * against the pool and deduplicated by one thread. Finally, new nodes are
+ * added to the pool in the order the serial version would add them, so
+ * the resulting pool is identical.
+ */
+void IndepSetSolver::branch_layer_parallel(bool update_in_state) {
+
+	int n_nodes = nodes_layer.size();
+	int n_candidates = 2*n_nodes;
+
+	if( (int)branch_states.size() < n_nodes ) {
+		branch_states.resize(n_nodes, IntSet(0, inst->graph->n_vertices-1, false));
+	}
+	branch_hash.resize(n_candidates);
+	branch_longest_path.resize(n_candidates);
+	branch_rep.resize(n_candidates);
+	branch_shards.resize(n_threads);
+	branch_shard_tables.resize(n_threads);
+
+	// 1. compute children of each node
+	run_threads(n_threads, [this, n_nodes](int t) {
+		int first = (long)n_nodes * t / n_threads;
+		int last = (long)n_nodes * (t+1) / n_threads;
+		for( int i = first; i < last; i++ ) {
+			Node* branch_node = nodes_layer[i];
+
+			// zero arc: remove current vertex from the node itself
+			branch_node->state.remove(current_vertex);
+			branch_node->state.trim();
+			branch_hash[2*i+1] = branch_node->state.get_hash();
+			branch_longest_path[2*i+1] = branch_node->longest_path;
+
+			// one arc (we assume a node is adjacent to itself)
+			branch_states[i] = branch_node->state;
+			branch_states[i].intersect_with(inst->adj_mask_compl[current_vertex]);
+			branch_hash[2*i] = branch_states[i].get_hash();
+			branch_longest_path[2*i] = branch_node->longest_path + inst->weights[current_vertex];
+		}
+	});
+
+	// 2. find existing nodes and duplicates, one hash shard per thread
+	for( int s = 0; s < n_threads; s++ ) {
+		branch_shards[s].clear();
+	}
+	for( int c = 0; c < n_candidates; c++ ) {
+		branch_shards[(branch_hash[c] >> 32) % n_threads].push_back(c);
+	}
+	DD_STAT( long start = stats_clock_ns() );
+	run_threads(n_threads, [this](int t) {
+		dedup_branch_shard(t);
+	});
+	DD_STAT( LayerStats &stats = layer_stats.at(layer) );
+	DD_STAT( stats.ns_dedup += stats_clock_ns() - start );
+
+	// 3. add new nodes to the pool in serial order
+	Node* new_node;
+	for( int c = 0; c < n_candidates; c++ ) {
+		if( branch_rep[c] == c ) {
+			if( c % 2 == 0 ) {
+				new_node = arena.create(branch_states[c/2], branch_longest_path[c]);
+			} else {
+				new_node = nodes_layer[c/2];
+				new_node->longest_path = branch_longest_path[c];
+			}
+			node_list.insert(new_node, branch_hash[c]);
+
+			// update active state counter
+			if( update_in_state ) {
+				add_to_in_state(new_node->state, 1);
+			}
+
+		} else if( c % 2 == 1 ) {
+			// zero arc node is represented by another node
+			arena.destroy(nodes_layer[c/2]);
+		}
+
+		if( branch_rep[c] != c ) {
+			DD_STAT( stats.dedup_hits++ );
+			DD_STAT( stats.nodes_created-- );
+		}
+	}
+}
+
+
+/**
+ * Match the candidates of a shard against the pool and against each other.
+ * Longest paths are accumulated in the pool node or in the first candidate
+ * with the same state. Only this shard touches these nodes and candidates.
+ */
+void IndepSetSolver::dedup_branch_shard(int shard) {
+
+	vector<int> &candidates = branch_shards[shard];
+	vector<int> &table = branch_shard_tables[shard];
+
+	int n_slots = 16;
+	while( n_slots < 2*(int)candidates.size() ) {
+		n_slots *= 2;
+	}
+	table.assign(n_slots, -1);
+	uint64_t mask = n_slots - 1;
+
+	for( vector<int>::iterator it = candidates.begin(); it != candidates.end(); ++it ) {
+		int c = *it;
+		IntSet &state = ( c % 2 == 0 ) ? branch_states[c/2] : nodes_layer[c/2]->state;
+
+		Node* existing = node_list.find(state, branch_hash[c]);
+		if( existing != NULL ) {
+			existing->longest_path = MAX(existing->longest_path, branch_longest_path[c]);
+			branch_rep[c] = -1;
+			continue;
+		}
+
+		uint64_t i = branch_hash[c] & mask;
+		while( table[i] != -1 ) {
+			int r = table[i];
+			IntSet &rep_state = ( r % 2 == 0 ) ? branch_states[r/2] : nodes_layer[r/2]->state;
+			if( branch_hash[r] == branch_hash[c] && rep_state.equals_to(state) ) {
+				break;
+			}
+			i = (i+1) & mask;
+		}
+
+		if( table[i] == -1 ) {
+			table[i] = c;
+			branch_rep[c] = c;
+		} else {
+			branch_rep[c] = table[i];
+			branch_longest_path[table[i]] = MAX(branch_longest_path[table[i]], branch_longest_path[c]);
+		}
+	}
 }
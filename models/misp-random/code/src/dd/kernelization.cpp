@@ -0,0 +1,332 @@
+/*
+ * --------------------------------------------------------
+ * Kernelization of independent set instances - implementation
+ *
+ * Neighbor lists are kept sorted and updated as vertices
+ * are removed; vertices made by folds get the next index,
+ * so appending them keeps lists sorted. Vertices whose
+ * neighborhood or weight changed are queued again, and
+ * reductions stop when the queue is empty. Domination
+ * and twins are found by merging or comparing the sorted
+ * lists of a vertex and of its neighbors.
+ * --------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+#include "kernelization.hpp"
+
+using namespace std;
+
+
+/**
+ * Reduce an instance
+ */
+void Kernelization::reduce(IndepSetInst* inst) {
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	n_original = inst->graph->n_vertices;
+	adj.assign(n_original, vector<int>());
+	weight.resize(n_original);
+	original_of.resize(n_original);
+	for( int v = 0; v < n_original; v++ ) {
+		for( const int* u = inst->graph->neighbors_begin(v); u != inst->graph->neighbors_end(v); ++u ) {
+			if( *u != v ) {
+				adj[v].push_back(*u);
+			}
+		}
+		weight[v] = inst->weights[v];
+		original_of[v] = v;
+	}
+	alive.assign(n_original, 1);
+	steps.clear();
+	offset = 0;
+	n_taken = n_pendant = n_folded = n_dominated = n_twins = n_nonpositive = 0;
+
+	queue.clear();
+	queued.assign(n_original, 0);
+	queue_head = 0;
+	for( int v = 0; v < n_original; v++ ) {
+		push(v);
+	}
+	while( queue_head < queue.size() ) {
+		int v = queue[queue_head++];
+		queued[v] = 0;
+		if( alive[v] ) {
+			reduce_vertex(v);
+		}
+		if( queue_head == queue.size() ) {
+			queue.clear();
+			queue_head = 0;
+		}
+	}
+
+	build_kernel(inst);
+	seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+/**
+ * Apply the first reduction that fits a vertex (returns if one did)
+ */
+bool Kernelization::reduce_vertex(int v) {
+
+	if( weight[v] <= 0 ) {
+		remove_vertex(v);
+		n_nonpositive++;
+		return true;
+	}
+
+	// neighborhood: v is in an optimal solution (neighbors of nonpositive weight never are)
+	long neighbors_weight = 0;
+	for( int i = 0; i < (int)adj[v].size(); i++ ) {
+		neighbors_weight += MAX(0, weight[adj[v][i]]);
+	}
+	if( weight[v] >= neighbors_weight ) {
+		vector<int> neighbors = adj[v];
+		steps.push_back(KernelStep(KernelStep::Take, v));
+		offset += weight[v];
+		remove_vertex(v);
+		for( int i = 0; i < (int)neighbors.size(); i++ ) {
+			remove_vertex(neighbors[i]);
+		}
+		n_taken++;
+		return true;
+	}
+
+	// pendant lighter than its neighbor: u or v is in an optimal solution
+	if( adj[v].size() == 1 ) {
+		int u = adj[v][0];
+		steps.push_back(KernelStep(KernelStep::Pendant, v, u));
+		offset += weight[v];
+		weight[u] -= weight[v];
+		remove_vertex(v);
+		for( int i = 0; i < (int)adj[u].size(); i++ ) {
+			push(adj[u][i]);
+		}
+		n_pendant++;
+		return true;
+	}
+
+	// degree 2 with non-adjacent neighbors: v or both neighbors are in an optimal solution
+	if( adj[v].size() == 2 ) {
+		int a = adj[v][0];
+		int b = adj[v][1];
+		if( weight[v] >= MAX(weight[a], weight[b]) && !binary_search(adj[a].begin(), adj[a].end(), b) ) {
+			vector<int> merged, neighbors;
+			set_union(adj[a].begin(), adj[a].end(), adj[b].begin(), adj[b].end(), back_inserter(merged));
+			for( int i = 0; i < (int)merged.size(); i++ ) {
+				if( merged[i] != v ) {
+					neighbors.push_back(merged[i]);
+				}
+			}
+			int z_weight = weight[a] + weight[b] - weight[v];
+			offset += weight[v];
+			remove_vertex(v);
+			remove_vertex(a);
+			remove_vertex(b);
+			int z = add_vertex(neighbors, z_weight, original_of[v]);
+			steps.push_back(KernelStep(KernelStep::Fold, v, a, b, z));
+			n_folded++;
+			return true;
+		}
+	}
+
+	// domination: neighbors whose closed neighborhood contains that of v
+	bool removed = false;
+	vector<int> neighbors = adj[v];
+	for( int i = 0; i < (int)neighbors.size(); i++ ) {
+		int u = neighbors[i];
+		if( alive[u] && weight[u] <= weight[v] && adj[u].size() >= adj[v].size() && dominates(v, u) ) {
+			remove_vertex(u);
+			n_dominated++;
+			removed = true;
+		}
+	}
+	if( removed ) {
+		push(v);
+		return true;
+	}
+
+	// twins: both or none are in an optimal solution
+	int u = find_twin(v);
+	if( u != -1 ) {
+		steps.push_back(KernelStep(KernelStep::Twin, u, v));
+		weight[v] += weight[u];
+		remove_vertex(u);
+		for( int i = 0; i < (int)adj[v].size(); i++ ) {
+			push(adj[v][i]);
+		}
+		push(v);
+		n_twins++;
+		return true;
+	}
+
+	return false;
+}
+
+
+/**
+ * Remove a vertex from the graph, queueing its neighbors
+ */
+void Kernelization::remove_vertex(int v) {
+	alive[v] = 0;
+	for( int i = 0; i < (int)adj[v].size(); i++ ) {
+		vector<int> &list = adj[adj[v][i]];
+		list.erase(lower_bound(list.begin(), list.end(), v));
+		push(adj[v][i]);
+	}
+	vector<int>().swap(adj[v]);
+}
+
+
+/**
+ * Add a vertex with given neighbors (sorted), returning its index
+ */
+int Kernelization::add_vertex(const vector<int> &neighbors, int w, int original) {
+	int z = adj.size();
+	adj.push_back(neighbors);
+	weight.push_back(w);
+	original_of.push_back(original);
+	alive.push_back(1);
+	queued.push_back(0);
+	for( int i = 0; i < (int)neighbors.size(); i++ ) {
+		adj[neighbors[i]].push_back(z);
+		push(neighbors[i]);
+	}
+	push(z);
+	return z;
+}
+
+
+/**
+ * Check if N[v] is contained in N[u], for adjacent v and u
+ */
+bool Kernelization::dominates(int v, int u) {
+	vector<int>::const_iterator it = adj[u].begin();
+	for( int i = 0; i < (int)adj[v].size(); i++ ) {
+		int x = adj[v][i];
+		if( x == u ) {
+			continue;
+		}
+		while( it != adj[u].end() && *it < x ) {
+			++it;
+		}
+		if( it == adj[u].end() || *it != x ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Vertex of positive weight with the same neighbors as v, found among the neighbors
+ * of its neighbor of smallest degree (-1 if none)
+ */
+int Kernelization::find_twin(int v) {
+	if( adj[v].empty() ) {
+		return -1;
+	}
+	int x = adj[v][0];
+	for( int i = 1; i < (int)adj[v].size(); i++ ) {
+		if( adj[adj[v][i]].size() < adj[x].size() ) {
+			x = adj[v][i];
+		}
+	}
+	for( int i = 0; i < (int)adj[x].size(); i++ ) {
+		int u = adj[x][i];
+		if( u != v && weight[u] > 0 && adj[u] == adj[v] ) {
+			return u;
+		}
+	}
+	return -1;
+}
+
+
+/**
+ * Build the instance of the vertices left, in increasing order
+ */
+void Kernelization::build_kernel(IndepSetInst* inst) {
+
+	kernel_of.assign(adj.size(), -1);
+	kernel_id.clear();
+	for( int v = 0; v < (int)adj.size(); v++ ) {
+		if( alive[v] ) {
+			kernel_of[v] = kernel_id.size();
+			kernel_id.push_back(v);
+		}
+	}
+
+	vector< pair<int,int> > edges;
+	for( int k = 0; k < (int)kernel_id.size(); k++ ) {
+		vector<int> &list = adj[kernel_id[k]];
+		for( int i = 0; i < (int)list.size(); i++ ) {
+			if( kernel_of[list[i]] > k ) {
+				edges.push_back(pair<int,int>(k, kernel_of[list[i]]));
+			}
+		}
+	}
+
+	delete kernel;
+	kernel = new IndepSetInst;
+	kernel->build_from_edges(kernel_id.size(), edges);
+
+	kernel_vertex.assign(n_original, -1);
+	for( int k = 0; k < (int)kernel_id.size(); k++ ) {
+		kernel->weights[k] = weight[kernel_id[k]];
+		kernel_vertex[original_of[kernel_id[k]]] = k;
+	}
+	for( map<int,int>::const_iterator it = inst->node_mapping.begin(); it != inst->node_mapping.end(); ++it ) {
+		if( kernel_vertex[it->second] != -1 ) {
+			kernel->node_mapping[it->first] = kernel_vertex[it->second];
+		}
+	}
+}
+
+
+/**
+ * Solution of the original instance from a solution of the kernel, undoing the
+ * reductions from the last one
+ */
+void Kernelization::lift_solution(const vector<int> &kernel_solution, vector<int> &solution) const {
+
+	vector<char> in_solution(adj.size(), 0);
+	for( int i = 0; i < (int)kernel_solution.size(); i++ ) {
+		in_solution[kernel_id[kernel_solution[i]]] = 1;
+	}
+
+	for( int s = (int)steps.size()-1; s >= 0; s-- ) {
+		const KernelStep &step = steps[s];
+		switch( step.type ) {
+		case KernelStep::Take:
+			in_solution[step.v] = 1;
+			break;
+		case KernelStep::Pendant:
+			in_solution[step.v] = !in_solution[step.u];
+			break;
+		case KernelStep::Fold:
+			if( in_solution[step.z] ) {
+				in_solution[step.u] = 1;
+				in_solution[step.w] = 1;
+				in_solution[step.z] = 0;
+			} else {
+				in_solution[step.v] = 1;
+			}
+			break;
+		case KernelStep::Twin:
+			in_solution[step.v] = in_solution[step.u];
+			break;
+		}
+	}
+
+	solution.clear();
+	for( int v = 0; v < n_original; v++ ) {
+		if( in_solution[v] ) {
+			solution.push_back(v);
+		}
+	}
+}
@@ -24,33 +24,11 @@ void MinLongestPath::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 	IntSet* state = &(nodes_layer[width-1]->state);
 
-	//cout << "state: " << *state << endl;
 	for( vector<Node*>::iterator node = nodes_layer.begin()+width; node != nodes_layer.end(); ++node) {
-/*
-        cout << "Nodes to merges" << endl;
-        cout << "n1: " << *state << endl;
-        cout << "n2: " << (*node)->state << endl;*/
-		IntSet s_union = *state;
-		IntSet s_intersect = *state;
-		//cout << "Before op" << endl;
-		//cout << "s_union: " << s_union << endl;
-		//cout << "s_intersect: " << s_intersect << endl;
-		s_union.union_with((*node)->state);
-		s_intersect.intersect_with((*node)->state);
-		/*
-		cout << "after op" << endl;
-        cout << "s_union: " << s_union << endl;
-        cout << "s_intersect: " << s_intersect << endl;
-        */
-
-		gap += (s_union.get_size() - s_intersect.get_size());
-
+		add_gap(*state, (*node)->state);
 		state->union_with((*node)->state);
-
-		delete (*node);
-
+		release_node(*node, nodes_layer[width-1]);
 	}
-    //cout << "------------" << endl;
 	nodes_layer.resize(width);
 
 	/**
@@ -65,7 +43,7 @@ void MinLongestPath::merge_layer(int layer, vector<Node*> &nodes_layer) {
 		if( node->state.equals_to(*state) ) {
 
 			// delete the last node
-			delete nodes_layer.back();
+			release_node(nodes_layer.back(), node);
 
 			// remove it from queue
 			nodes_layer.pop_back();
@@ -86,10 +64,12 @@ void PairMinLongestPath::merge_layer(int layer, vector<Node*> &nodes_layer) {
 	// sort nodes
 	sort(nodes_layer.begin(), nodes_layer.end(), CompareNodesLongestPath());
 
+	gap = 0;
+
 	// populate current states with given nodes
 	current_states.clear();
 	for( vector<Node*>::iterator node = nodes_layer.begin(); node != nodes_layer.end(); node++ ) {
-		current_states[&((*node)->state)] = *node;
+		current_states.insert(*node);
 	}
 
 	// merge nodes from the end of the list until max. width is reached
@@ -108,11 +88,12 @@ void PairMinLongestPath::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 
 		// erase both elements from map
-		current_states.erase(&(nodes_layer[current_size-2]->state));
-		current_states.erase(&(nodes_layer[current_size-1]->state));
+		current_states.erase(nodes_layer[current_size-2]);
+		current_states.erase(nodes_layer[current_size-1]);
 
 		// merge the two last nodes. Notice that node at current_size-2 already has a larger
 		// longest path
+		add_gap(nodes_layer[current_size-2]->state, nodes_layer[current_size-1]->state);
 		nodes_layer[current_size-2]->state.union_with(nodes_layer[current_size-1]->state);
 
 		//        cout << "\tmerging " << current_size - 2 << " with " << current_size-1 << endl;
@@ -120,27 +101,27 @@ void PairMinLongestPath::merge_layer(int layer, vector<Node*> &nodes_layer) {
 		//        cout << "\tshortest path: " << bdd->nodes[layer][current_size-2]->shortest_path << endl;
 
 		// remove last node from BDD (without consistency check)
-		delete nodes_layer[current_size-1];
+		release_node(nodes_layer[current_size-1], nodes_layer[current_size-2]);
 		nodes_layer.pop_back();
 		current_size--;
 
 		// now, we must check if the state of the new node appears in any previous node
-		NodeMap::iterator map_it = current_states.find(&(nodes_layer[current_size-1]->state));
-		if( map_it != current_states.end() ) {
+		Node* existing = current_states.find(nodes_layer[current_size-1]->state);
+		if( existing != NULL ) {
 
 			// we just have to delete this last node. Notice that
 			// we do not need to re-sort the vector, since the existing node
 			// already has a larger longest path in comparison to the latter node
 
 			// remove last node from BDD (without consistency check)
-			delete nodes_layer[current_size-1];
+			release_node(nodes_layer[current_size-1], existing);
 			nodes_layer.pop_back();
 			current_size--;
 
 
 		} else {
 			// otherwise, we add the node to the set of current states
-			current_states[&(nodes_layer[current_size-1]->state)] = nodes_layer[current_size-1];
+			current_states.insert(nodes_layer[current_size-1]);
 		}
 	}
 }
@@ -156,6 +137,7 @@ void ConsecutivePairLongestPath::merge_layer(int layer, vector<Node*> &nodes_lay
 
 	// reset old nodes
 	old_nodes.clear();
+	gap = 0;
 
 	// merge while maximum width is not met
 	while( old_nodes.size() + nodes_layer.size() > (unsigned int)width ) {
@@ -186,9 +168,10 @@ void ConsecutivePairLongestPath::merge_layer(int layer, vector<Node*> &nodes_lay
 			old_nodes.pop_back();
 
 			// merge into node A
+			add_gap(nodeA->state, nodeB->state);
 			nodeA->state.union_with(nodeB->state);
 			assert( nodeA->longest_path >= nodeB->longest_path );
-			delete nodeB;
+			release_node(nodeB, nodeA);
 
 			// check if new state exists in old list
 			found = false;
@@ -197,7 +180,7 @@ void ConsecutivePairLongestPath::merge_layer(int layer, vector<Node*> &nodes_lay
 					// if node exists in old list, we simply delete nodeA
 					found = true;
 					assert( old_nodes[i]->longest_path >= nodeA->longest_path );
-					delete nodeA;
+					release_node(nodeA, old_nodes[i]);
 				}
 			}
 
@@ -210,7 +193,7 @@ void ConsecutivePairLongestPath::merge_layer(int layer, vector<Node*> &nodes_lay
 						// if node exists in new list, we need to update longest path
 						found = true;
 						nodes_layer[i]->longest_path = MAX(nodes_layer[i]->longest_path, nodeA->longest_path);
-						delete nodeA;
+						release_node(nodeA, nodes_layer[i]);
 					}
 				}
 
@@ -236,6 +219,8 @@ void ConsecutivePairLongestPath::merge_layer(int layer, vector<Node*> &nodes_lay
  */
 void LexicographicMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
+	gap = 0;
+
 	// populate current states with given nodes
 	current_states.clear();
 	for( vector<Node*>::iterator node = nodes_layer.begin(); node != nodes_layer.end(); node++ ) {
@@ -258,8 +243,9 @@ void LexicographicMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 		// merge nodes and delete last one
 		previous_to_last->longest_path = MAX(previous_to_last->longest_path, last->longest_path);
+		add_gap(previous_to_last->state, last->state);
 		previous_to_last->state.union_with(last->state);
-		delete last;
+		release_node(last, previous_to_last);
 
 		// now, we must check if the state of the new node appears in any previous node
 		NodeMap::iterator map_it = current_states.find(&(previous_to_last->state));
@@ -269,7 +255,7 @@ void LexicographicMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 			// remove last node from BDD (without consistency check)
 			map_it->second->longest_path = MAX(map_it->second->longest_path, previous_to_last->longest_path);
-			delete previous_to_last;
+			release_node(previous_to_last, map_it->second);
 
 		} else {
 			// otherwise, we add the node to the set of current states
@@ -292,6 +278,8 @@ void LexicographicMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
  */
 void MinSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
+	gap = 0;
+
 	// populate current states with given nodes
 	node_list.clear();
 	for( vector<Node*>::iterator node = nodes_layer.begin(); node != nodes_layer.end(); node++ ) {
@@ -317,8 +305,9 @@ void MinSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 		// merge nodes and delete last one
 		previous_to_last->longest_path = MAX(previous_to_last->longest_path, last->longest_path);
+		add_gap(previous_to_last->state, last->state);
 		previous_to_last->state.union_with(last->state);
-		delete last;
+		release_node(last, previous_to_last);
 
 		// now, we must check if the state of the new node appears in any previous node.
 		found = false;
@@ -336,7 +325,7 @@ void MinSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 			// remove last node from BDD (without consistency check)
 			(*node_it)->longest_path = MAX((*node_it)->longest_path, previous_to_last->longest_path);
-			delete previous_to_last;
+			release_node(previous_to_last, *node_it);
 
 		} else {
 			// otherwise, we add the node to the set of current states
@@ -359,6 +348,8 @@ void MinSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
  */
 void MaxSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
+	gap = 0;
+
 	// populate current states with given nodes
 	node_list.clear();
 	for( vector<Node*>::iterator node = nodes_layer.begin(); node != nodes_layer.end(); node++ ) {
@@ -384,8 +375,9 @@ void MaxSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 		// merge nodes and delete last one
 		previous_to_last->longest_path = MAX(previous_to_last->longest_path, last->longest_path);
+		add_gap(previous_to_last->state, last->state);
 		previous_to_last->state.union_with(last->state);
-		delete last;
+		release_node(last, previous_to_last);
 
 		// now, we must check if the state of the new node appears in any previous node.
 		found = false;
@@ -403,7 +395,7 @@ void MaxSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 			// remove last node from BDD (without consistency check)
 			(*node_it)->longest_path = MAX((*node_it)->longest_path, previous_to_last->longest_path);
-			delete previous_to_last;
+			release_node(previous_to_last, *node_it);
 
 		} else {
 			// otherwise, we add the node to the set of current states
@@ -423,103 +415,309 @@ void MaxSizeMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
 /**
  * Symmetric difference
- * (it is not implemented efficiently!!)
  */
 void SymmetricDifferenceMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 
+	// positions of the nodes follow the lexicographic order of their states
+	layer_nodes.assign(nodes_layer.begin(), nodes_layer.end());
+	sort(layer_nodes.begin(), layer_nodes.end(), CompareNodesStateLex());
+	layer_versions.assign(layer_nodes.size(), 0);
+	n_alive = layer_nodes.size();
+	gap = 0;
+
 	// populate current states with given nodes
 	current_states.clear();
-	for( vector<Node*>::iterator node = nodes_layer.begin(); node != nodes_layer.end(); node++ ) {
-		current_states[&((*node)->state)] = *node;
+	for( vector<Node*>::iterator node = layer_nodes.begin(); node != layer_nodes.end(); node++ ) {
+		current_states.insert(*node);
 	}
 
-	ComparatorNodePairSymmLP pairs_comp(symm_diff_vals, longest_path_val);
-	Node* last, *previous_to_last;
-
 	// merge nodes until max width is satisfied
-	while( (int)current_states.size() > width ) {
+	if( mode == SymmDiffAllPairs ) {
+		merge_all_pairs();
+	} else if( mode == SymmDiffIncremental ) {
+		merge_incremental();
+	} else {
+		merge_sketch();
+	}
+
+	// replace nodes of vector by the remaining nodes, in lexicographic order
+	nodes_layer.clear();
+	for( vector<Node*>::iterator node = layer_nodes.begin(); node != layer_nodes.end(); node++ ) {
+		if( *node != NULL ) {
+			nodes_layer.push_back(*node);
+		}
+	}
+	sort(nodes_layer.begin(), nodes_layer.end(), CompareNodesStateLex());
+}
+
+
+/**
+ * Merge the best pair, computing and sorting all pairs before each merge
+ * (it is not implemented efficiently!!). Pairs are listed in the lexicographic
+ * order of the current states, and the first node of the best pair is merged into
+ * the second one, as the original merger did.
+ */
+void SymmetricDifferenceMerger::merge_all_pairs() {
+
+	ComparePairEntrySymmLP pairs_comp;
+	vector<Node*> &nodes = layer_nodes;
+
+	while( n_alive > width ) {
+
+		lex_positions.clear();
+		for( int a = 0; a < (int)layer_nodes.size(); a++ ) {
+			if( layer_nodes[a] != NULL ) {
+				lex_positions.push_back(a);
+			}
+		}
+		sort(lex_positions.begin(), lex_positions.end(), [&nodes](int a, int b) {
+			return nodes[a]->state.lex_less(nodes[b]->state);
+		});
 
 		// compute symmetric difference between all pairs
-		node_pairs.clear();
-		symm_diff_vals.clear();
-		longest_path_val.clear();
+		pairs.clear();
+		for( int i = 0; i < (int)lex_positions.size(); i++ ) {
+			for( int j = i+1; j < (int)lex_positions.size(); j++ ) {
+				pairs.push_back(evaluate_pair(lex_positions[i], lex_positions[j]));
+			}
+		}
 
-		for( NodeMap::iterator nodeA = current_states.begin(); nodeA != current_states.end(); nodeA++ ) {
-			NodeMap::iterator nodeB = nodeA;
-			nodeB++;
-			for( ; nodeB != current_states.end(); nodeB++ ) {
+		// sort list of pairs and take the last one
+		sort(pairs.begin(), pairs.end(), pairs_comp);
+		merge_pair(pairs.back().a, pairs.back().b);
+	}
+}
 
-				// compute symmetric difference val
-				aux.set = nodeA->second->state.set ^ nodeB->second->state.set;
-				symm_diff_vals.push_back(aux.set.count());
 
-//				cout << "test: ";
-//				cout << nodeA->second->state.set;
-//				cout << " " << nodeB->second->state.set;
-//				cout << " --> " << aux.set << " - size: " << aux.set.count() << endl;
+/**
+ * Merge the best pair, keeping all pairs in a priority queue
+ */
+void SymmetricDifferenceMerger::merge_incremental() {
 
-				// compute resulting longest path
-				longest_path_val.push_back(MAX(nodeA->second->longest_path, nodeB->second->longest_path));
+	ComparePairEntry pairs_comp;
+	int n_nodes = layer_nodes.size();
 
-				// add to list of pairs
-				node_pairs.push_back(pair<Node*,Node*>(nodeA->second, nodeB->second));
+	pairs.clear();
+	for( int a = 0; a < n_nodes; a++ ) {
+		for( int b = a+1; b < n_nodes; b++ ) {
+			pairs.push_back(evaluate_pair(a, b));
+		}
+	}
+	make_heap(pairs.begin(), pairs.end(), pairs_comp);
+
+	while( n_alive > width ) {
+
+		assert( !pairs.empty() );
+		PairEntry best = pairs.front();
+		pop_heap(pairs.begin(), pairs.end(), pairs_comp);
+		pairs.pop_back();
+
+		// skip pairs with a node that was merged away or changed since
+		if( layer_nodes[best.a] == NULL || layer_nodes[best.b] == NULL
+				|| best.version_a != layer_versions[best.a] || best.version_b != layer_versions[best.b] ) {
+			continue;
+		}
+
+		int changed = merge_pair(best.a, best.b);
+		if( changed != -1 ) {
+			push_pairs_of(changed);
+		}
+
+		// drop skipped entries once they are the majority of the queue
+		long n_valid = (long)n_alive * (n_alive-1) / 2;
+		if( (long)pairs.size() > 2*n_valid + 1024 ) {
+			int n_kept = 0;
+			for( int i = 0; i < (int)pairs.size(); i++ ) {
+				PairEntry &entry = pairs[i];
+				if( layer_nodes[entry.a] != NULL && layer_nodes[entry.b] != NULL
+						&& entry.version_a == layer_versions[entry.a] && entry.version_b == layer_versions[entry.b] ) {
+					pairs[n_kept++] = entry;
+				}
 			}
+			pairs.resize(n_kept);
+			make_heap(pairs.begin(), pairs.end(), pairs_comp);
+		}
+	}
+}
+
+
+/**
+ * Merge the best pair among nodes at opposite ends of the projections
+ */
+void SymmetricDifferenceMerger::merge_sketch() {
+
+	ComparePairEntry pairs_comp;
+	int n_nodes = layer_nodes.size();
+	int n_words = layer_nodes[0]->state.n_words;
+
+	// random vertex weights, always the same so that merges are reproducible
+	if( (int)projection_masks.size() != n_projections * n_words ) {
+		projection_masks.resize(n_projections * n_words);
+		for( int i = 0; i < (int)projection_masks.size(); i++ ) {
+			projection_masks[i] = mix_hash_word(0x9e3779b97f4a7c15ULL * (uint64_t)(i+1));
 		}
+	}
 
-		assert( node_pairs.size() == symm_diff_vals.size() );
-		assert( node_pairs.size() == longest_path_val.size() );
+	projection_vals.resize(n_nodes * n_projections);
+	projection_order.resize(n_projections);
+	for( int p = 0; p < n_projections; p++ ) {
+		projection_order[p].clear();
+	}
+	for( int a = 0; a < n_nodes; a++ ) {
+		set_projections(a);
+	}
 
-		// sort list of pairs
-		indices.clear();
-		for( int i = 0; i < (int)node_pairs.size(); i++ )
-			indices.push_back(i);
+	while( n_alive > width ) {
 
-		sort(indices.begin(), indices.end(), pairs_comp);
+		// candidate pairs: nodes with largest and smallest values of each projection
+		bool found = false;
+		PairEntry best = PairEntry();
+		for( int p = 0; p < n_projections; p++ ) {
 
-//		cout << endl;
-//		for( int i = 0; i < (int)indices.size(); i++ ) {
-//			int k = indices[i];
-//			cout << node_pairs[k].first->state << " " << node_pairs[k].second->state << " --> " << symm_diff_vals[k] << endl;
-//		}
-//		cout << endl << endl;
+			top_nodes.clear();
+			bottom_nodes.clear();
+			set< pair<int,int> >::reverse_iterator top = projection_order[p].rbegin();
+			set< pair<int,int> >::iterator bottom = projection_order[p].begin();
+			for( int i = 0; i < n_extremes && top != projection_order[p].rend(); i++, ++top, ++bottom ) {
+				top_nodes.push_back(top->second);
+				bottom_nodes.push_back(bottom->second);
+			}
 
-		// take last pair from list
-		last = node_pairs[indices.back()].first;
-		previous_to_last = node_pairs[indices.back()].second;
+			for( vector<int>::iterator t = top_nodes.begin(); t != top_nodes.end(); ++t ) {
+				for( vector<int>::iterator u = bottom_nodes.begin(); u != bottom_nodes.end(); ++u ) {
+					if( *t == *u )
+						continue;
+					PairEntry candidate = evaluate_pair(MIN(*t, *u), MAX(*t, *u));
+					if( !found || pairs_comp(best, candidate) ) {
+						best = candidate;
+						found = true;
+					}
+				}
+			}
+		}
+		if( !found ) {
+			cout << "ERROR - no pair of nodes to merge in symmetric difference sketch" << endl;
+			exit(1);
+		}
 
-		assert( last != NULL );
-		assert( previous_to_last != NULL );
+		unset_projections(best.a);
+		unset_projections(best.b);
+		merge_pair(best.a, best.b);
+		if( layer_nodes[best.b] != NULL ) {
+			set_projections(best.b);
+		}
+	}
+}
 
-		// delete last two nodes from list (use iterators!)
-		current_states.erase(&(last->state));
-		current_states.erase(&(previous_to_last->state));
 
-		// merge nodes and delete last one
-		previous_to_last->longest_path = MAX(previous_to_last->longest_path, last->longest_path);
-		previous_to_last->state.union_with(last->state);
-		delete last;
+/**
+ * Symmetric difference and merged longest path of two nodes
+ */
+SymmetricDifferenceMerger::PairEntry SymmetricDifferenceMerger::evaluate_pair(int a, int b) {
+	PairEntry entry;
+	entry.symm_diff = layer_nodes[a]->state.get_symmetric_difference_size(layer_nodes[b]->state);
+	entry.longest_path = MAX(layer_nodes[a]->longest_path, layer_nodes[b]->longest_path);
+	entry.a = a;
+	entry.b = b;
+	entry.version_a = layer_versions[a];
+	entry.version_b = layer_versions[b];
+	return entry;
+}
 
-		// now, we must check if the state of the new node appears in any previous node
-		NodeMap::iterator map_it = current_states.find(&(previous_to_last->state));
-		if( map_it != current_states.end() ) {
 
-			// we just have to delete this last node, updating longest path of existing one
+/**
+ * Merge node a into node b. Returns the position of the node whose state or
+ * longest path changed (-1 if none).
+ */
+int SymmetricDifferenceMerger::merge_pair(int a, int b) {
+
+	Node* last = layer_nodes[a];
+	Node* previous_to_last = layer_nodes[b];
+
+	assert( last != NULL );
+	assert( previous_to_last != NULL );
+
+	// delete both nodes from list
+	current_states.erase(last);
+	current_states.erase(previous_to_last);
+
+	// merge nodes and delete first one
+	previous_to_last->longest_path = MAX(previous_to_last->longest_path, last->longest_path);
+	add_gap(previous_to_last->state, last->state);
+	previous_to_last->state.union_with(last->state);
+	release_node(last, previous_to_last);
+	layer_nodes[a] = NULL;
+	layer_versions[b]++;
+	n_alive--;
+
+	// now, we must check if the state of the new node appears in any previous node
+	Node* existing = current_states.find(previous_to_last->state);
+	if( existing != NULL ) {
+
+		// we just have to delete this node, updating longest path of existing one
+		int longest_path = existing->longest_path;
+		existing->longest_path = MAX(existing->longest_path, previous_to_last->longest_path);
+		release_node(previous_to_last, existing);
+		layer_nodes[b] = NULL;
+		n_alive--;
+
+		if( existing->longest_path == longest_path ) {
+			return -1;
+		}
+		int e = find(layer_nodes.begin(), layer_nodes.end(), existing) - layer_nodes.begin();
+		layer_versions[e]++;
+		return e;
+	}
 
-			// remove last node from BDD (without consistency check)
-			map_it->second->longest_path = MAX(map_it->second->longest_path, previous_to_last->longest_path);
-			delete previous_to_last;
+	// otherwise, we add the node to the set of current states
+	current_states.insert(previous_to_last);
+	return b;
+}
 
-		} else {
-			// otherwise, we add the node to the set of current states
-			current_states[&(previous_to_last->state)] = previous_to_last;
+
+/**
+ * Add pairs of a node with all other nodes to the priority queue
+ */
+void SymmetricDifferenceMerger::push_pairs_of(int a) {
+	ComparePairEntry pairs_comp;
+	for( int x = 0; x < (int)layer_nodes.size(); x++ ) {
+		if( x != a && layer_nodes[x] != NULL ) {
+			pairs.push_back(evaluate_pair(MIN(a, x), MAX(a, x)));
+			push_heap(pairs.begin(), pairs.end(), pairs_comp);
 		}
 	}
+}
 
 
-	// replace nodes of vector from nodes in the map
-	nodes_layer.clear();
-	for( NodeMap::iterator node = current_states.begin(); node != current_states.end(); node++ ) {
-		nodes_layer.push_back(node->second);
+/**
+ * Compute projections of a node. Projection 0 is the state size; the others
+ * give weight +1 to vertices in their mask and -1 to the remaining ones.
+ */
+void SymmetricDifferenceMerger::set_projections(int a) {
+	IntSet &state = layer_nodes[a]->state;
+	int size = state.get_size();
+	for( int p = 0; p < n_projections; p++ ) {
+		int value = size;
+		if( p > 0 ) {
+			const uint64_t* mask = &projection_masks[p * state.n_words];
+			int positive = 0;
+			for( int i = state.first_word; i < state.n_words; i++ ) {
+				positive += popcount_word(state.words[i] & mask[i]);
+			}
+			value = 2*positive - size;
+		}
+		projection_vals[a * n_projections + p] = value;
+		projection_order[p].insert(pair<int,int>(value, a));
+	}
+}
+
+
+/**
+ * Remove a node from the projection orders
+ */
+void SymmetricDifferenceMerger::unset_projections(int a) {
+	for( int p = 0; p < n_projections; p++ ) {
+		projection_order[p].erase(pair<int,int>(projection_vals[a * n_projections + p], a));
 	}
 }
 
@@ -532,11 +730,14 @@ void RandomMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 	// shuffle random
 	random_shuffle(nodes_layer.begin(), nodes_layer.end());
 
+	gap = 0;
+
 	IntSet* state = &(nodes_layer[width-1]->state);
 	for( vector<Node*>::iterator node = nodes_layer.begin()+width; node != nodes_layer.end(); ++node) {
+		add_gap(*state, (*node)->state);
 		state->union_with((*node)->state);
 		nodes_layer[width-1]->longest_path = MAX(nodes_layer[width-1]->longest_path, (*node)->longest_path);
-		delete (*node);
+		release_node(*node, nodes_layer[width-1]);
 	}
 	nodes_layer.resize(width);
 
@@ -554,7 +755,7 @@ void RandomMerger::merge_layer(int layer, vector<Node*> &nodes_layer) {
 			node->longest_path = MAX(node->longest_path, nodes_layer.back()->longest_path);
 
 			// delete the last node
-			delete nodes_layer.back();
+			release_node(nodes_layer.back(), node);
 
 			// remove it from queue
 			nodes_layer.pop_back();
@@ -10,6 +10,8 @@
 
 #include <algorithm>
 #include <fstream>
+#include <functional>
+#include <queue>
 
 #include "orderings.hpp"
 
@@ -45,113 +47,113 @@ void FixedOrdering::read_ordering(char* filename) {
 
 
 
-// minimum degree ordering
+// minimum degree ordering: vertices of minimum positive degree first (smallest index on
+// ties), then the vertices left with degree 0 in index order. Vertices are kept in a bucket
+// queue with one min-heap per degree, in O((n + m) log n)
 void MinDegreeOrdering::construct_ordering() {
 
-  v_in_layer.clear();
-
-  // compute vertex degree
-  vector<int> degree( inst->graph->n_vertices, 0 );
-  for ( int i = 0; i < inst->graph->n_vertices; ++i ) {
-    for ( int j = i+1; j < inst->graph->n_vertices; ++j ) {
-      if ( inst->graph->adj_m[i][j] ) {
-	++(degree[i]);
-	++(degree[j]);
-      }
-    }
-  }
-
-  vector<bool> selected( inst->graph->n_vertices, false);
-
-  while ( (int)v_in_layer.size() < inst->graph->n_vertices ) {
-  
-    int min = INF;
-    int v = -1;
-
-    for ( int i = 0; i < inst->graph->n_vertices; ++i ) {
-      if ( degree[i] > 0 && degree[i] < min && !selected[i] ) {
-	min = degree[i];
-	v = i;
-      }
-    }
-
-    if ( v == -1 ) {
-      for( int i = 0; i < inst->graph->n_vertices; ++i ) {
-	if ( !selected[i] ) {
-	  //cout << "\n selected vertex " << i << " --> degree: " << degree[i] << endl;
-	  v_in_layer.push_back( i );
+	Graph_BDD* graph = inst->graph;
+	int n = graph->n_vertices;
+	v_in_layer.clear();
+
+	// compute vertex degree
+	vector<int> degree(n);
+	vector< priority_queue<int, vector<int>, greater<int> > > bucket(n);
+	int min_degree = n;
+	for( int v = 0; v < n; v++ ) {
+		degree[v] = graph->n_neighbors(v) - 1;
+		if( degree[v] > 0 ) {
+			bucket[degree[v]].push(v);
+			min_degree = MIN(min_degree, degree[v]);
+		}
+	}
+
+	vector<bool> selected(n, false);
+	while( true ) {
+
+		// smallest vertex in the lowest bucket (entries of vertices whose degree changed are stale)
+		int v = -1;
+		while( v == -1 && min_degree < n ) {
+			priority_queue<int, vector<int>, greater<int> > &b = bucket[min_degree];
+			while( !b.empty() && (selected[b.top()] || degree[b.top()] != min_degree) ) {
+				b.pop();
+			}
+			if( b.empty() ) {
+				min_degree++;
+			} else {
+				v = b.top();
+				b.pop();
+			}
+		}
+		if( v == -1 ) {
+			break;
+		}
+
+		selected[v] = true;
+		v_in_layer.push_back(v);
+		for( const int* w = graph->neighbors_begin(v); w != graph->neighbors_end(v); ++w ) {
+			if( *w != v && !selected[*w] && --degree[*w] > 0 ) {
+				bucket[degree[*w]].push(*w);
+				min_degree = MIN(min_degree, degree[*w]);
+			}
+		}
 	}
-      }
-    } else {
-      selected[v] = true;
-      v_in_layer.push_back(v);
-      //cout << "\n selected vertex " << v << " --> degree: " << degree[v] << endl;
-      for ( int i = 0; i < inst->graph->n_vertices; ++i ) {
-	if ( i != v && inst->graph->adj_m[i][v] ) {
-	  --(degree[i]);
+
+	for( int v = 0; v < n; v++ ) {
+		if( !selected[v] ) {
+			v_in_layer.push_back(v);
+		}
 	}
-      }
-    }
-  }
 }
 
 
-// maximal path decomposition
+// maximal path decomposition: each path starts at the first unvisited vertex and is extended
+// at both ends with the smallest unvisited neighbor. Rows are scanned from where the last
+// search stopped (visited vertices stay visited), in O(n + m)
 void MaximalPathDecomp::construct_ordering() {
 
+	Graph_BDD* graph = inst->graph;
 	int n_maximal_paths = 0;
 
-	v_in_layer.resize(inst->graph->n_vertices);
-	vector<bool> visited(inst->graph->n_vertices, false);
+	v_in_layer.resize(graph->n_vertices);
+	vector<bool> visited(graph->n_vertices, false);
+	vector<int> next_arc(graph->adj_start.begin(), graph->adj_start.end()-1);
 
 	int n = 0;  // number of vertices already considered in the path
+	int first = 0;
 
 	// partial orderings
 	vector<int> left;
 	vector<int> right;
 
-	while( n < inst->graph->n_vertices ) {
+	while( n < graph->n_vertices ) {
 		left.clear();
 		right.clear();
 
-		int middle = -1;
 		// take first unvisited vertex
-		for( int v = 0; v < inst->graph->n_vertices; v++ ) {
-			if( !visited[v] ) {
-				middle = v;
-				break;
-			}
+		while( visited[first] ) {
+			first++;
 		}
+		int middle = first;
 		visited[middle] = true;
 
-		// right composition
-		int current = middle;
-		while( current != -1 ) {
-			int next = -1;
-			for( int v = 0; v < inst->graph->n_vertices; v++ ) {
-				if( !visited[v] && inst->graph->is_adj(current, v) ) {
-					next = v;
-					right.push_back(next);
-					visited[next] = true;
-					break;
+		// right composition, then left composition
+		for( int side = 0; side < 2; side++ ) {
+			vector<int> &path = ( side == 0 ) ? right : left;
+			int current = middle;
+			while( current != -1 ) {
+				int next = -1;
+				int end = graph->adj_start[current+1];
+				while( next_arc[current] < end && visited[graph->adj_vertices[next_arc[current]]] ) {
+					next_arc[current]++;
 				}
-			}
-			current = next;
-		}
-
-		// left composition
-		current = middle;
-		while( current != -1 ) {
-			int next = -1;
-			for( int v = 0; v < inst->graph->n_vertices; v++ ) {
-				if( !visited[v] && inst->graph->is_adj(current, v) ) {
-					next = v;
-					left.push_back(next);
+				if( next_arc[current] < end ) {
+					next = graph->adj_vertices[next_arc[current]];
+					path.push_back(next);
 					visited[next] = true;
-					break;
 				}
+				current = next;
 			}
-			current = next;
 		}
 
 		// compose path from left to right
@@ -169,8 +171,8 @@ void MaximalPathDecomp::construct_ordering() {
 
 	// quick check...
 	if( n_maximal_paths == 1 ) {
-		for( int v = 0; v < inst->graph->n_vertices-1; v++ ) {
-			if( !inst->graph->is_adj(v_in_layer[v], v_in_layer[v+1]) ) {
+		for( int v = 0; v < graph->n_vertices-1; v++ ) {
+			if( !graph->is_adj(v_in_layer[v], v_in_layer[v+1]) ) {
 				cout << "ERROR IN MAXIMAL PATH DECOMPOSITION\n";
 				exit(1);
 			}
@@ -189,220 +191,225 @@ void RandomOrdering::construct_ordering() {
 }
 
 
-void CutVertexDecomposition::identify_components(vector< vector<int> > &comps, vector<bool> &is_in_graph) {
-
-	vector<int> label(inst->graph->n_vertices, -1);
-	int num_comps = -1;
-
-	vector<int> stack;
+// Separator ordering of a graph given by adjacency rows (a vertex may be in its own row):
+// the first vertex whose removal leaves components of at most half the vertices goes last,
+// after the orderings of these components in the order of their smallest vertex. If there is
+// no such vertex, the largest biconnected component goes last instead.
+//
+// Tarjan's depth first search gives the sizes of the components left by removing each vertex
+// and the biconnected components, so each level of the recursion is linear and the ordering
+// takes O((n + m) log n) when halving vertices exist (as in trees).
+struct SeparatorOrdering {
+
+	const vector<int> &start;     // row of v is adj[start[v] .. start[v+1]-1]
+	const vector<int> &adj;
+
+	vector<char> in_graph;        // vertices not ordered yet
+	vector<int>  disc;            // discovery time in the search
+	vector<int>  low;             // earliest discovery time reachable from the subtree
+	vector<int>  parent;
+	vector<int>  next_arc;
+	vector<int>  subtree;         // vertices in the subtree
+	vector<int>  split_sum;       // vertices in the subtrees that removing the vertex separates
+	vector<int>  split_max;       // largest of these subtrees
+	vector<int>  label;           // component
+
+	SeparatorOrdering(const vector<int> &_start, const vector<int> &_adj) : start(_start), adj(_adj) {
+		int n = start.size() - 1;
+		in_graph.resize(n, 1);
+		disc.resize(n);
+		low.resize(n);
+		parent.resize(n);
+		next_arc.resize(n);
+		subtree.resize(n);
+		split_sum.resize(n);
+		split_max.resize(n);
+		label.resize(n);
+	}
 
-	vector<bool> visited(inst->graph->n_vertices, false);
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
+	// append the ordering of the subgraph induced by the vertices (in increasing order)
+	void order(const vector<int> &vertices, vector<int> &ordering);
+};
 
-		if( is_in_graph[i] && !visited[i]) {
 
-			num_comps++;
-			stack.push_back(i);
+void SeparatorOrdering::order(const vector<int> &vertices, vector<int> &ordering) {
 
-			while( !stack.empty() ) {
+	int size = vertices.size();
+	for( int i = 0; i < size; i++ ) {
+		disc[vertices[i]] = -1;
+	}
 
-				int v = stack.back();
-				stack.pop_back();
+	// depth first search of each connected component
+	vector<int> comp_size;
+	vector<int> stack;
+	vector<int> visited;          // vertices not yet in a biconnected component
+	vector<int> largest_block;
+	int time = 0;
+	for( int i = 0; i < size; i++ ) {
+		int root = vertices[i];
+		if( disc[root] != -1 ) {
+			continue;
+		}
 
-				label[v] = num_comps;
-				visited[v] = true;
+		int c = comp_size.size();
+		comp_size.push_back(0);
+		parent[root] = -1;
+		stack.push_back(root);
+		while( !stack.empty() ) {
+			int v = stack.back();
+			if( disc[v] == -1 ) {
+				disc[v] = low[v] = time++;
+				next_arc[v] = start[v];
+				subtree[v] = 1;
+				split_sum[v] = 0;
+				split_max[v] = 0;
+				label[v] = c;
+				visited.push_back(v);
+			}
+			if( next_arc[v] < start[v+1] ) {
+				int w = adj[next_arc[v]++];
+				if( w == v || w == parent[v] || !in_graph[w] ) {
+					continue;
+				}
+				if( disc[w] == -1 ) {
+					parent[w] = v;
+					stack.push_back(w);
+				} else {
+					low[v] = MIN(low[v], disc[w]);
+				}
+				continue;
+			}
 
-				for( int w = 0; w < inst->graph->n_vertices; w++ ) {
-					if( w == v ) continue;
-					if( is_in_graph[w] && inst->graph->is_adj(v,w) && !visited[w]) {
-						stack.push_back(w);
-					}
+			stack.pop_back();
+			comp_size[c]++;
+			int p = parent[v];
+			if( p == -1 ) {
+				visited.pop_back();
+				continue;
+			}
+			subtree[p] += subtree[v];
+			low[p] = MIN(low[p], low[v]);
+			if( low[v] >= disc[p] ) {
+				split_sum[p] += subtree[v];
+				split_max[p] = MAX(split_max[p], subtree[v]);
+
+				// p closes the biconnected component of the subtree of v
+				int block_begin = visited.size();
+				while( visited[block_begin-1] != v ) {
+					block_begin--;
 				}
+				block_begin--;
+				if( (int)visited.size() - block_begin + 1 > (int)largest_block.size() ) {
+					largest_block.assign(visited.begin() + block_begin, visited.end());
+					largest_block.push_back(p);
+				}
+				visited.resize(block_begin);
 			}
 		}
 	}
 
-	comps.clear();
-	comps.resize(num_comps+1);
-
-	for( int v = 0; v < inst->graph->n_vertices; v++ ) {
-		if( label[v] != -1 ) {
-			comps[label[v]].push_back(v);
+	// two largest components, for the vertices outside of them
+	int largest = -1;
+	int second_size = 0;
+	for( int c = 0; c < (int)comp_size.size(); c++ ) {
+		if( largest == -1 || comp_size[c] > comp_size[largest] ) {
+			second_size = ( largest == -1 ) ? 0 : comp_size[largest];
+			largest = c;
+		} else {
+			second_size = MAX(second_size, comp_size[c]);
 		}
 	}
-}
-
-vector<int> CutVertexDecomposition::find_ordering(vector<bool> is_in_graph) {
-
-	int size = 0;
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		size += (is_in_graph[i] ? 1 : 0 );
-	}
-
-	// find vertex with all components less than half the size of the graph
-	vector< vector<int> > comps;
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		if( is_in_graph[i] ) {
-
-			// try removing vertex
-			is_in_graph[i] = false;
-			identify_components(comps, is_in_graph);
-
-			//cout << "componentes when removing vertex " << i << endl;
-
-			bool all_valid = true;
-			for( int j = 0; j < (int)comps.size() && all_valid; j++ ) {
-				all_valid = ((int)comps[j].size() <= size/2);
-				//cout << "\t" << comps[j].size() << endl;
-			}
-
-			if( all_valid ) {
-
-				vector<int> ordering;
-
-				// compose ordering for each component separately
-				vector<bool> is_in_graph_new(inst->graph->n_vertices, false);
-				for( int c = 0; c < (int)comps.size(); c++ ) {
-
-					//cout << "*** Component " << c << endl;
-
-					for( int v = 0; v < (int)comps[c].size(); v++ ) {
-						is_in_graph_new[comps[c][v]] = true;
-					}
-
-					vector<int> order_bck = find_ordering(is_in_graph_new);
 
-					for( int v = 0; v < (int)comps[c].size(); v++ ) {
-						is_in_graph_new[comps[c][v]] = false;
-						ordering.push_back(order_bck[v]);
-					}
-				}
-				ordering.push_back(i);
-				return ordering;
-			}
-
-			// put vertex back again
-			is_in_graph[i] = true;
+	// first vertex leaving components of at most half the vertices
+	vector<int> separators;
+	for( int i = 0; i < size && separators.empty(); i++ ) {
+		int v = vertices[i];
+		int c = label[v];
+		int other = ( c == largest ) ? second_size : comp_size[largest];
+		int left = MAX(split_max[v], comp_size[c] - 1 - split_sum[v]);
+		left = MAX(left, other);
+		if( left <= size/2 ) {
+			separators.push_back(v);
 		}
 	}
-	return( vector<int>(1,-1) );
-}
-
-void CutVertexDecomposition::construct_ordering() {
-
-	vector<bool> is_in_graph(inst->graph->n_vertices, true);
-	vector<int> ordering = find_ordering(is_in_graph);
-
-	for( int i = 0; i < (int)ordering.size(); i++ ) {
-		v_in_layer[i] = ordering[i];
+	if( separators.empty() ) {
+		separators.swap(largest_block);
+		sort(separators.begin(), separators.end());
+	}
+	for( int i = 0; i < (int)separators.size(); i++ ) {
+		in_graph[separators[i]] = 0;
 	}
 
-}
-
-
-void CutVertexDecompositionGeneralGraph::identify_components(vector< vector<int> > &comps, vector<bool> &is_in_graph) {
-
-	vector<int> label(inst->graph->n_vertices, -1);
-	int num_comps = -1;
-
-	vector<int> stack;
-
-	vector<bool> visited(inst->graph->n_vertices, false);
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-
-		if( is_in_graph[i] && !visited[i]) {
-
-			num_comps++;
-			stack.push_back(i);
-
-			while( !stack.empty() ) {
-
-				int v = stack.back();
-				stack.pop_back();
-
-				label[v] = num_comps;
-				visited[v] = true;
-
-				for( int w = 0; w < inst->graph->n_vertices; w++ ) {
-					if( w == v ) continue;
-					if( is_in_graph[w] && inst->graph->is_adj(v,w) && !visited[w]) {
-						stack.push_back(w);
-					}
+	// components left, in the order of their smallest vertex
+	for( int i = 0; i < size; i++ ) {
+		label[vertices[i]] = -1;
+	}
+	int n_comps = 0;
+	for( int i = 0; i < size; i++ ) {
+		int root = vertices[i];
+		if( !in_graph[root] || label[root] != -1 ) {
+			continue;
+		}
+		label[root] = n_comps;
+		stack.push_back(root);
+		while( !stack.empty() ) {
+			int v = stack.back();
+			stack.pop_back();
+			for( int k = start[v]; k < start[v+1]; k++ ) {
+				int w = adj[k];
+				if( in_graph[w] && label[w] == -1 ) {
+					label[w] = n_comps;
+					stack.push_back(w);
 				}
 			}
 		}
+		n_comps++;
 	}
 
-	comps.clear();
-	comps.resize(num_comps+1);
-
-	for( int v = 0; v < inst->graph->n_vertices; v++ ) {
-		if( label[v] != -1 ) {
-			comps[label[v]].push_back(v);
+	vector< vector<int> > comps(n_comps);
+	for( int i = 0; i < size; i++ ) {
+		if( in_graph[vertices[i]] ) {
+			comps[label[vertices[i]]].push_back(vertices[i]);
 		}
 	}
-}
-
-vector<int> CutVertexDecompositionGeneralGraph::find_ordering(vector<bool> is_in_graph) {
-
-	int size = 0;
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		size += (is_in_graph[i] ? 1 : 0 );
+	for( int c = 0; c < n_comps; c++ ) {
+		order(comps[c], ordering);
 	}
+	ordering.insert(ordering.end(), separators.begin(), separators.end());
+}
 
-	// find vertex with all components less than half the size of the graph
-	vector< vector<int> > comps;
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		if( is_in_graph[i] ) {
-
-			// try removing vertex
-			is_in_graph[i] = false;
-			identify_components(comps, is_in_graph);
-
-			//cout << "componentes when removing vertex " << i << endl;
 
-			bool all_valid = true;
-			for( int j = 0; j < (int)comps.size() && all_valid; j++ ) {
-				all_valid = ((int)comps[j].size() <= size/2);
-				//cout << "\t" << comps[j].size() << endl;
-			}
+void CutVertexDecomposition::construct_ordering() {
 
-			if( all_valid ) {
+	vector<int> vertices(inst->graph->n_vertices);
+	for( int v = 0; v < inst->graph->n_vertices; v++ ) {
+		vertices[v] = v;
+	}
 
-				vector<int> ordering;
+	vector<int> ordering;
+	SeparatorOrdering separators(inst->graph->adj_start, inst->graph->adj_vertices);
+	separators.order(vertices, ordering);
 
-				// compose ordering for each component separately
-				vector<bool> is_in_graph_new(inst->graph->n_vertices, false);
-				for( int c = 0; c < (int)comps.size(); c++ ) {
+	for( int i = 0; i < (int)ordering.size(); i++ ) {
+		v_in_layer[i] = ordering[i];
+	}
 
-					//cout << "*** Component " << c << endl;
+}
 
-					for( int v = 0; v < (int)comps[c].size(); v++ ) {
-						is_in_graph_new[comps[c][v]] = true;
-					}
 
-					vector<int> order_bck = find_ordering(is_in_graph_new);
+void CutVertexDecompositionGeneralGraph::construct_ordering() {
 
-					for( int v = 0; v < (int)comps[c].size(); v++ ) {
-						is_in_graph_new[comps[c][v]] = false;
-						ordering.push_back(order_bck[v]);
-					}
-				}
-				ordering.push_back(i);
-				return ordering;
-			}
+	vector<int> tree_start, tree_adj;
+	spanning_tree(tree_start, tree_adj);
 
-			// put vertex back again
-			is_in_graph[i] = true;
-		}
+	vector<int> vertices(inst->graph->n_vertices);
+	for( int v = 0; v < inst->graph->n_vertices; v++ ) {
+		vertices[v] = v;
 	}
-	return( vector<int>(1,-1) );
-}
-
-void CutVertexDecompositionGeneralGraph::construct_ordering() {
 
-	vector<bool> is_in_graph(inst->graph->n_vertices, true);
-	vector<int> ordering = find_ordering(is_in_graph);
+	vector<int> ordering;
+	SeparatorOrdering separators(tree_start, tree_adj);
+	separators.order(vertices, ordering);
 
 	for( int i = 0; i < (int)ordering.size(); i++ ) {
 		v_in_layer[i] = ordering[i];
@@ -411,93 +418,70 @@ void CutVertexDecompositionGeneralGraph::construct_ordering() {
 }
 
 
-void CutVertexDecompositionGeneralGraph::restrict_graph() {
+// Spanning tree grown from the vertex of largest degree: the first vertex in decreasing
+// degree order that is in the tree and has neighbors out of it takes all of them. Tree
+// vertices are kept in a heap by position in that order, in O(n + m log n). A graph with
+// several components gets a spanning forest.
+void CutVertexDecompositionGeneralGraph::spanning_tree(vector<int> &tree_start, vector<int> &tree_adj) {
 
-	vector< pair<int,int> > edges;
+	Graph_BDD* graph = inst->graph;
+	int n = graph->n_vertices;
 
-	vector<int> vertices(inst->graph->n_vertices);
-	vector<int> degrees(inst->graph->n_vertices);
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
+	vector<int> vertices(n);
+	vector<int> degrees(n);
+	for( int i = 0; i < n; i++ ) {
 		vertices[i] = i;
-		degrees[i] = inst->graph->adj_list[i].size()-1;
+		degrees[i] = graph->n_neighbors(i)-1;
 	}
 	IntComparator int_comp(degrees);
 	sort(vertices.begin(), vertices.end(),int_comp);
 
-	vector<bool> is_taken(inst->graph->n_vertices, false);
-	vector<int> taken;
-
-	cout << "vertices ordered by degree: " << endl;
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		cout << vertices[i] << " ";
+	vector<int> position(n);
+	for( int i = 0; i < n; i++ ) {
+		position[vertices[i]] = i;
 	}
-	cout << endl;
-
-	is_taken[vertices[0]] = true;
-	int n_taken = 1;
 
-	while( n_taken != inst->graph->n_vertices ) {
-		for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-
-			if( !is_taken[vertices[i]] )
-				continue;
-
-			int w = vertices[i];
-
-			bool new_edge = false;
-
-			for( int v = 0; v < inst->graph->n_vertices; v++ ) {
-				if( v != w && inst->graph->is_adj(v, w) && !is_taken[v] ) {
-
-					pair<int,int> t;
-					t.first = v;
-					t.second = w;
-					edges.push_back(t);
-
-					is_taken[v] = true;
-					n_taken++;
-
-					new_edge = true;
-					cout << "took " << v << " due to " << w << endl;
-				}
+	vector< pair<int,int> > edges;
+	vector<bool> is_taken(n, false);
+	priority_queue<int, vector<int>, greater<int> > taken;
+	int n_taken = 0;
+	int next_root = 0;
+
+	while( n_taken != n ) {
+		if( taken.empty() ) {
+			while( is_taken[vertices[next_root]] ) {
+				next_root++;
 			}
+			is_taken[vertices[next_root]] = true;
+			taken.push(next_root);
+			n_taken++;
+		}
 
-			if( new_edge )
-				break;
+		int w = vertices[taken.top()];
+		taken.pop();
+		for( const int* v = graph->neighbors_begin(w); v != graph->neighbors_end(w); ++v ) {
+			if( !is_taken[*v] ) {
+				edges.push_back(pair<int,int>(*v, w));
+				is_taken[*v] = true;
+				taken.push(position[*v]);
+				n_taken++;
+			}
 		}
 	}
 
-	cout << endl;
+	// tree adjacency rows
+	tree_start.assign(n+1, 0);
 	for( int i = 0; i < (int)edges.size(); i++ ) {
-		cout << edges[i].first << "," << edges[i].second << endl;
+		tree_start[edges[i].first+1]++;
+		tree_start[edges[i].second+1]++;
 	}
-	cout << endl;
-
-	bool** new_adj = new bool*[inst->graph->n_vertices];
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		new_adj[i] = new bool[inst->graph->n_vertices];
-	}
-
-	for( int i = 0; i < inst->graph->n_vertices; i++ ) {
-		for( int j = i+1; j < inst->graph->n_vertices; j++ ) {
-			new_adj[i][j] = false;
-			new_adj[j][i] = false;
-		}
+	for( int v = 0; v < n; v++ ) {
+		tree_start[v+1] += tree_start[v];
 	}
-
+	tree_adj.resize(2*edges.size());
+	vector<int> fill(tree_start.begin(), tree_start.end()-1);
 	for( int i = 0; i < (int)edges.size(); i++ ) {
-		new_adj[edges[i].first][edges[i].second] = true;
-		new_adj[edges[i].second][edges[i].first] = true;
+		tree_adj[fill[edges[i].first]++] = edges[i].second;
+		tree_adj[fill[edges[i].second]++] = edges[i].first;
 	}
-
-	original_adj_matrix = inst->graph->adj_m;
-	inst->graph->adj_m = new_adj;
-}
-
-
-void CutVertexDecompositionGeneralGraph::regenerate_graph() {
-	inst->graph->adj_m = original_adj_matrix;
 }
-
-
-
@@ -0,0 +1,234 @@
+/*
+ * --------------------------------------------------------
+ * Bitwise kernels over arrays of 64-bit words - implementation
+ *
+ * Vector kernels are compiled with function-level target
+ * attributes, so the rest of the code does not need to be
+ * built with -mavx2 / -mavx512f.
+ * --------------------------------------------------------
+ */
+
+#include <cstring>
+#include "wordops.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define WORDOPS_X86
+#include <immintrin.h>
+#endif
+
+
+/*
+ * Scalar kernels
+ */
+
+static void and_scalar(uint64_t* a, const uint64_t* b, int n_words) { and_words_scalar(a, b, n_words); }
+static void or_scalar(uint64_t* a, const uint64_t* b, int n_words) { or_words_scalar(a, b, n_words); }
+static void andnot_scalar(uint64_t* a, const uint64_t* b, int n_words) { andnot_words_scalar(a, b, n_words); }
+static int count_scalar(const uint64_t* a, int n_words) { return count_words_scalar(a, n_words); }
+static int xor_count_scalar(const uint64_t* a, const uint64_t* b, int n_words) { return xor_count_words_scalar(a, b, n_words); }
+static bool equal_scalar(const uint64_t* a, const uint64_t* b, int n_words) { return equal_words_scalar(a, b, n_words); }
+static bool subset_scalar(const uint64_t* a, const uint64_t* b, int n_words) { return subset_words_scalar(a, b, n_words); }
+
+static const WordOps word_ops_scalar = {
+	"scalar", and_scalar, or_scalar, andnot_scalar, count_scalar, xor_count_scalar, equal_scalar, subset_scalar
+};
+
+
+#ifdef WORDOPS_X86
+
+/*
+ * AVX2 kernels (4 words per vector)
+ */
+
+#define AVX2_TARGET __attribute__((target("avx2,popcnt")))
+
+AVX2_TARGET static void and_avx2(uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i += 4 ) {
+		__m256i va = _mm256_loadu_si256((const __m256i*)(a+i));
+		__m256i vb = _mm256_loadu_si256((const __m256i*)(b+i));
+		_mm256_storeu_si256((__m256i*)(a+i), _mm256_and_si256(va, vb));
+	}
+}
+
+AVX2_TARGET static void or_avx2(uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i += 4 ) {
+		__m256i va = _mm256_loadu_si256((const __m256i*)(a+i));
+		__m256i vb = _mm256_loadu_si256((const __m256i*)(b+i));
+		_mm256_storeu_si256((__m256i*)(a+i), _mm256_or_si256(va, vb));
+	}
+}
+
+AVX2_TARGET static void andnot_avx2(uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i += 4 ) {
+		__m256i va = _mm256_loadu_si256((const __m256i*)(a+i));
+		__m256i vb = _mm256_loadu_si256((const __m256i*)(b+i));
+		_mm256_storeu_si256((__m256i*)(a+i), _mm256_andnot_si256(vb, va));
+	}
+}
+
+AVX2_TARGET static int count_avx2(const uint64_t* a, int n_words) {
+	// hardware popcount, four independent accumulators
+	long long c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+	for( int i = 0; i < n_words; i += 4 ) {
+		c0 += _mm_popcnt_u64(a[i]);
+		c1 += _mm_popcnt_u64(a[i+1]);
+		c2 += _mm_popcnt_u64(a[i+2]);
+		c3 += _mm_popcnt_u64(a[i+3]);
+	}
+	return (int)(c0 + c1 + c2 + c3);
+}
+
+AVX2_TARGET static int xor_count_avx2(const uint64_t* a, const uint64_t* b, int n_words) {
+	uint64_t x[4];
+	long long count = 0;
+	for( int i = 0; i < n_words; i += 4 ) {
+		__m256i va = _mm256_loadu_si256((const __m256i*)(a+i));
+		__m256i vb = _mm256_loadu_si256((const __m256i*)(b+i));
+		_mm256_storeu_si256((__m256i*)x, _mm256_xor_si256(va, vb));
+		count += _mm_popcnt_u64(x[0]) + _mm_popcnt_u64(x[1]) + _mm_popcnt_u64(x[2]) + _mm_popcnt_u64(x[3]);
+	}
+	return (int)count;
+}
+
+AVX2_TARGET static bool equal_avx2(const uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i += 4 ) {
+		__m256i va = _mm256_loadu_si256((const __m256i*)(a+i));
+		__m256i vb = _mm256_loadu_si256((const __m256i*)(b+i));
+		__m256i diff = _mm256_xor_si256(va, vb);
+		if( !_mm256_testz_si256(diff, diff) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+AVX2_TARGET static bool subset_avx2(const uint64_t* a, const uint64_t* b, int n_words) {
+	for( int i = 0; i < n_words; i += 4 ) {
+		__m256i va = _mm256_loadu_si256((const __m256i*)(a+i));
+		__m256i vb = _mm256_loadu_si256((const __m256i*)(b+i));
+		// carry flag is set iff (~b & a) == 0
+		if( !_mm256_testc_si256(vb, va) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static const WordOps word_ops_avx2 = {
+	"avx2", and_avx2, or_avx2, andnot_avx2, count_avx2, xor_count_avx2, equal_avx2, subset_avx2
+};
+
+
+/*
+ * AVX-512 kernels (8 words per vector, 4-word tail with AVX2)
+ */
+
+#define AVX512_TARGET __attribute__((target("avx512f,avx2,popcnt")))
+
+AVX512_TARGET static void and_avx512(uint64_t* a, const uint64_t* b, int n_words) {
+	int i = 0;
+	for( ; i+8 <= n_words; i += 8 ) {
+		__m512i va = _mm512_loadu_si512((const void*)(a+i));
+		__m512i vb = _mm512_loadu_si512((const void*)(b+i));
+		_mm512_storeu_si512((void*)(a+i), _mm512_and_si512(va, vb));
+	}
+	if( i < n_words ) {
+		and_avx2(a+i, b+i, n_words-i);
+	}
+}
+
+AVX512_TARGET static void or_avx512(uint64_t* a, const uint64_t* b, int n_words) {
+	int i = 0;
+	for( ; i+8 <= n_words; i += 8 ) {
+		__m512i va = _mm512_loadu_si512((const void*)(a+i));
+		__m512i vb = _mm512_loadu_si512((const void*)(b+i));
+		_mm512_storeu_si512((void*)(a+i), _mm512_or_si512(va, vb));
+	}
+	if( i < n_words ) {
+		or_avx2(a+i, b+i, n_words-i);
+	}
+}
+
+AVX512_TARGET static void andnot_avx512(uint64_t* a, const uint64_t* b, int n_words) {
+	const __m512i ones = _mm512_set1_epi64(-1);
+	int i = 0;
+	for( ; i+8 <= n_words; i += 8 ) {
+		__m512i va = _mm512_loadu_si512((const void*)(a+i));
+		__m512i vb = _mm512_loadu_si512((const void*)(b+i));
+		_mm512_storeu_si512((void*)(a+i), _mm512_and_si512(va, _mm512_xor_si512(vb, ones)));
+	}
+	if( i < n_words ) {
+		andnot_avx2(a+i, b+i, n_words-i);
+	}
+}
+
+AVX512_TARGET static bool equal_avx512(const uint64_t* a, const uint64_t* b, int n_words) {
+	int i = 0;
+	for( ; i+8 <= n_words; i += 8 ) {
+		__m512i va = _mm512_loadu_si512((const void*)(a+i));
+		__m512i vb = _mm512_loadu_si512((const void*)(b+i));
+		if( _mm512_cmpneq_epi64_mask(va, vb) != 0 ) {
+			return false;
+		}
+	}
+	return ( i == n_words || equal_avx2(a+i, b+i, n_words-i) );
+}
+
+AVX512_TARGET static bool subset_avx512(const uint64_t* a, const uint64_t* b, int n_words) {
+	const __m512i ones = _mm512_set1_epi64(-1);
+	int i = 0;
+	for( ; i+8 <= n_words; i += 8 ) {
+		__m512i va = _mm512_loadu_si512((const void*)(a+i));
+		__m512i vb = _mm512_loadu_si512((const void*)(b+i));
+		// elements of a that are not in b
+		if( _mm512_test_epi64_mask(va, _mm512_xor_si512(vb, ones)) != 0 ) {
+			return false;
+		}
+	}
+	return ( i == n_words || subset_avx2(a+i, b+i, n_words-i) );
+}
+
+// without AVX512-VPOPCNTDQ, counting is done with scalar popcnt instructions
+static const WordOps word_ops_avx512 = {
+	"avx512", and_avx512, or_avx512, andnot_avx512, count_avx2, xor_count_avx2, equal_avx512, subset_avx512
+};
+
+#endif /* WORDOPS_X86 */
+
+
+/**
+ * Kernels of a given instruction set
+ */
+const WordOps* get_word_ops(const char* name) {
+	if( strcmp(name, "scalar") == 0 ) {
+		return &word_ops_scalar;
+	}
+#ifdef WORDOPS_X86
+	__builtin_cpu_init();
+	if( strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ) {
+		return &word_ops_avx2;
+	}
+	if( strcmp(name, "avx512") == 0 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2")
+			&& __builtin_cpu_supports("popcnt") ) {
+		return &word_ops_avx512;
+	}
+#endif
+	return NULL;
+}
+
+
+/**
+ * Pick the widest kernels supported by the processor
+ */
+static WordOps select_word_ops() {
+	const char* names[] = {"avx512", "avx2"};
+	for( int i = 0; i < 2; i++ ) {
+		const WordOps* ops = get_word_ops(names[i]);
+		if( ops != NULL ) {
+			return *ops;
+		}
+	}
+	return word_ops_scalar;
+}
+
+WordOps word_ops = select_word_ops();
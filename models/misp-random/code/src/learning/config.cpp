@@ -42,6 +42,8 @@ int cfg::edge_dim = 4;
 int cfg::edge_embed_dim = -1;
 int cfg::avg_global = 0;
 int cfg::bdd_max_width = 10000;
+int cfg::bdd_threads = 1;
+int cfg::bdd_kernelize = 0;
 Dtype cfg::r_scaling = 1.0;
 Dtype cfg::learning_rate = 0.0005;
 Dtype cfg::decay = 1.0;
@@ -37,17 +37,52 @@ SOFTWARE.
 
 
 int bdd_max_width = 10000; // -1 if exact
+int bdd_threads = 1;
+int bdd_kernelize = 0; // 1 to build the diagrams of the kernels of the graphs
 char reward_type = 'W';
 char bdd_type = 'U';
 double r_scaling = 1;
 
-LearningEnv::LearningEnv() : IEnv() {
+InstanceCache InstCache;
+
+std::shared_ptr<IndepSetInst> InstanceCache::Get(std::shared_ptr<Graph> g)
+{
+    auto it = entries.find(g.get());
+    if (it != entries.end() && it->second.graph.lock() == g)
+        return it->second.inst;
+
+    // a graph at the same address was released: its entry is stale like all expired ones
+    for (auto e = entries.begin(); e != entries.end(); ) {
+        if (e->second.graph.expired())
+            e = entries.erase(e);
+        else
+            ++e;
+    }
+
+    Entry& entry = entries[g.get()];
+    entry.graph = g;
+    entry.inst = std::make_shared<IndepSetInst>();
+    entry.inst->build_complete_instance(g->adj_list);
+    return entry.inst;
+}
+
+std::shared_ptr<Kernelization> InstanceCache::GetKernel(std::shared_ptr<Graph> g)
+{
+    std::shared_ptr<IndepSetInst> inst = Get(g);
+    Entry& entry = entries[g.get()];
+    if (!entry.kernel) {
+        entry.kernel = std::make_shared<Kernelization>();
+        entry.kernel->reduce(inst.get());
+    }
+    return entry.kernel;
+}
+
+LearningEnv::LearningEnv() : IEnv(), solver(nullptr) {
 
 }
 
 void LearningEnv::s0(std::shared_ptr<Graph> _g, bool isTrain) {
     graph = _g;
-    covered_set.clear();
     action_list.clear();
     state_seq.clear();
     act_seq.clear();
@@ -55,13 +90,37 @@ void LearningEnv::s0(std::shared_ptr<Graph> _g, bool isTrain) {
     sum_rewards.clear();
     width = 0;
     bound = 0;
+    lower_bound = 0;
+
+    avail_list.resize(graph->num_nodes);
+    avail_pos.resize(graph->num_nodes);
+    for (int i = 0; i < graph->num_nodes; ++i) {
+        avail_list[i] = i;
+        avail_pos[i] = i;
+    }
 
-    inst = new IndepSetInst;
-    inst->build_complete_instance(graph->adj_list);
+    // vertices reduced away have no layer: the kernel instance shares the lifetime of its reductions
+    if (bdd_kernelize) {
+        kernel = InstCache.GetKernel(graph);
+        inst = std::shared_ptr<IndepSetInst>(kernel, kernel->kernel);
+    } else {
+        kernel.reset();
+        inst = InstCache.Get(graph);
+    }
 
-    solver = new IndepSetSolver(inst, bdd_max_width);
-    solver->ordering = new OnlineOrdering(inst);
-    solver->merger =  new MinLongestPath(inst, bdd_max_width);
+    if (solver == nullptr) {
+        solver = new IndepSetSolver(inst.get(), bdd_max_width);
+        solver->n_threads = bdd_threads;
+        solver->ordering = new OnlineOrdering(inst.get());
+        solver->merger =  new MinLongestPath(inst.get(), bdd_max_width);
+        solver->merger->track_gap = (reward_type == 'M');
+    } else {
+        solver->reset(inst.get());
+        ((OnlineOrdering*) solver->ordering)->v_in_layer.resize(inst->graph->n_vertices);
+        solver->ordering->inst = inst.get();
+        solver->merger->inst = inst.get();
+        solver->merger->gap = 0;
+    }
 
     IntSet starting_state;
     starting_state.resize(0, inst->graph->n_vertices-1, true);
@@ -72,29 +131,46 @@ void LearningEnv::s0(std::shared_ptr<Graph> _g, bool isTrain) {
 double LearningEnv::step(int a) {
 
     assert(graph);
-    assert(covered_set.count(a) == 0);
+    assert(avail_pos[a] != -1);
 
     state_seq.push_back(action_list);
     act_seq.push_back(a);
 
-    covered_set.insert(a);
+    // remove a from avail_list by moving the last vertex to its position
+    int last = avail_list.back();
+    avail_list[avail_pos[a]] = last;
+    avail_pos[last] = avail_pos[a];
+    avail_list.pop_back();
+    avail_pos[a] = -1;
     action_list.push_back(a);
 
     double old_width = width;
     double old_bound = bound;
+    double old_lower_bound = lower_bound;
     double r_t = 0;
 
-    if(bdd_type == 'L')
-        solver->generate_next_step_restriction(a);
+    // vertex of the diagrams (-1 if the kernel has none for a)
+    int v = kernel ? kernel->kernel_vertex[a] : a;
+
+    if (v == -1)
+        solver->merger->gap = 0;
+    else if(bdd_type == 'L')
+        solver->generate_next_step_restriction(v);
     else if(bdd_type == 'U')
-        solver->generate_next_step_relaxation(a);
+        solver->generate_next_step_relaxation(v);
+    else if(bdd_type == 'B')
+        solver->generate_next_step_bounds(v); // width and bound of the relaxation
     else {
         std::cerr << "unknown bdd_type type"  <<  bdd_type << std::endl;
         exit(0);
     }
 
-    width = solver->final_width;
-    bound = solver->get_bound();
+    if (v != -1)
+        width = solver->final_width;
+    int offset = kernel ? kernel->offset : 0;  // weight of the vertices reduced away
+    bound = solver->get_bound() + offset;
+    if (bdd_type == 'B')
+        lower_bound = solver->get_restriction_bound() + offset;
 
     if (reward_type == 'W')
         r_t = getReward(old_width);
@@ -102,6 +178,8 @@ double LearningEnv::step(int a) {
         r_t = getRewardUpperBound(old_bound);
     else if (reward_type == 'B' && bdd_type == 'L')
         r_t = getRewardLowerBound(old_bound);
+    else if (reward_type == 'B' && bdd_type == 'B')
+        r_t = getRewardGap(old_bound, old_lower_bound);
     else if (reward_type == 'M')
         r_t = getRewardMerge();
     else {
@@ -118,14 +196,6 @@ double LearningEnv::step(int a) {
 int LearningEnv::randomAction()
 {
     assert(graph);
-    avail_list.clear();
-
-    for (int i = 0; i < graph->num_nodes; ++i) {
-        if (covered_set.count(i) == 0) {
-            avail_list.push_back(i);
-        }
-    }
-
     assert(avail_list.size());
     int idx = rand() % avail_list.size();
 
@@ -150,6 +220,10 @@ double LearningEnv::getRewardLowerBound(int old_bound) {
     return r_scaling * (bound - old_bound); // increase in width is penalized, decrease are rewarded
 }
 
+double LearningEnv::getRewardGap(int old_bound, int old_lower_bound) {
+    return -r_scaling * ((bound - lower_bound) - (old_bound - old_lower_bound)); // increase in gap is penalized, decrease are rewarded
+}
+
 double LearningEnv::getRewardMerge() {
     return -r_scaling * solver->merger->gap;
 }
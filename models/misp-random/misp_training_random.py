@@ -33,7 +33,7 @@ import matplotlib.pyplot as plt
 
 sys.path.append( '%s/code' % os.path.dirname(os.path.realpath(__file__)) )
 
-from learning_lib import LearningLib
+from learning_lib import LearningLib, DD_STATS_NAMES
 
 n_valid = 100
 
@@ -120,6 +120,7 @@ if __name__ == '__main__':
     lr = float(opt['learning_rate'])
 
     print('[INFO]','iter', 'time', 'lr', 'eps', 'avg-width','avg-bound','avg-reward')
+    print('[INFO]','avg-' + ' avg-'.join(DD_STATS_NAMES))
     sys.stdout.flush()
 
     best_reward = (0,0,0,0,0,0,MIN_VAL)
@@ -138,17 +139,22 @@ if __name__ == '__main__':
         if iter % 100 == 0:
             sys.stdout.flush()
             width, bound, reward = 0.0, 0.0, 0.0
+            stats = dict.fromkeys(DD_STATS_NAMES, 0)
             for idx in range(n_valid):
                 val, sol = api.GetResult(idx)
                 width += sol[0]
                 bound += sol[1]
                 reward += val
+                for layer_stats in api.GetDDStats(int(opt['max_n'])):
+                    for name in DD_STATS_NAMES:
+                        stats[name] += layer_stats[name]
 
             width, bound, reward = (width/n_valid, bound/n_valid, reward/n_valid)
             cur_time = round(time.time() - start_time,2)
             it_data = (iter, cur_time, lr, eps, width, bound, reward)
 
             print("[DATA]", " ".join(map(str,it_data)))
+            print("[STATS]", " ".join(str(stats[name] // n_valid) for name in DD_STATS_NAMES))
 
             if reward > best_reward[-1]:
                 best_reward = it_data
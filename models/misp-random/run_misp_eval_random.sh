@@ -25,6 +25,8 @@ test_max_n=100
 reward_type=bound
 bdd_type=relaxed
 bdd_max_width=2
+bdd_threads=1 # Threads used to branch large layers of the DD
+bdd_kernelize=0 # 1 to build the DDs of the graphs reduced by kernelization
 
 
 # Parameters used for the learning, must be the same as the training
@@ -79,4 +81,6 @@ python misp_evaluate_random.py \
         -r_scaling $r_scaling \
         -reward_type $reward_type \
         -bdd_type $bdd_type \
-        -bdd_max_width $bdd_max_width
+        -bdd_max_width $bdd_max_width \
+        -bdd_threads $bdd_threads \
+        -bdd_kernelize $bdd_kernelize
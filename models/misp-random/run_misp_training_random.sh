@@ -14,8 +14,10 @@ max_n=20 # maximum number of nodes
 
 # Characterics of the DDs built
 reward_type=bound # bound, width
-bdd_type=relaxed # exact, relaxed, restricted
+bdd_type=relaxed # exact, relaxed, restricted, both
 bdd_max_width=2 # Maximum width allowed for the DD
+bdd_threads=1 # Threads used to branch large layers of the DD
+bdd_kernelize=0 # 1 to build the DDs of the graphs reduced by kernelization
 
 # Parameters for the training, see the related papers for more information
 r_scaling=0.01 # Reward scaling factor
@@ -76,6 +78,8 @@ python misp_training_random.py \
     -reward_type $reward_type \
     -bdd_type $bdd_type \
     -bdd_max_width $bdd_max_width \
+    -bdd_threads $bdd_threads \
+    -bdd_kernelize $bdd_kernelize \
     -r_scaling $r_scaling \
     -plot_training $plot_training \
     2>&1 | tee $save_dir/log-training.txt